@@ -7,6 +7,7 @@
 #include "flavor/object-flavor.h"
 #include "game-option/cheat-types.h"
 #include "io/files-util.h"
+#include "object-enchant/tr-flags.h"
 #include "object-enchant/tr-types.h"
 #include "object-enchant/trc-types.h"
 #include "player-base/player-class.h"
@@ -14,6 +15,7 @@
 #include "system/player-type-definition.h"
 #include "util/bit-flags-calculator.h"
 #include "wizard/wizard-messages.h"
+#include <array>
 #include <sstream>
 #include <string_view>
 
@@ -161,9 +163,8 @@ std::string get_random_name(const ItemEntity &item, bool armour, int power)
 }
 
 /*対邪平均ダメージの計算処理*/
-static int calc_arm_avgdamage(PlayerType *player_ptr, ItemEntity *o_ptr)
+static int calc_arm_avgdamage(PlayerType *player_ptr, const ItemEntity *o_ptr, const TrFlags &flags)
 {
-    const auto flags = o_ptr->get_flags();
     int base, forced, vorpal;
     int s_evil = forced = vorpal = 0;
     int dam = base = (o_ptr->dd * o_ptr->ds + o_ptr->dd) / 2;
@@ -193,44 +194,21 @@ static int calc_arm_avgdamage(PlayerType *player_ptr, ItemEntity *o_ptr)
     return dam;
 }
 
+/*!
+ * @brief 対邪平均ダメージが強すぎるかを判定する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param o_ptr 判定対象のアーティファクト
+ * @return 上限を超えていればtrue
+ * @details 上限は吸血の有無と追加攻撃の修正値で決まる. 追加攻撃+1～+3の上限は常にそれ以外の上限より低いので、
+ * 平均ダメージは1回だけ計算してどちらか一方と比べればよい.
+ */
 bool has_extreme_damage_rate(PlayerType *player_ptr, ItemEntity *o_ptr)
 {
+    static constexpr std::array<int, 4> vampiric_limits = { { 63, 52, 43, 33 } };
+    static constexpr std::array<int, 4> normal_limits = { { 75, 65, 52, 40 } };
     const auto flags = o_ptr->get_flags();
-    if (flags.has(TR_VAMPIRIC)) {
-        if (flags.has(TR_BLOWS) && (o_ptr->pval == 1) && (calc_arm_avgdamage(player_ptr, o_ptr) > 52)) {
-            return true;
-        }
-
-        if (flags.has(TR_BLOWS) && (o_ptr->pval == 2) && (calc_arm_avgdamage(player_ptr, o_ptr) > 43)) {
-            return true;
-        }
-
-        if (flags.has(TR_BLOWS) && (o_ptr->pval == 3) && (calc_arm_avgdamage(player_ptr, o_ptr) > 33)) {
-            return true;
-        }
-
-        if (calc_arm_avgdamage(player_ptr, o_ptr) > 63) {
-            return true;
-        }
-
-        return false;
-    }
-
-    if (flags.has(TR_BLOWS) && (o_ptr->pval == 1) && (calc_arm_avgdamage(player_ptr, o_ptr) > 65)) {
-        return true;
-    }
-
-    if (flags.has(TR_BLOWS) && (o_ptr->pval == 2) && (calc_arm_avgdamage(player_ptr, o_ptr) > 52)) {
-        return true;
-    }
-
-    if (flags.has(TR_BLOWS) && (o_ptr->pval == 3) && (calc_arm_avgdamage(player_ptr, o_ptr) > 40)) {
-        return true;
-    }
-
-    if (calc_arm_avgdamage(player_ptr, o_ptr) > 75) {
-        return true;
-    }
-
-    return false;
+    const auto &limits = flags.has(TR_VAMPIRIC) ? vampiric_limits : normal_limits;
+    const auto has_extra_blows = flags.has(TR_BLOWS) && (o_ptr->pval >= 1) && (o_ptr->pval <= 3);
+    const auto limit = limits[has_extra_blows ? o_ptr->pval : 0];
+    return calc_arm_avgdamage(player_ptr, o_ptr, flags) > limit;
 }
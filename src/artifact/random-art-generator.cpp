@@ -12,6 +12,7 @@
 #include "artifact/random-art-characteristics.h"
 #include "artifact/random-art-effects.h"
 #include "artifact/random-art-misc.h"
+#include "artifact/random-art-profiler.h"
 #include "artifact/random-art-pval-investor.h"
 #include "artifact/random-art-resistance.h"
 #include "artifact/random-art-slay.h"
@@ -382,7 +383,7 @@ static int decide_random_art_power_level(ItemEntity *o_ptr, const bool a_cursed,
 
 static std::string name_unnatural_random_artifact(PlayerType *player_ptr, ItemEntity *o_ptr, const bool a_scroll, const int power_level)
 {
-    if (!a_scroll) {
+    if (!a_scroll || RandomArtifactProfiler::get_instance().is_batch_running()) {
         return get_random_name(*o_ptr, o_ptr->is_protector(), power_level);
     }
 
@@ -417,6 +418,7 @@ static void generate_unnatural_random_artifact(
     msg_format_wizard(player_ptr, CHEAT_OBJECT,
         _("パワー %d で 価値 %d のランダムアーティファクト生成 バイアスは「%s」", "Random artifact generated - Power:%d Value:%d Bias:%s."), max_powers,
         total_flags, artifact_bias_name[o_ptr->artifact_bias]);
+    RandomArtifactProfiler::get_instance().record_power(max_powers, total_flags, power_level);
     static constexpr auto flags = {
         SubWindowRedrawingFlag::INVENTORY,
         SubWindowRedrawingFlag::EQUIPMENT,
@@ -0,0 +1,224 @@
+/*!
+ * @brief ランダムアーティファクト生成の計測
+ * @details *生成*の巻物の大量使用やバランス調整のために、ランダムアーティファクトを一括生成して
+ * 生成速度とパワーの分布を調べる. 計測結果は --profile-artifacts オプションでJSONとして書き出す.
+ */
+
+#include "artifact/random-art-profiler.h"
+#include "artifact/random-art-generator.h"
+#include "external-lib/include-json.h"
+#include "io/files-util.h"
+#include "object/object-value.h"
+#include "player-info/class-info.h"
+#include "player-info/class-types.h"
+#include "system/baseitem-info.h"
+#include "system/item-entity.h"
+#include "system/player-type-definition.h"
+#include "util/angband-files.h"
+#include "util/enum-converter.h"
+#include "util/finalizer.h"
+#include "wizard/artifact-bias-table.h"
+#include <algorithm>
+#include <fstream>
+
+namespace {
+double to_milliseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+}
+
+RandomArtifactProfiler RandomArtifactProfiler::instance{};
+
+RandomArtifactProfiler &RandomArtifactProfiler::get_instance()
+{
+    return instance;
+}
+
+void RandomArtifactProfiler::ValueStats::add(int value)
+{
+    this->min = (this->count == 0) ? value : std::min(this->min, value);
+    this->max = (this->count == 0) ? value : std::max(this->max, value);
+    this->sum += value;
+    this->count++;
+}
+
+/*!
+ * @brief ランダムアーティファクト1個の生成の計測を開始する
+ * @param bi_id ベースアイテムID
+ * @param source 生成元. *生成*の巻物ならば読んだプレイヤーの職業、自然生成ならば NATURAL_SOURCE
+ */
+void RandomArtifactProfiler::begin_artifact(short bi_id, short source)
+{
+    this->current_key = std::make_pair(bi_id, source);
+    this->artifact_start = std::chrono::steady_clock::now();
+}
+
+/*!
+ * @brief ランダムアーティファクト1個の生成の計測を終了する
+ * @param item 生成したランダムアーティファクト
+ */
+void RandomArtifactProfiler::end_artifact(const ItemEntity &item)
+{
+    if (!this->current_key) {
+        return;
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - this->artifact_start;
+    auto &artifact_stats = this->stats[*this->current_key];
+    artifact_stats.artifacts++;
+    artifact_stats.total += elapsed;
+    artifact_stats.max = std::max(artifact_stats.max, elapsed);
+    artifact_stats.values.add(object_value_real(&item));
+    artifact_stats.biases[item.artifact_bias]++;
+    this->current_key = std::nullopt;
+}
+
+/*!
+ * @brief 生成中のランダムアーティファクトのパワーを記録する
+ * @param max_powers 付与を試みた能力の数
+ * @param total_flags 付与した能力の価値
+ * @param power_level 銘の基準となる価値レベル(0=呪い、1=低位、2=中位、3=高位)
+ * @details 計測中でなければ何もしない
+ */
+void RandomArtifactProfiler::record_power(int max_powers, int total_flags, int power_level)
+{
+    if (!this->current_key) {
+        return;
+    }
+
+    auto &artifact_stats = this->stats[*this->current_key];
+    artifact_stats.powers.add(max_powers);
+    artifact_stats.flag_costs.add(total_flags);
+    artifact_stats.power_levels[std::clamp<size_t>(power_level, 0, artifact_stats.power_levels.size() - 1)]++;
+}
+
+void RandomArtifactProfiler::clear()
+{
+    this->stats.clear();
+}
+
+/*!
+ * @brief 計測用の一括生成中かを返す
+ * @details 一括生成中は*生成*の巻物でも銘の入力を求めない
+ */
+bool RandomArtifactProfiler::is_batch_running() const
+{
+    return this->is_batch;
+}
+
+void RandomArtifactProfiler::set_batch_running(bool is_running)
+{
+    this->is_batch = is_running;
+}
+
+/*!
+ * @brief 計測結果をJSONに変換する
+ * @return ベースアイテム・生成元ごとの計測結果の配列を "artifacts" に、全体の生成速度を "artifacts_per_second" に持つJSON文字列
+ */
+std::string RandomArtifactProfiler::to_json() const
+{
+    const auto to_json_stats = [](const ValueStats &value_stats) {
+        return nlohmann::json{
+            { "min", value_stats.min },
+            { "max", value_stats.max },
+            { "mean", (value_stats.count > 0) ? static_cast<double>(value_stats.sum) / value_stats.count : 0.0 },
+        };
+    };
+
+    auto artifacts = nlohmann::json::array();
+    auto total_artifacts = 0;
+    std::chrono::steady_clock::duration total_elapsed{};
+    for (const auto &[key, artifact_stats] : this->stats) {
+        const auto &[bi_id, source] = key;
+        nlohmann::json biases;
+        for (const auto &[bias, count] : artifact_stats.biases) {
+            biases[artifact_bias_name[bias]] = count;
+        }
+
+        const auto is_scroll = source != NATURAL_SOURCE;
+        artifacts.push_back({
+            { "bi_id", bi_id },
+            { "baseitem", baseitems_info[bi_id].name },
+            { "source", is_scroll ? class_info[source].title : "natural" },
+            { "artifacts", artifact_stats.artifacts },
+            { "total_ms", to_milliseconds(artifact_stats.total) },
+            { "max_ms", to_milliseconds(artifact_stats.max) },
+            { "powers", to_json_stats(artifact_stats.powers) },
+            { "flag_costs", to_json_stats(artifact_stats.flag_costs) },
+            { "values", to_json_stats(artifact_stats.values) },
+            { "power_levels", artifact_stats.power_levels },
+            { "biases", biases },
+        });
+
+        total_artifacts += artifact_stats.artifacts;
+        total_elapsed += artifact_stats.total;
+    }
+
+    const auto total_seconds = to_milliseconds(total_elapsed) / 1000;
+    nlohmann::json json;
+    json["artifacts"] = artifacts;
+    json["total_artifacts"] = total_artifacts;
+    json["artifacts_per_second"] = (total_seconds > 0) ? total_artifacts / total_seconds : 0.0;
+    return json.dump(2, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+/*!
+ * @brief 計測結果をユーザディレクトリにJSONファイルとして保存する
+ * @param filename ファイル名
+ * @return 保存に成功したらtrue
+ */
+bool RandomArtifactProfiler::save(std::string_view filename) const
+{
+    const auto &path = path_build(ANGBAND_DIR_USER, filename);
+    std::ofstream ofs(path);
+    if (!ofs) {
+        return false;
+    }
+
+    ofs << this->to_json() << '\n';
+    return static_cast<bool>(ofs);
+}
+
+/*!
+ * @brief 計測のためにランダムアーティファクトを一括生成する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param artifacts_per_item ベースアイテム・生成元1組あたりの生成数
+ * @details ランダムアーティファクトになり得る全てのベースアイテムについて、自然生成と全職業の*生成*の巻物で生成する.
+ * 生成したアイテムはフロアに置かずに捨てる.
+ */
+void generate_random_artifacts_for_profiling(PlayerType *player_ptr, int artifacts_per_item)
+{
+    auto &profiler = RandomArtifactProfiler::get_instance();
+    profiler.set_batch_running(true);
+    const auto pclass = player_ptr->pclass;
+    const auto finalizer = util::make_finalizer([&profiler, player_ptr, pclass] {
+        profiler.set_batch_running(false);
+        player_ptr->pclass = pclass;
+    });
+    for (const auto &baseitem : baseitems_info) {
+        if ((baseitem.idx == 0) || baseitem.name.empty() || baseitem.gen_flags.has(ItemGenerationTraitType::INSTA_ART)) {
+            continue;
+        }
+
+        ItemEntity item;
+        item.prep(baseitem.idx);
+        if (!item.is_weapon_armour_ammo()) {
+            continue;
+        }
+
+        for (short source = RandomArtifactProfiler::NATURAL_SOURCE; source < PLAYER_CLASS_TYPE_MAX; source++) {
+            const auto is_scroll = source != RandomArtifactProfiler::NATURAL_SOURCE;
+            if (is_scroll) {
+                player_ptr->pclass = i2enum<PlayerClassType>(source);
+            }
+
+            for (auto i = 0; i < artifacts_per_item; i++) {
+                item.prep(baseitem.idx);
+                profiler.begin_artifact(baseitem.idx, source);
+                become_random_artifact(player_ptr, &item, is_scroll);
+                profiler.end_artifact(item);
+            }
+        }
+    }
+}
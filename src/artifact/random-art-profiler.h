@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+class ItemEntity;
+class PlayerType;
+
+/*!
+ * @brief ランダムアーティファクト生成の計測結果を集計するクラス
+ * @details ベースアイテムと生成元 (自然生成、または職業ごとの*生成*の巻物) の組ごとに、
+ * 生成数・所要時間と、パワー・価値・バイアスの分布を記録する.
+ */
+class RandomArtifactProfiler {
+public:
+    RandomArtifactProfiler(const RandomArtifactProfiler &) = delete;
+    RandomArtifactProfiler(RandomArtifactProfiler &&) = delete;
+    RandomArtifactProfiler &operator=(const RandomArtifactProfiler &) = delete;
+    RandomArtifactProfiler &operator=(RandomArtifactProfiler &&) = delete;
+    ~RandomArtifactProfiler() = default;
+
+    static constexpr short NATURAL_SOURCE = -1; //!< 自然生成を表す生成元
+
+    static RandomArtifactProfiler &get_instance();
+    void begin_artifact(short bi_id, short source);
+    void end_artifact(const ItemEntity &item);
+    void record_power(int max_powers, int total_flags, int power_level);
+    void clear();
+    bool is_batch_running() const;
+    void set_batch_running(bool is_running);
+    std::string to_json() const;
+    bool save(std::string_view filename) const;
+
+private:
+    RandomArtifactProfiler() = default;
+
+    struct ValueStats {
+        int count = 0;
+        int64_t sum = 0;
+        int min = 0;
+        int max = 0;
+
+        void add(int value);
+    };
+
+    struct ArtifactStats {
+        int artifacts = 0;
+        std::chrono::steady_clock::duration total{};
+        std::chrono::steady_clock::duration max{};
+        ValueStats powers;
+        ValueStats flag_costs;
+        ValueStats values;
+        std::array<int, 4> power_levels{};
+        std::map<int, int> biases;
+    };
+
+    static RandomArtifactProfiler instance;
+    std::map<std::pair<short, short>, ArtifactStats> stats;
+    std::optional<std::pair<short, short>> current_key;
+    std::chrono::steady_clock::time_point artifact_start;
+    bool is_batch = false;
+};
+
+void generate_random_artifacts_for_profiling(PlayerType *player_ptr, int artifacts_per_item);
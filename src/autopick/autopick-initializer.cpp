@@ -2,9 +2,11 @@
 #include "autopick/autopick-entry.h"
 #include "autopick/autopick-util.h"
 #include "system/angband.h"
+#include "window/overview-map.h"
 
 /*!
  * @brief Initialize the autopick
+ * @details 縮小マップが保持している自動拾いの一致結果も破棄させる
  */
 void init_autopick(void)
 {
@@ -14,4 +16,5 @@ void init_autopick(void)
     autopick_type entry;
     autopick_new_entry(&entry, easy_autopick_inscription, true);
     autopick_list.push_back(std::move(entry));
+    OverviewMap::get_instance().invalidate();
 }
@@ -0,0 +1,228 @@
+/*!
+ * @brief オートローラの並列探索
+ * @details 探索中は乱数を含めてゲームの状態を一切書き換えない.
+ * 条件を満たす候補が見つかったら、呼び出し側がその候補の乱数系列を本来の乱数に設定してロールし直す.
+ */
+
+#include "birth/auto-roller-searcher.h"
+#include "birth/birth-body-spec.h"
+#include "birth/birth-stat.h"
+#include "birth/history-generator.h"
+#include "game-option/birth-options.h"
+#include "locale/japanese.h"
+#include "system/player-type-definition.h"
+#include <algorithm>
+
+namespace {
+/*!
+ * @brief SplitMix64 で64ビットの値を1つ生成する
+ * @param state 内部状態. 呼び出すたびに更新される
+ */
+uint64_t splitmix64(uint64_t &state)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+}
+
+/*!
+ * @brief コンストラクタ
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param chara_limit 年齢・身長・体重・社会的地位の要求水準
+ * @details 探索中にプレイヤーを参照しないよう、照合に必要な値はここで写し取る
+ */
+AutoRollerSearcher::AutoRollerSearcher(PlayerType *player_ptr, const chara_limit_type &chara_limit)
+    : chara_limit(chara_limit)
+    , uses_stat_limits(autoroller)
+    , uses_chara_limits(autochara)
+    , psex(player_ptr->psex)
+    , prace(player_ptr->prace)
+{
+    std::copy_n(stat_limit, A_MAX, this->stat_limits.begin());
+}
+
+AutoRollerSearcher::~AutoRollerSearcher()
+{
+    this->cancel();
+}
+
+/*!
+ * @brief 探索を開始する
+ * @param seed 各候補の乱数系列の元とするシード. 本来の乱数から引いた値を与える
+ */
+void AutoRollerSearcher::start(uint64_t seed)
+{
+    this->seed = seed;
+    const auto num_threads = std::max(1U, std::thread::hardware_concurrency());
+    for (auto i = 0U; i < num_threads; i++) {
+        this->workers.emplace_back(&AutoRollerSearcher::run, this);
+    }
+}
+
+/*!
+ * @brief 条件を満たす候補が見つかるまで待つ
+ * @param timeout 待つ時間の上限
+ * @return 候補が見つかったらtrue
+ */
+bool AutoRollerSearcher::wait_for(std::chrono::milliseconds timeout)
+{
+    std::unique_lock lock(this->mutex);
+    return this->cv.wait_for(lock, timeout, [this] { return this->found_index != NOT_FOUND; });
+}
+
+/*!
+ * @brief 探索を終えて結果を返す
+ * @return 条件を満たす最も若い候補の番号. 見つかっていなければnullopt
+ * @details 見つかった候補より若い番号の照合が全て終わるまで待つ
+ */
+std::optional<uint64_t> AutoRollerSearcher::finish()
+{
+    this->join();
+    const auto index = this->found_index.load();
+    if (index == NOT_FOUND) {
+        return std::nullopt;
+    }
+
+    return index;
+}
+
+/*!
+ * @brief 探索を中断する
+ */
+void AutoRollerSearcher::cancel()
+{
+    this->is_canceled = true;
+    this->join();
+}
+
+/*!
+ * @brief 照合を終えた候補の数を返す
+ * @details 探索中は概数. 候補が見つかって finish() した後は、見つかった候補までの数に一致する
+ */
+uint64_t AutoRollerSearcher::get_rolled_count() const
+{
+    const auto index = this->found_index.load();
+    if (index != NOT_FOUND) {
+        return std::min(this->rolled_count.load(), index + 1);
+    }
+
+    return this->rolled_count;
+}
+
+/*!
+ * @brief 候補の乱数系列を生成する
+ * @param index 候補の番号
+ * @return 候補をロールするための乱数生成器
+ */
+Xoshiro128StarStar AutoRollerSearcher::make_rng(uint64_t index) const
+{
+    uint64_t state = this->seed ^ (index * 0xd1b54a32d192ed03ULL);
+    Xoshiro128StarStar::state_type rng_state{};
+    do {
+        const auto a = splitmix64(state);
+        const auto b = splitmix64(state);
+        rng_state = { { static_cast<uint32_t>(a), static_cast<uint32_t>(a >> 32), static_cast<uint32_t>(b), static_cast<uint32_t>(b >> 32) } };
+    } while (std::all_of(rng_state.begin(), rng_state.end(), [](auto s) { return s == 0; }));
+
+    Xoshiro128StarStar rng;
+    rng.set_state(rng_state);
+    return rng;
+}
+
+/*!
+ * @brief ワーカースレッドの処理
+ * @details 候補を BLOCK_SIZE 個ずつ若い順に受け持つ. 見つかった候補より後ろのブロックは受け持たない
+ */
+void AutoRollerSearcher::run()
+{
+    while (!this->is_canceled) {
+        const auto begin = this->next_block.fetch_add(1) * BLOCK_SIZE;
+        if (begin >= this->found_index) {
+            return;
+        }
+
+        auto index = begin;
+        for (; index < begin + BLOCK_SIZE; index++) {
+            if ((index >= this->found_index) || this->is_canceled) {
+                break;
+            }
+
+            if (this->check(index)) {
+                this->report_found(index++);
+                break;
+            }
+        }
+
+        this->rolled_count += index - begin;
+    }
+}
+
+/*!
+ * @brief 候補をロールして要求水準と照合する
+ * @param index 候補の番号
+ * @return 要求水準を満たしていればtrue
+ * @details 乱数の消費順は birth-wizard の get_stats()、get_ahw()、get_history() の呼び出し順と一致させること
+ */
+bool AutoRollerSearcher::check(uint64_t index) const
+{
+    auto rng = this->make_rng(index);
+    const auto stats = roll_stats(rng);
+    if (this->uses_stat_limits) {
+        for (auto i = 0; i < A_MAX; i++) {
+            if (stats[i] < this->stat_limits[i]) {
+                return false;
+            }
+        }
+    }
+
+    const auto body = roll_body_spec(rng, this->psex);
+    const auto sc = roll_social_class(rng, this->prace);
+    if (!this->uses_chara_limits) {
+        return true;
+    }
+
+    const auto &limit = this->chara_limit;
+    if ((body.age < limit.agemin) || (body.age > limit.agemax)) {
+        return false;
+    }
+
+    const auto ht = _(inch_to_cm(body.ht), body.ht);
+    if ((ht < limit.htmin) || (ht > limit.htmax)) {
+        return false;
+    }
+
+    const auto wt = _(lb_to_kg(body.wt), body.wt);
+    if ((wt < limit.wtmin) || (wt > limit.wtmax)) {
+        return false;
+    }
+
+    return (sc >= limit.scmin) && (sc <= limit.scmax);
+}
+
+/*!
+ * @brief 条件を満たす候補を記録する
+ * @param index 候補の番号
+ * @details 複数のスレッドが見つけた場合は最も若い番号を残す
+ */
+void AutoRollerSearcher::report_found(uint64_t index)
+{
+    auto current = this->found_index.load();
+    while ((index < current) && !this->found_index.compare_exchange_weak(current, index)) {
+    }
+
+    std::lock_guard lock(this->mutex);
+    this->cv.notify_all();
+}
+
+void AutoRollerSearcher::join()
+{
+    for (auto &worker : this->workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    this->workers.clear();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "birth/auto-roller.h"
+#include "player-ability/player-ability-types.h"
+#include "player/player-sex.h"
+#include "util/rng-xoshiro.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+enum class PlayerRaceType;
+class PlayerType;
+
+/*!
+ * @brief オートローラの条件を満たすキャラクターを複数のスレッドで探すクラス
+ * @details 候補ごとに本来の乱数から分岐させた独立の乱数系列を割り当て、能力値・年齢・身長・体重・社会的地位だけを
+ * 画面の更新なしにロールして条件と照合する. 候補は番号の若い順に割り振るため、
+ * スレッド数や実行のタイミングに関わらず条件を満たす最も若い番号の候補が結果となる.
+ * 結果の候補は make_rng() で得た乱数を本来の乱数に設定して通常の手順でロールし直せば再現できる.
+ */
+class AutoRollerSearcher {
+public:
+    AutoRollerSearcher(PlayerType *player_ptr, const chara_limit_type &chara_limit);
+    AutoRollerSearcher(const AutoRollerSearcher &) = delete;
+    AutoRollerSearcher(AutoRollerSearcher &&) = delete;
+    AutoRollerSearcher &operator=(const AutoRollerSearcher &) = delete;
+    AutoRollerSearcher &operator=(AutoRollerSearcher &&) = delete;
+    ~AutoRollerSearcher();
+
+    void start(uint64_t seed);
+    bool wait_for(std::chrono::milliseconds timeout);
+    std::optional<uint64_t> finish();
+    void cancel();
+    uint64_t get_rolled_count() const;
+    Xoshiro128StarStar make_rng(uint64_t index) const;
+
+private:
+    static constexpr uint64_t BLOCK_SIZE = 1024; //!< 1スレッドが一度に受け持つ候補の数
+    static constexpr auto NOT_FOUND = UINT64_MAX;
+
+    std::array<short, A_MAX> stat_limits{};
+    chara_limit_type chara_limit;
+    bool uses_stat_limits;
+    bool uses_chara_limits;
+    player_sex psex;
+    PlayerRaceType prace;
+    uint64_t seed = 0;
+
+    std::vector<std::thread> workers;
+    std::atomic<uint64_t> next_block = 0;
+    std::atomic<uint64_t> found_index = NOT_FOUND;
+    std::atomic<uint64_t> rolled_count = 0;
+    std::atomic<bool> is_canceled = false;
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    void run();
+    bool check(uint64_t index) const;
+    void report_found(uint64_t index);
+    void join();
+};
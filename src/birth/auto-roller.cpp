@@ -16,6 +16,7 @@
 #include "term/term-color-types.h"
 #include "term/z-form.h"
 #include "util/int-char-converter.h"
+#include <array>
 
 /*! オートローラの能力値的要求水準 / Autoroll limit */
 int16_t stat_limit[6];
@@ -30,29 +31,22 @@ int32_t autoroll_chance;
 /*!
  * @breif オートローラーで指定した能力値以上が出る確率を計算する。
  * @return 確率 / 100
+ * @details 能力値ごとに、合計値ごとの組み合わせ数へ出目の分布を畳み込んで厳密に数える
  */
 static int32_t get_autoroller_prob(int *minval)
 {
     /* 1 percent of the valid random space (60^6 && 72<sum<87) */
-    int32_t tot_rand_1p = 320669745;
-    int i, j, tmp;
-    int ii[6];
-    int tval[6];
-    int tot = 0;
-
-    /* success count */
-    int32_t succ = 0;
+    constexpr int32_t tot_rand_1p = 320669745;
 
     /* random combinations out of 60 (1d3+1d4+1d5) patterns */
-    int pp[18] = {
+    constexpr std::array<int64_t, 18> pp = {
         0, 0, 0, 0, 0, 0, 0, 0, /* 0-7 */
         1, 3, 6, 9, 11, 11, 9, 6, 3, 1 /* 8-17 */
     };
 
-    /* Copy */
-    for (i = 0; i < 6; i++) {
-        tval[i] = std::max(8, minval[i]);
-        tot += tval[i];
+    auto tot = 0;
+    for (auto i = 0; i < A_MAX; i++) {
+        tot += std::max(8, minval[i]);
     }
 
     /* No Chance */
@@ -60,49 +54,37 @@ static int32_t get_autoroller_prob(int *minval)
         return -999;
     }
 
-    /* bubble sort for speed-up */
-    for (i = 0; i < 5; i++) {
-        for (j = 5; j > i; j--) {
-            if (tval[j - 1] < tval[j]) {
-                tmp = tval[j - 1];
-                tval[j - 1] = tval[j];
-                tval[j] = tmp;
+    /* ways[s] = 能力値の合計が s となる組み合わせ数 */
+    constexpr auto max_sum = 17 * A_MAX;
+    std::array<int64_t, max_sum + 1> ways{};
+    ways[0] = 1;
+    for (auto i = 0; i < A_MAX; i++) {
+        std::array<int64_t, max_sum + 1> next{};
+        for (auto sum = 0; sum <= max_sum; sum++) {
+            if (ways[sum] == 0) {
+                continue;
             }
-        }
-    }
 
-    tot = 0;
-
-    /* calc. prob. */
-    for (ii[0] = tval[0]; ii[0] < 18; ii[0]++) {
-        for (ii[1] = tval[1]; ii[1] < 18; ii[1]++) {
-            for (ii[2] = tval[2]; ii[2] < 18; ii[2]++) {
-                for (ii[3] = tval[3]; ii[3] < 18; ii[3]++) {
-                    for (ii[4] = tval[4]; ii[4] < 18; ii[4]++) {
-                        for (ii[5] = tval[5]; ii[5] < 18; ii[5]++) {
-                            tot = ii[0] + ii[1] + ii[2] + ii[3] + ii[4] + ii[5];
-
-                            if (tot > 86) {
-                                break;
-                            }
-                            if (tot <= 72) {
-                                continue;
-                            }
-
-                            succ += (pp[ii[0]] * pp[ii[1]] * pp[ii[2]] * pp[ii[3]] * pp[ii[4]] * pp[ii[5]]);
-
-                            /* If given condition is easy enough, quit calc. to save CPU. */
-                            if (succ > 320670) {
-                                return -1;
-                            }
-                        }
-                    }
-                }
+            for (auto val = std::max(8, minval[i]); (val < 18) && (sum + val <= max_sum); val++) {
+                next[sum + val] += ways[sum] * pp[val];
             }
         }
+
+        ways = next;
+    }
+
+    /* success count */
+    int64_t succ = 0;
+    for (auto sum = 73; sum <= 86; sum++) {
+        succ += ways[sum];
+    }
+
+    /* If given condition is easy enough, show it as such. */
+    if (succ > 320670) {
+        return -1;
     }
 
-    return tot_rand_1p / succ;
+    return static_cast<int32_t>(tot_rand_1p / succ);
 }
 
 /*!
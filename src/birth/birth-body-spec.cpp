@@ -6,37 +6,70 @@
 #include "player/player-personality-types.h"
 #include "player/player-sex.h"
 #include "system/player-type-definition.h"
+#include "util/rng-xoshiro.h"
+#include "world/world.h"
 
 /*!
- * @brief プレイヤーの身長体重を決める / Get character's height and weight
+ * @brief 身長と体重をロールする
+ * @param rng 乱数生成器
+ * @param psex 性別
+ * @param spec 結果の格納先. 性別が男女以外ならば書き換えない
  */
-void get_height_weight(PlayerType *player_ptr)
+static void roll_height_weight(Xoshiro128StarStar &rng, player_sex psex, BirthBodySpec &spec)
 {
     int deviation;
-    switch (player_ptr->psex) {
+    switch (psex) {
     case SEX_MALE:
-        player_ptr->ht = randnor(rp_ptr->m_b_ht, rp_ptr->m_m_ht);
-        deviation = (int)(player_ptr->ht) * 100 / (int)(rp_ptr->m_b_ht);
-        player_ptr->wt = randnor((int)(rp_ptr->m_b_wt) * deviation / 100, (int)(rp_ptr->m_m_wt) * deviation / 300);
+        spec.ht = randnor(rng, rp_ptr->m_b_ht, rp_ptr->m_m_ht);
+        deviation = (int)(spec.ht) * 100 / (int)(rp_ptr->m_b_ht);
+        spec.wt = randnor(rng, (int)(rp_ptr->m_b_wt) * deviation / 100, (int)(rp_ptr->m_m_wt) * deviation / 300);
         return;
     case SEX_FEMALE:
-        player_ptr->ht = randnor(rp_ptr->f_b_ht, rp_ptr->f_m_ht);
-        deviation = (int)(player_ptr->ht) * 100 / (int)(rp_ptr->f_b_ht);
-        player_ptr->wt = randnor((int)(rp_ptr->f_b_wt) * deviation / 100, (int)(rp_ptr->f_m_wt) * deviation / 300);
+        spec.ht = randnor(rng, rp_ptr->f_b_ht, rp_ptr->f_m_ht);
+        deviation = (int)(spec.ht) * 100 / (int)(rp_ptr->f_b_ht);
+        spec.wt = randnor(rng, (int)(rp_ptr->f_b_wt) * deviation / 100, (int)(rp_ptr->f_m_wt) * deviation / 300);
         return;
     default:
         return;
     }
 }
 
+/*!
+ * @brief 年齢・身長・体重をロールする
+ * @param rng 乱数生成器
+ * @param psex 性別
+ * @return 年齢・身長・体重. 性別が男女以外ならば身長と体重は0
+ * @details オートローラの探索では本来の乱数から分岐させた乱数系列で呼び出す
+ */
+BirthBodySpec roll_body_spec(Xoshiro128StarStar &rng, player_sex psex)
+{
+    BirthBodySpec spec{};
+    spec.age = rp_ptr->b_age + rand_range(rng, 0, rp_ptr->m_age - 1) + 1;
+    roll_height_weight(rng, psex, spec);
+    return spec;
+}
+
+/*!
+ * @brief プレイヤーの身長体重を決める / Get character's height and weight
+ */
+void get_height_weight(PlayerType *player_ptr)
+{
+    BirthBodySpec spec{ player_ptr->age, player_ptr->ht, player_ptr->wt };
+    roll_height_weight(w_ptr->rng, player_ptr->psex, spec);
+    player_ptr->ht = spec.ht;
+    player_ptr->wt = spec.wt;
+}
+
 /*!
  * @brief プレイヤーの年齢を決める。 / Computes character's age, height, and weight by henkma
  * @details 内部でget_height_weight()も呼び出している。
  */
 void get_ahw(PlayerType *player_ptr)
 {
-    player_ptr->age = rp_ptr->b_age + randint1(rp_ptr->m_age);
-    get_height_weight(player_ptr);
+    const auto spec = roll_body_spec(w_ptr->rng, player_ptr->psex);
+    player_ptr->age = spec.age;
+    player_ptr->ht = spec.ht;
+    player_ptr->wt = spec.wt;
 }
 
 /*!
@@ -1,6 +1,20 @@
 #pragma once
 
+#include "player/player-sex.h"
+#include <cstdint>
+
+/*!
+ * @brief キャラクター作成時にロールする年齢・身長・体重
+ */
+struct BirthBodySpec {
+    int16_t age;
+    int16_t ht;
+    int16_t wt;
+};
+
 class PlayerType;
+class Xoshiro128StarStar;
+BirthBodySpec roll_body_spec(Xoshiro128StarStar &rng, player_sex psex);
 void get_height_weight(PlayerType *player_ptr);
 void get_ahw(PlayerType *player_ptr);
 void get_money(PlayerType *player_ptr);
@@ -12,6 +12,8 @@
 #include "sv-definition/sv-weapon-types.h"
 #include "system/player-type-definition.h"
 #include "system/redrawing-flags-updater.h"
+#include "util/rng-xoshiro.h"
+#include "world/world.h"
 #include <array>
 
 namespace {
@@ -63,33 +65,48 @@ int adjust_stat(int value, int amount)
 }
 
 /*!
- * @brief プレイヤーの能力値を一通りロールする。 / Roll for a characters stats
- * @param player_ptr プレイヤーへの参照ポインタ
- * @details
- * calc_bonuses()による、独立ステータスからの副次ステータス算出も行っている。
- * For efficiency, we include a chunk of "calc_bonuses()".\n
+ * @brief 能力値を一通りロールする
+ * @param rng 乱数生成器
+ * @return 各能力値の基本値
+ * @details オートローラの探索では本来の乱数から分岐させた乱数系列で呼び出す
  */
-void get_stats(PlayerType *player_ptr)
+std::array<short, A_MAX> roll_stats(Xoshiro128StarStar &rng)
 {
+    std::array<short, A_MAX> stats{};
     while (true) {
         auto sum = 0;
         for (auto i = 0; i < 2; i++) {
-            auto tmp = randint0(random_distribution * random_distribution * random_distribution);
+            auto tmp = rand_range(rng, 0, random_distribution * random_distribution * random_distribution - 1);
             for (auto j = 0; j < 3; j++) {
                 auto stat = i * 3 + j;
                 auto val = auto_roller_distribution[tmp % random_distribution];
                 sum += val;
-                player_ptr->stat_cur[stat] = player_ptr->stat_max[stat] = val;
+                stats[stat] = val;
                 tmp /= random_distribution;
             }
         }
 
         if ((sum > 42 + 5 * 6) && (sum < 57 + 5 * 6)) {
-            break;
+            return stats;
         }
     }
 }
 
+/*!
+ * @brief プレイヤーの能力値を一通りロールする。 / Roll for a characters stats
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @details
+ * calc_bonuses()による、独立ステータスからの副次ステータス算出も行っている。
+ * For efficiency, we include a chunk of "calc_bonuses()".\n
+ */
+void get_stats(PlayerType *player_ptr)
+{
+    const auto stats = roll_stats(w_ptr->rng);
+    for (auto i = 0; i < A_MAX; i++) {
+        player_ptr->stat_cur[i] = player_ptr->stat_max[i] = stats[i];
+    }
+}
+
 /*!
  * @brief 経験値修正の合計値を計算
  */
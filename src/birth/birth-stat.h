@@ -1,9 +1,13 @@
 #pragma once
 
+#include "player-ability/player-ability-types.h"
 #include "system/angband.h"
+#include <array>
 
 class PlayerType;
+class Xoshiro128StarStar;
 int adjust_stat(int value, int amount);
+std::array<short, A_MAX> roll_stats(Xoshiro128StarStar &rng);
 void get_stats(PlayerType *player_ptr);
 uint16_t get_expfact(PlayerType *player_ptr);
 void get_extra(PlayerType *player_ptr, bool roll_hitdie);
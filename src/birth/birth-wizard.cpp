@@ -1,5 +1,6 @@
 #include "birth/birth-wizard.h"
 #include "avatar/avatar.h"
+#include "birth/auto-roller-searcher.h"
 #include "birth/auto-roller.h"
 #include "birth/birth-body-spec.h"
 #include "birth/birth-explanations-table.h"
@@ -44,17 +45,15 @@
 #include "view/display-player.h" // 暫定。後で消す.
 #include "view/display-util.h"
 #include "world/world.h"
+#include <chrono>
 #include <sstream>
 
 /*!
  * オートローラーの内容を描画する間隔 /
- * How often the autoroller will update the display and pause
- * to check for user interuptions.
- * Bigger values will make the autoroller faster, but slower
- * system may have problems because the user can't stop the
- * autoroller for this number of rolls.
+ * How often the autoroller will update the display and check for user interuptions.
+ * The rolls themselves run on worker threads, so this does not slow the autoroller down.
  */
-#define AUTOROLLER_STEP 54321L
+constexpr auto AUTOROLLER_DISPLAY_INTERVAL = std::chrono::milliseconds(100);
 
 static void display_initial_birth_message(PlayerType *player_ptr)
 {
@@ -337,70 +336,40 @@ static void display_auto_roller_success_rate(const int col)
     }
 }
 
-static void auto_roller_count(void)
-{
-    if (auto_round < 1000000000L) {
-        return;
-    }
-
-    auto_round = 1;
-    if (!autoroller) {
-        return;
-    }
+constexpr auto AUTOROLLER_UPPER_UNIT = 1000000000ULL;
 
-    auto_upper_round++;
-}
-
-static bool decide_initial_stat(PlayerType *player_ptr)
+static uint64_t get_auto_roller_count()
 {
-    if (!autoroller) {
-        return true;
-    }
-
-    bool accept = true;
-    for (int i = 0; i < A_MAX; i++) {
-        if (player_ptr->stat_max[i] < stat_limit[i]) {
-            accept = false;
-            break;
-        }
-    }
-
-    return accept;
+    return auto_upper_round * AUTOROLLER_UPPER_UNIT + auto_round;
 }
 
-static bool decide_body_spec(PlayerType *player_ptr, chara_limit_type chara_limit, bool *accept)
+/*!
+ * @brief オートローラの試行回数を記録する
+ * @param count キャラクター作成を始めてからの試行回数
+ */
+static void set_auto_roller_count(uint64_t count)
 {
-    if (!*accept) {
-        return false;
-    }
-
-    get_ahw(player_ptr);
-    get_history(player_ptr);
-
-    if (autochara) {
-        if ((player_ptr->age < chara_limit.agemin) || (player_ptr->age > chara_limit.agemax)) {
-            *accept = false;
-        }
-        const auto ht = _(inch_to_cm(player_ptr->ht), player_ptr->ht);
-        if ((ht < chara_limit.htmin) || (ht > chara_limit.htmax)) {
-            *accept = false;
-        }
-        const auto wt = _(lb_to_kg(player_ptr->wt), player_ptr->wt);
-        if ((wt < chara_limit.wtmin) || (wt > chara_limit.wtmax)) {
-            *accept = false;
-        }
-        if ((player_ptr->sc < chara_limit.scmin) || (player_ptr->sc > chara_limit.scmax)) {
-            *accept = false;
-        }
-    }
-
-    return *accept;
+    auto_upper_round = static_cast<int32_t>(count / AUTOROLLER_UPPER_UNIT);
+    auto_round = static_cast<int32_t>(count % AUTOROLLER_UPPER_UNIT);
 }
 
-static bool display_auto_roller_count(PlayerType *player_ptr, const int col)
+/*!
+ * @brief オートローラの途中経過を表示し、中断のキー入力を確認する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param searcher 探索中のオートローラ
+ * @param base_count 今回の探索を始める前までの試行回数
+ * @param col 表示する列
+ * @return 中断するならtrue
+ * @details 「現在値」には探索中の候補の1つを表示する. 本来の乱数は消費しない
+ */
+static bool display_auto_roller_count(PlayerType *player_ptr, const AutoRollerSearcher &searcher, uint64_t base_count, const int col)
 {
-    if ((auto_round % AUTOROLLER_STEP) != 0) {
-        return false;
+    const auto rolled_count = searcher.get_rolled_count();
+    set_auto_roller_count(base_count + rolled_count);
+    auto rng = searcher.make_rng(rolled_count);
+    const auto stats = roll_stats(rng);
+    for (auto i = 0; i < A_MAX; i++) {
+        player_ptr->stat_cur[i] = player_ptr->stat_max[i] = stats[i];
     }
 
     birth_put_stats(player_ptr);
@@ -411,30 +380,44 @@ static bool display_auto_roller_count(PlayerType *player_ptr, const int col)
     }
     term_fresh();
     inkey_scan = true;
-    if (inkey()) {
-        get_ahw(player_ptr);
-        get_history(player_ptr);
-        return true;
-    }
-
-    return false;
+    return inkey() != 0;
 }
 
+/*!
+ * @brief オートローラを回す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param chara_limit 年齢・身長・体重・社会的地位の要求水準
+ * @param col 表示する列
+ * @details 条件を満たす候補はワーカースレッドで探す. 見つかった候補は、その乱数系列を本来の乱数に設定して
+ * 通常の手順でロールし直すので、結果とその後の乱数は探索のスレッド数に依存しない.
+ * 中断した場合は通常の手順で1回ロールした結果を返す.
+ */
 static void exe_auto_roller(PlayerType *player_ptr, chara_limit_type chara_limit, const int col)
 {
-    while (autoroller || autochara) {
-        get_stats(player_ptr);
-        auto_round++;
-        auto_roller_count();
-        bool accept = decide_initial_stat(player_ptr);
-        if (decide_body_spec(player_ptr, chara_limit, &accept)) {
-            return;
-        }
+    if (!autoroller && !autochara) {
+        return;
+    }
 
-        if (display_auto_roller_count(player_ptr, col)) {
-            return;
+    const auto base_count = get_auto_roller_count();
+    AutoRollerSearcher searcher(player_ptr, chara_limit);
+    const auto seed = (static_cast<uint64_t>(w_ptr->rng()) << 32) | w_ptr->rng();
+    searcher.start(seed);
+    while (!searcher.wait_for(AUTOROLLER_DISPLAY_INTERVAL)) {
+        if (display_auto_roller_count(player_ptr, searcher, base_count, col)) {
+            searcher.cancel();
+            break;
         }
     }
+
+    const auto found_index = searcher.finish();
+    set_auto_roller_count(base_count + searcher.get_rolled_count());
+    if (found_index) {
+        w_ptr->rng = searcher.make_rng(*found_index);
+    }
+
+    get_stats(player_ptr);
+    get_ahw(player_ptr);
+    get_history(player_ptr);
 }
 
 static bool display_auto_roller_result(PlayerType *player_ptr, bool prev, char *c)
@@ -3,14 +3,16 @@
 #include "player-info/race-types.h"
 #include "system/player-type-definition.h"
 #include "util/buffer-shaper.h"
+#include "util/rng-xoshiro.h"
 #include "util/string-processor.h"
+#include "world/world.h"
 #include <algorithm>
 #include <sstream>
 #include <string>
 
-static int get_history_chart(PlayerType *player_ptr)
+static int get_history_chart(PlayerRaceType prace)
 {
-    switch (player_ptr->prace) {
+    switch (prace) {
     case PlayerRaceType::AMBERITE:
         return 67;
     case PlayerRaceType::HUMAN:
@@ -90,22 +92,27 @@ static int get_history_chart(PlayerType *player_ptr)
 }
 
 /*!
- * @brief 生い立ちを画面に表示しつつ、種族から社会的地位を決定する
- * @param player_ptr プレイヤーへの参照ポインタ
+ * @brief 種族の生い立ち表を辿って社会的地位を決定する
+ * @param rng 乱数生成器
+ * @param prace 種族
+ * @param ss 生い立ちの文章の格納先. nullptrならば文章を組み立てない
+ * @return 社会的地位
  */
-static std::string decide_social_class(PlayerType *player_ptr)
+static short roll_history(Xoshiro128StarStar &rng, PlayerRaceType prace, std::stringstream *ss)
 {
-    short social_class = randint1(4);
-    auto chart = get_history_chart(player_ptr);
-    std::stringstream ss;
+    short social_class = rand_range(rng, 0, 3) + 1;
+    auto chart = get_history_chart(prace);
     while (chart != 0) {
         auto i = 0;
-        auto roll = randint1(100);
+        auto roll = rand_range(rng, 0, 99) + 1;
         while ((chart != backgrounds[i].chart) || (roll > backgrounds[i].roll)) {
             i++;
         }
 
-        ss << backgrounds[i].info;
+        if (ss != nullptr) {
+            *ss << backgrounds[i].info;
+        }
+
         social_class += static_cast<short>(backgrounds[i].bonus) - 50;
         chart = backgrounds[i].next;
     }
@@ -116,7 +123,29 @@ static std::string decide_social_class(PlayerType *player_ptr)
         social_class = 1;
     }
 
-    player_ptr->sc = social_class;
+    return social_class;
+}
+
+/*!
+ * @brief 生い立ちの文章を組み立てずに社会的地位だけを決定する
+ * @param rng 乱数生成器
+ * @param prace 種族
+ * @return 社会的地位
+ * @details get_history() と同じ手順で乱数を消費する. オートローラの探索で使う
+ */
+short roll_social_class(Xoshiro128StarStar &rng, PlayerRaceType prace)
+{
+    return roll_history(rng, prace, nullptr);
+}
+
+/*!
+ * @brief 生い立ちを画面に表示しつつ、種族から社会的地位を決定する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ */
+static std::string decide_social_class(PlayerType *player_ptr)
+{
+    std::stringstream ss;
+    player_ptr->sc = roll_history(w_ptr->rng, player_ptr->prace, &ss);
     return ss.str();
 }
 
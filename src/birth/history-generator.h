@@ -1,4 +1,7 @@
 #pragma once
 
+enum class PlayerRaceType;
 class PlayerType;
+class Xoshiro128StarStar;
+short roll_social_class(Xoshiro128StarStar &rng, PlayerRaceType prace);
 void get_history(PlayerType *player_ptr);
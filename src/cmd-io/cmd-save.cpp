@@ -16,7 +16,8 @@
  * Save the game
  * @param player_ptr プレイヤーへの参照ポインタ
  * @param is_autosave オートセーブ中の処理ならばTRUE
- * @details
+ * @details オートセーブはバックグラウンドで書き出し、結果は書き出し完了後に反映する.
+ * それ以外のセーブはディスクへの反映を待ってから完了を表示する.
  */
 void do_cmd_save_game(PlayerType *player_ptr, int is_autosave)
 {
@@ -32,10 +33,15 @@ void do_cmd_save_game(PlayerType *player_ptr, int is_autosave)
     term_fresh();
     player_ptr->died_from = _("(セーブ)", "(saved)");
     signals_ignore_tstp();
-    if (save_player(player_ptr, SaveType::CONTINUE_GAME)) {
-        prt(_("ゲームをセーブしています... 終了", "Saving game... done."), 0, 0);
-    } else {
+    auto is_successful = save_player(player_ptr, SaveType::CONTINUE_GAME);
+    if (!is_autosave) {
+        is_successful &= finish_background_saves(player_ptr, true);
+    }
+
+    if (!is_successful) {
         prt(_("ゲームをセーブしています... 失敗！", "Saving game... failed!"), 0, 0);
+    } else if (!is_autosave) {
+        prt(_("ゲームをセーブしています... 終了", "Saving game... done."), 0, 0);
     }
 
     signals_handle_tstp();
@@ -1,4 +1,7 @@
 #include "cmd-io/macro-util.h"
+#include <algorithm>
+#include <map>
+#include <string_view>
 
 /* Current macro action [1024] */
 std::vector<char> macro_buffers;
@@ -15,96 +18,167 @@ int16_t active_macros;
 /* Expand macros in "get_com" or not */
 bool get_com_no_macros = false;
 
-/* Determine if any macros have ever started with a given character */
-static bool macro_uses[256];
-
-/* Find the macro (if any) which exactly matches the given pattern */
-int macro_find_exact(concptr pat)
+namespace {
+/*!
+ * @brief マクロのトリガーを検索するための接頭辞木
+ * @details 各ノードは、そのノードで終わるマクロの番号と、より深いノードで終わるマクロの最小番号を持つ.
+ * 検索はいずれもパターン長に比例する時間で終わる.
+ * マクロは削除されないため、番号の最小値は追加時に経路上のノードを更新するだけで維持できる.
+ */
+class MacroTrie {
+public:
+    void insert(std::string_view pat, int index);
+    int find_exact(std::string_view pat) const;
+    int find_check(std::string_view pat) const;
+    int find_maybe(std::string_view pat) const;
+    int find_ready(std::string_view pat) const;
+
+private:
+    struct Node {
+        std::map<char, int> children{};
+        int macro_index = -1; //!< このノードで終わるマクロの番号
+        int min_index_below = -1; //!< より深いノードで終わるマクロの最小番号
+    };
+
+    std::vector<Node> nodes{ Node{} };
+
+    const Node *find_node(std::string_view pat) const;
+};
+
+int min_macro_index(int a, int b)
 {
-    if (!macro_uses[(byte)(pat[0])]) {
-        return -1;
+    if (a < 0) {
+        return b;
     }
 
-    for (int i = 0; i < active_macros; ++i) {
-        if (!streq(macro_patterns[i], pat)) {
-            continue;
-        }
-
-        return i;
+    if (b < 0) {
+        return a;
     }
 
-    return -1;
+    return std::min(a, b);
 }
 
-/*
- * Find the first macro (if any) which contains the given pattern
- */
-int macro_find_check(concptr pat)
+void MacroTrie::insert(std::string_view pat, int index)
 {
-    if (!macro_uses[(byte)(pat[0])]) {
-        return -1;
-    }
-
-    for (int i = 0; i < active_macros; ++i) {
-        if (!prefix(macro_patterns[i], pat)) {
+    auto node = 0;
+    for (auto c : pat) {
+        this->nodes[node].min_index_below = min_macro_index(this->nodes[node].min_index_below, index);
+        const auto it = this->nodes[node].children.find(c);
+        if (it != this->nodes[node].children.end()) {
+            node = it->second;
             continue;
         }
 
-        return i;
+        const auto child = static_cast<int>(this->nodes.size());
+        this->nodes[node].children.emplace(c, child);
+        this->nodes.emplace_back();
+        node = child;
     }
 
-    return -1;
+    this->nodes[node].macro_index = index;
 }
 
-/*
- * Find the first macro (if any) which contains the given pattern and more
- */
-int macro_find_maybe(concptr pat)
+const MacroTrie::Node *MacroTrie::find_node(std::string_view pat) const
 {
-    if (!macro_uses[(byte)(pat[0])]) {
-        return -1;
+    if (pat.empty()) {
+        return nullptr;
     }
 
-    for (int i = 0; i < active_macros; ++i) {
-        if (!prefix(macro_patterns[i], pat)) {
-            continue;
-        }
-        if (streq(macro_patterns[i], pat)) {
-            continue;
+    auto node = 0;
+    for (auto c : pat) {
+        const auto &children = this->nodes[node].children;
+        const auto it = children.find(c);
+        if (it == children.end()) {
+            return nullptr;
         }
 
-        return i;
+        node = it->second;
     }
 
-    return -1;
+    return &this->nodes[node];
 }
 
-/*
- * Find the longest macro (if any) which starts with the given pattern
+/*!
+ * @brief パターンに完全一致するマクロを探す
  */
-int macro_find_ready(concptr pat)
+int MacroTrie::find_exact(std::string_view pat) const
 {
-    int t, n = -1, s = -1;
+    const auto *node = this->find_node(pat);
+    return node ? node->macro_index : -1;
+}
 
-    if (!macro_uses[(byte)(pat[0])]) {
-        return -1;
-    }
+/*!
+ * @brief パターンで始まるマクロのうち、番号が最小のものを探す
+ */
+int MacroTrie::find_check(std::string_view pat) const
+{
+    const auto *node = this->find_node(pat);
+    return node ? min_macro_index(node->macro_index, node->min_index_below) : -1;
+}
 
-    for (int i = 0; i < active_macros; ++i) {
-        if (!prefix(pat, macro_patterns[i])) {
-            continue;
-        }
+/*!
+ * @brief パターンで始まりパターンより長いマクロのうち、番号が最小のものを探す
+ */
+int MacroTrie::find_maybe(std::string_view pat) const
+{
+    const auto *node = this->find_node(pat);
+    return node ? node->min_index_below : -1;
+}
 
-        t = macro_patterns[i].size();
-        if ((n >= 0) && (s > t)) {
-            continue;
+/*!
+ * @brief パターンの接頭辞になっているマクロのうち、最長のものを探す
+ */
+int MacroTrie::find_ready(std::string_view pat) const
+{
+    auto node = 0;
+    auto found = -1;
+    for (auto c : pat) {
+        const auto &children = this->nodes[node].children;
+        const auto it = children.find(c);
+        if (it == children.end()) {
+            break;
         }
 
-        n = i;
-        s = t;
+        node = it->second;
+        if (this->nodes[node].macro_index >= 0) {
+            found = this->nodes[node].macro_index;
+        }
     }
 
-    return n;
+    return found;
+}
+
+MacroTrie macro_trie;
+}
+
+/* Find the macro (if any) which exactly matches the given pattern */
+int macro_find_exact(concptr pat)
+{
+    return macro_trie.find_exact(pat);
+}
+
+/*
+ * Find the first macro (if any) which contains the given pattern
+ */
+int macro_find_check(concptr pat)
+{
+    return macro_trie.find_check(pat);
+}
+
+/*
+ * Find the first macro (if any) which contains the given pattern and more
+ */
+int macro_find_maybe(concptr pat)
+{
+    return macro_trie.find_maybe(pat);
+}
+
+/*
+ * Find the longest macro (if any) which starts with the given pattern
+ */
+int macro_find_ready(concptr pat)
+{
+    return macro_trie.find_ready(pat);
 }
 
 /*
@@ -133,10 +207,15 @@ errr macro_add(concptr pat, concptr act)
     int n = macro_find_exact(pat);
     if (n < 0) {
         n = active_macros++;
+        if (n >= std::ssize(macro_patterns)) {
+            macro_patterns.resize(n + 1);
+            macro_actions.resize(n + 1);
+        }
+
         macro_patterns[n] = pat;
+        macro_trie.insert(pat, n);
     }
 
     macro_actions[n] = act;
-    macro_uses[(byte)(pat[0])] = true;
     return 0;
 }
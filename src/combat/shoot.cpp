@@ -905,6 +905,7 @@ void exe_fire(PlayerType *player_ptr, INVENTORY_IDX i_idx, ItemEntity *j_ptr, SP
 
                                 m_ptr->fx = nx;
                                 m_ptr->fy = ny;
+                                floor_ptr->monster_index.move(m_idx, { oy, ox }, { ny, nx });
 
                                 update_monster(player_ptr, m_idx, true);
 
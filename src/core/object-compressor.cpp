@@ -10,6 +10,7 @@
 #include "system/player-type-definition.h"
 #include "system/redrawing-flags-updater.h"
 #include "view/display-messages.h"
+#include "window/overview-map.h"
 #include <algorithm>
 
 /*!
@@ -118,4 +119,7 @@ void compact_objects(PlayerType *player_ptr, int size)
         compact_objects_aux(floor_ptr, floor_ptr->o_max - 1, i);
         floor_ptr->o_max--;
     }
+
+    floor_ptr->o_free_list.clear();
+    OverviewMap::get_instance().invalidate();
 }
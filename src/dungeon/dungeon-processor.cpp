@@ -213,22 +213,15 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
     mproc_init(&floor);
 
     while (true) {
+        // 削除された添字は m_pop() / o_pop() で再利用するので、配列が埋まりかけた時以外は詰め直さない
         if ((floor.m_cnt + 32 > w_ptr->max_m_idx) && !is_watching) {
             compact_monsters(player_ptr, 64);
         }
 
-        if ((floor.m_cnt + 32 < floor.m_max) && !is_watching) {
-            compact_monsters(player_ptr, 0);
-        }
-
         if (floor.o_cnt + 32 > w_ptr->max_o_idx) {
             compact_objects(player_ptr, 64);
         }
 
-        if (floor.o_cnt + 32 < floor.o_max) {
-            compact_objects(player_ptr, 0);
-        }
-
         process_player(player_ptr);
         process_upkeep_with_speed(player_ptr);
         handle_stuff(player_ptr);
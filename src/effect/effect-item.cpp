@@ -282,12 +282,12 @@ bool affect_item(PlayerType *player_ptr, MONSTER_IDX who, POSITION r, POSITION y
         delete_object_idx(player_ptr, this_o_idx);
         if (is_potion) {
             (void)potion_smash_effect(player_ptr, who, y, x, bi_id);
-
-            // 薬の破壊効果によりリストの次のアイテムが破壊された可能性があるのでリストの最初から処理をやり直す
-            // 処理済みのアイテムは processed_list に登録されており、スキップされる
-            it = grid.o_idx_list.begin();
         }
 
+        // アイテムの削除でリストが詰められ、薬の破壊効果では他のアイテムも破壊された可能性があるのでリストの最初から処理をやり直す
+        // 処理済みのアイテムは processed_list に登録されており、スキップされる
+        it = grid.o_idx_list.begin();
+
         lite_spot(player_ptr, y, x);
     }
 
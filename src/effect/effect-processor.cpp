@@ -39,7 +39,29 @@
 #include "timed-effect/player-hallucination.h"
 #include "timed-effect/timed-effects.h"
 #include "util/bit-flags-calculator.h"
+#include "util/finalizer.h"
 #include "view/display-messages.h"
+#include <memory>
+#include <vector>
+
+namespace {
+int project_depth = 0;
+
+/*!
+ * @brief project() の呼び出し階層ごとに効果範囲の領域を確保する
+ * @details project() は効果の中から再帰的に呼ばれることがあるため、階層ごとに別の領域を使い回す.
+ * 呼び出し側は使い終わったら project_depth を1つ戻すこと.
+ */
+ProjectionArea &acquire_projection_area()
+{
+    static std::vector<std::unique_ptr<ProjectionArea>> areas;
+    if (project_depth >= static_cast<int>(areas.size())) {
+        areas.push_back(std::make_unique<ProjectionArea>());
+    }
+
+    return *areas[project_depth++];
+}
+}
 
 /*!
  * @brief 汎用的なビーム/ボルト/ボール系処理のルーチン Generic
@@ -69,9 +91,11 @@ ProjectResult project(PlayerType *player_ptr, const MONSTER_IDX who, POSITION ra
     bool old_hide = false;
     int path_n = 0;
     int grids = 0;
-    POSITION gx[1024]{};
-    POSITION gy[1024]{};
-    POSITION gm[32]{};
+    auto &area = acquire_projection_area();
+    const auto release = util::make_finalizer([] { project_depth--; });
+    const auto &gx = area.gx;
+    const auto &gy = area.gy;
+    const auto &gm = area.gm;
     rakubadam_p = 0;
     rakubadam_m = 0;
     monster_target_y = player_ptr->y;
@@ -109,14 +133,9 @@ ProjectResult project(PlayerType *player_ptr, const MONSTER_IDX who, POSITION ra
         flag |= PROJECT_HIDE;
     }
 
-    for (auto dist = 0; dist < 32; dist++) {
-        gm[dist] = 0;
-    }
-
+    area.clear();
     if (flag & (PROJECT_BEAM)) {
-        gy[grids] = y1;
-        gx[grids] = x1;
-        grids++;
+        area.set_grid(grids++, y1, x1);
     }
 
     switch (typ) {
@@ -164,9 +183,7 @@ ProjectResult project(PlayerType *player_ptr, const MONSTER_IDX who, POSITION ra
             }
         }
         if (flag & (PROJECT_BEAM)) {
-            gy[grids] = ny;
-            gx[grids] = nx;
-            grids++;
+            area.set_grid(grids++, ny, nx);
         }
 
         if (delay_factor > 0) {
@@ -204,8 +221,8 @@ ProjectResult project(PlayerType *player_ptr, const MONSTER_IDX who, POSITION ra
         }
     }
 
-    gm[0] = 0;
-    gm[1] = grids;
+    area.set_ring_end(0, 0);
+    area.set_ring_end(1, grids);
     project_length = 0;
 
     POSITION gm_rad = rad;
@@ -226,44 +243,39 @@ ProjectResult project(PlayerType *player_ptr, const MONSTER_IDX who, POSITION ra
          */
         if (breath) {
             flag &= ~(PROJECT_HIDE);
-            breath_shape(player_ptr, path_g, path_n, &grids, gx, gy, gm, &gm_rad, rad, y1, x1, by, bx, typ);
+            breath_shape(player_ptr, path_g, path_n, &grids, area, &gm_rad, rad, y1, x1, by, bx, typ);
         } else {
             for (auto dist = 0; dist <= rad; dist++) {
-                for (auto y = by - dist; y <= by + dist; y++) {
-                    for (auto x = bx - dist; x <= bx + dist; x++) {
-                        if (!in_bounds2(player_ptr->current_floor_ptr, y, x)) {
+                for (const auto &offset : get_ring_offsets(dist)) {
+                    const auto y = by + offset.y;
+                    const auto x = bx + offset.x;
+                    if (!in_bounds2(player_ptr->current_floor_ptr, y, x)) {
+                        continue;
+                    }
+
+                    switch (typ) {
+                    case AttributeType::LITE:
+                    case AttributeType::LITE_WEAK:
+                        if (!los(player_ptr, by, bx, y, x)) {
                             continue;
                         }
-                        if (distance(by, bx, y, x) != dist) {
+                        break;
+                    case AttributeType::DISINTEGRATE:
+                        if (!in_disintegration_range(player_ptr->current_floor_ptr, by, bx, y, x)) {
                             continue;
                         }
-
-                        switch (typ) {
-                        case AttributeType::LITE:
-                        case AttributeType::LITE_WEAK:
-                            if (!los(player_ptr, by, bx, y, x)) {
-                                continue;
-                            }
-                            break;
-                        case AttributeType::DISINTEGRATE:
-                            if (!in_disintegration_range(player_ptr->current_floor_ptr, by, bx, y, x)) {
-                                continue;
-                            }
-                            break;
-                        default:
-                            if (!projectable(player_ptr, by, bx, y, x)) {
-                                continue;
-                            }
-                            break;
+                        break;
+                    default:
+                        if (!projectable(player_ptr, by, bx, y, x)) {
+                            continue;
                         }
-
-                        gy[grids] = y;
-                        gx[grids] = x;
-                        grids++;
+                        break;
                     }
+
+                    area.set_grid(grids++, y, x);
                 }
 
-                gm[dist + 1] = grids;
+                area.set_ring_end(dist + 1, grids);
             }
         }
     }
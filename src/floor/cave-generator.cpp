@@ -3,6 +3,7 @@
 #include "dungeon/quest-monster-placer.h"
 #include "floor/dungeon-tunnel-util.h"
 #include "floor/floor-allocation-types.h"
+#include "floor/floor-generation-profiler.h"
 #include "floor/floor-streams.h"
 #include "floor/geometry.h"
 #include "floor/object-allocator.h"
@@ -113,9 +114,12 @@ static bool decide_tunnel_planned_site(PlayerType *player_ptr, dun_data_type *dd
 {
     dd_ptr->tunn_n = 0;
     dd_ptr->wall_n = 0;
+    auto &profiler = FloorGenerationProfiler::get_instance();
     if (randint1(player_ptr->current_floor_ptr->dun_level) > d_ptr->tunnel_percent) {
-        (void)build_tunnel2(player_ptr, dd_ptr, dd_ptr->cent[i].x, dd_ptr->cent[i].y, dd_ptr->tunnel_x, dd_ptr->tunnel_y, 2, 2);
-    } else if (!build_tunnel(player_ptr, dd_ptr, dt_ptr, dd_ptr->cent[i].y, dd_ptr->cent[i].x, dd_ptr->tunnel_y, dd_ptr->tunnel_x)) {
+        (void)profiler.measure("build_tunnel2", [&] {
+            return build_tunnel2(player_ptr, dd_ptr, dd_ptr->cent[i].x, dd_ptr->cent[i].y, dd_ptr->tunnel_x, dd_ptr->tunnel_y, 2, 2);
+        });
+    } else if (!profiler.measure("build_tunnel", [&] { return build_tunnel(player_ptr, dd_ptr, dt_ptr, dd_ptr->cent[i].y, dd_ptr->cent[i].x, dd_ptr->tunnel_y, dd_ptr->tunnel_x); })) {
         dd_ptr->tunnel_fail_count++;
     }
 
@@ -201,24 +205,24 @@ static void make_only_tunnel_points(FloorType *floor_ptr, dun_data_type *dd_ptr)
 static bool make_one_floor(PlayerType *player_ptr, dun_data_type *dd_ptr, dungeon_type *d_ptr)
 {
     auto *floor_ptr = player_ptr->current_floor_ptr;
-
+    auto &profiler = FloorGenerationProfiler::get_instance();
     if (floor_ptr->get_dungeon_definition().flags.has(DungeonFeatureType::NO_ROOM)) {
         make_only_tunnel_points(floor_ptr, dd_ptr);
     } else {
-        if (!generate_rooms(player_ptr, dd_ptr)) {
+        if (!profiler.measure("rooms", [&] { return generate_rooms(player_ptr, dd_ptr); })) {
             *dd_ptr->why = _("部屋群の生成に失敗", "Failed to generate rooms");
             return false;
         }
     }
 
-    place_cave_contents(player_ptr, dd_ptr, d_ptr);
+    profiler.measure("cave_contents", [&] { place_cave_contents(player_ptr, dd_ptr, d_ptr); });
     dt_type tmp_dt;
     dt_type *dt_ptr = initialize_dt_type(&tmp_dt);
-    if (!make_centers(player_ptr, dd_ptr, d_ptr, dt_ptr)) {
+    if (!profiler.measure("tunnels", [&] { return make_centers(player_ptr, dd_ptr, d_ptr, dt_ptr); })) {
         return false;
     }
 
-    make_doors(player_ptr, dd_ptr, dt_ptr);
+    profiler.measure("doors", [&] { make_doors(player_ptr, dd_ptr, dt_ptr); });
     if (!alloc_stairs(player_ptr, feat_down_stair, rand_range(3, 4), 3)) {
         *dd_ptr->why = _("下り階段生成に失敗", "Failed to generate down stairs.");
         return false;
@@ -440,20 +444,21 @@ bool cave_gen(PlayerType *player_ptr, concptr *why)
         msg_print_wizard(player_ptr, CHEAT_DUNGEON, _("アリーナレベルを生成。", "Arena level."));
     }
 
+    auto &profiler = FloorGenerationProfiler::get_instance();
     check_arena_floor(player_ptr, dd_ptr);
-    gen_caverns_and_lakes(player_ptr, d_ptr, dd_ptr);
-    if (!switch_making_floor(player_ptr, dd_ptr, d_ptr)) {
+    profiler.measure("caverns_and_lakes", [&] { gen_caverns_and_lakes(player_ptr, d_ptr, dd_ptr); });
+    if (!profiler.measure("layout", [&] { return switch_making_floor(player_ptr, dd_ptr, d_ptr); })) {
         return false;
     }
 
-    make_aqua_streams(player_ptr, dd_ptr, d_ptr);
+    profiler.measure("streamers", [&] { make_aqua_streams(player_ptr, dd_ptr, d_ptr); });
     make_perm_walls(player_ptr);
-    if (!check_place_necessary_objects(player_ptr, dd_ptr)) {
+    if (!profiler.measure("player_and_quest_monsters", [&] { return check_place_necessary_objects(player_ptr, dd_ptr); })) {
         return false;
     }
 
     decide_dungeon_data_allocation(player_ptr, dd_ptr, d_ptr);
-    if (!allocate_dungeon_data(player_ptr, dd_ptr, d_ptr)) {
+    if (!profiler.measure("monsters_and_objects", [&] { return allocate_dungeon_data(player_ptr, dd_ptr, d_ptr); })) {
         return false;
     }
 
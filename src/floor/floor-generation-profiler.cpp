@@ -0,0 +1,217 @@
+/*!
+ * @brief フロア生成の計測
+ * @details フロアに入るまでに時間の掛かるダンジョンや、生成のやり直しが多い原因を調べるために使う.
+ * 計測結果はデバッグコマンドまたは --profile-floors オプションでJSONとして書き出す.
+ */
+
+#include "floor/floor-generation-profiler.h"
+#include "dungeon/quest.h"
+#include "external-lib/include-json.h"
+#include "floor/floor-generator.h"
+#include "io/files-util.h"
+#include "system/dungeon-info.h"
+#include "system/floor-type-definition.h"
+#include "system/player-type-definition.h"
+#include "util/angband-files.h"
+#include "util/finalizer.h"
+#include <algorithm>
+#include <fstream>
+
+namespace {
+double to_milliseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+}
+
+FloorGenerationProfiler FloorGenerationProfiler::instance{};
+
+FloorGenerationProfiler &FloorGenerationProfiler::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief 1フロアの生成の計測を開始する
+ * @param dungeon_id ダンジョンID
+ * @param level 階層
+ */
+void FloorGenerationProfiler::begin_floor(short dungeon_id, int level)
+{
+    this->current_key = std::make_pair(dungeon_id, level);
+    this->floor_start = std::chrono::steady_clock::now();
+}
+
+/*!
+ * @brief 1フロアの生成の計測を終了する
+ */
+void FloorGenerationProfiler::end_floor()
+{
+    if (!this->current_key) {
+        return;
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - this->floor_start;
+    auto &floor_stats = this->stats[*this->current_key];
+    floor_stats.floors++;
+    floor_stats.total += elapsed;
+    floor_stats.max = std::max(floor_stats.max, elapsed);
+    this->current_key = std::nullopt;
+}
+
+/*!
+ * @brief フロア生成の試行を1回記録する
+ * @param failure_reason やり直しの理由. 成功した試行ならば空文字列
+ */
+void FloorGenerationProfiler::record_attempt(std::string_view failure_reason)
+{
+    if (!this->current_key) {
+        return;
+    }
+
+    auto &floor_stats = this->stats[*this->current_key];
+    floor_stats.attempts++;
+    if (failure_reason.empty()) {
+        return;
+    }
+
+    auto it = floor_stats.failure_reasons.find(failure_reason);
+    if (it == floor_stats.failure_reasons.end()) {
+        it = floor_stats.failure_reasons.emplace(failure_reason, 0).first;
+    }
+
+    it->second++;
+}
+
+/*!
+ * @brief 処理区間の所要時間を記録する
+ * @param phase 区間名
+ * @param elapsed 所要時間
+ * @param is_successful 処理が成功したならtrue
+ * @details フロア生成中でなければ何もしない
+ */
+void FloorGenerationProfiler::record_phase(std::string_view phase, std::chrono::steady_clock::duration elapsed, bool is_successful)
+{
+    if (!this->current_key) {
+        return;
+    }
+
+    auto &phases = this->stats[*this->current_key].phases;
+    auto it = phases.find(phase);
+    if (it == phases.end()) {
+        it = phases.emplace(phase, PhaseStats{}).first;
+    }
+
+    auto &phase_stats = it->second;
+    phase_stats.calls++;
+    if (!is_successful) {
+        phase_stats.failures++;
+    }
+
+    phase_stats.total += elapsed;
+    phase_stats.max = std::max(phase_stats.max, elapsed);
+}
+
+void FloorGenerationProfiler::clear()
+{
+    this->stats.clear();
+}
+
+/*!
+ * @brief 計測用の一括生成中かを返す
+ * @details 一括生成中はやり直しのメッセージを表示しない
+ */
+bool FloorGenerationProfiler::is_batch_running() const
+{
+    return this->is_batch;
+}
+
+void FloorGenerationProfiler::set_batch_running(bool is_running)
+{
+    this->is_batch = is_running;
+}
+
+/*!
+ * @brief 計測結果をJSONに変換する
+ * @return ダンジョン・階層ごとの計測結果の配列を "floors" に持つJSON文字列 (時間の単位はミリ秒)
+ */
+std::string FloorGenerationProfiler::to_json() const
+{
+    auto floors = nlohmann::json::array();
+    for (const auto &[key, floor_stats] : this->stats) {
+        const auto &[dungeon_id, level] = key;
+        nlohmann::json phases;
+        for (const auto &[phase, phase_stats] : floor_stats.phases) {
+            phases[phase] = {
+                { "calls", phase_stats.calls },
+                { "failures", phase_stats.failures },
+                { "total_ms", to_milliseconds(phase_stats.total) },
+                { "max_ms", to_milliseconds(phase_stats.max) },
+            };
+        }
+
+        const auto is_valid_dungeon = (dungeon_id >= 0) && (dungeon_id < static_cast<short>(dungeons_info.size()));
+        floors.push_back({
+            { "dungeon_id", dungeon_id },
+            { "dungeon", is_valid_dungeon ? dungeons_info[dungeon_id].name : "" },
+            { "level", level },
+            { "floors", floor_stats.floors },
+            { "attempts", floor_stats.attempts },
+            { "retries", floor_stats.attempts - floor_stats.floors },
+            { "total_ms", to_milliseconds(floor_stats.total) },
+            { "max_ms", to_milliseconds(floor_stats.max) },
+            { "failure_reasons", floor_stats.failure_reasons },
+            { "phases", phases },
+        });
+    }
+
+    nlohmann::json json;
+    json["floors"] = floors;
+    return json.dump(2, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+/*!
+ * @brief 計測結果をユーザディレクトリにJSONファイルとして保存する
+ * @param filename ファイル名
+ * @return 保存に成功したらtrue
+ */
+bool FloorGenerationProfiler::save(std::string_view filename) const
+{
+    const auto &path = path_build(ANGBAND_DIR_USER, filename);
+    std::ofstream ofs(path);
+    if (!ofs) {
+        return false;
+    }
+
+    ofs << this->to_json() << '\n';
+    return static_cast<bool>(ofs);
+}
+
+/*!
+ * @brief 計測のために全ダンジョンのフロアを一括生成する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param floors_per_dungeon ダンジョン1つあたりの生成数. 階層は最浅層から最深層まで均等に割り振る
+ * @details 現在のフロアは失われるので、呼び出し側で作り直すこと
+ */
+void generate_floors_for_profiling(PlayerType *player_ptr, int floors_per_dungeon)
+{
+    auto &profiler = FloorGenerationProfiler::get_instance();
+    profiler.set_batch_running(true);
+    const auto finalizer = util::make_finalizer([&profiler] { profiler.set_batch_running(false); });
+    auto &floor = *player_ptr->current_floor_ptr;
+    floor.quest_number = QuestId::NONE;
+    floor.inside_arena = false;
+    player_ptr->wild_mode = false;
+    for (const auto &dungeon : dungeons_info) {
+        if ((dungeon.idx == 0) || dungeon.name.empty() || (dungeon.maxdepth <= 0)) {
+            continue;
+        }
+
+        const auto span = dungeon.maxdepth - dungeon.mindepth;
+        for (auto i = 0; i < floors_per_dungeon; i++) {
+            floor.set_dungeon_index(dungeon.idx);
+            floor.dun_level = dungeon.mindepth + span * i / std::max(floors_per_dungeon - 1, 1);
+            generate_floor(player_ptr);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+class PlayerType;
+
+/*!
+ * @brief フロア生成の計測結果を集計するクラス
+ * @details ダンジョンと階層の組ごとに、生成回数・やり直し回数とその理由、処理区間ごとの所要時間を記録する.
+ * 計測区間は measure() で囲み、戻り値がboolならばfalseを失敗として数える.
+ */
+class FloorGenerationProfiler {
+public:
+    FloorGenerationProfiler(const FloorGenerationProfiler &) = delete;
+    FloorGenerationProfiler(FloorGenerationProfiler &&) = delete;
+    FloorGenerationProfiler &operator=(const FloorGenerationProfiler &) = delete;
+    FloorGenerationProfiler &operator=(FloorGenerationProfiler &&) = delete;
+    ~FloorGenerationProfiler() = default;
+
+    static FloorGenerationProfiler &get_instance();
+    void begin_floor(short dungeon_id, int level);
+    void end_floor();
+    void record_attempt(std::string_view failure_reason = "");
+    void record_phase(std::string_view phase, std::chrono::steady_clock::duration elapsed, bool is_successful);
+    void clear();
+    bool is_batch_running() const;
+    void set_batch_running(bool is_running);
+    std::string to_json() const;
+    bool save(std::string_view filename) const;
+
+    /*!
+     * @brief 処理を1区間として計測する
+     * @param phase 区間名
+     * @param func 計測する処理
+     * @return func の戻り値
+     */
+    template <typename Func>
+    auto measure(std::string_view phase, Func &&func) -> decltype(func())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        if constexpr (std::is_void_v<decltype(func())>) {
+            func();
+            this->record_phase(phase, std::chrono::steady_clock::now() - start, true);
+        } else {
+            auto result = func();
+            this->record_phase(phase, std::chrono::steady_clock::now() - start, static_cast<bool>(result));
+            return result;
+        }
+    }
+
+private:
+    FloorGenerationProfiler() = default;
+
+    struct PhaseStats {
+        int calls = 0;
+        int failures = 0;
+        std::chrono::steady_clock::duration total{};
+        std::chrono::steady_clock::duration max{};
+    };
+
+    struct FloorStats {
+        int floors = 0;
+        int attempts = 0;
+        std::chrono::steady_clock::duration total{};
+        std::chrono::steady_clock::duration max{};
+        std::map<std::string, int, std::less<>> failure_reasons;
+        std::map<std::string, PhaseStats, std::less<>> phases;
+    };
+
+    static FloorGenerationProfiler instance;
+    std::map<std::pair<short, int>, FloorStats> stats;
+    std::optional<std::pair<short, int>> current_key;
+    std::chrono::steady_clock::time_point floor_start;
+    bool is_batch = false;
+};
+
+void generate_floors_for_profiling(PlayerType *player_ptr, int floors_per_dungeon);
@@ -14,6 +14,7 @@
 #include "dungeon/quest.h"
 #include "floor/cave-generator.h"
 #include "floor/floor-events.h"
+#include "floor/floor-generation-profiler.h"
 #include "floor/floor-generator.h"
 #include "floor/floor-save.h" //!< @todo precalc_cur_num_of_pet() が依存している、違和感.
 #include "floor/floor-util.h"
@@ -365,6 +366,7 @@ void clear_cave(PlayerType *player_ptr)
     std::fill_n(floor_ptr->o_list.begin(), floor_ptr->o_max, ItemEntity{});
     floor_ptr->o_max = 1;
     floor_ptr->o_cnt = 0;
+    floor_ptr->o_free_list.clear();
 
     for (auto &[r_idx, r_ref] : monraces_info) {
         r_ref.cur_num = 0;
@@ -373,11 +375,14 @@ void clear_cave(PlayerType *player_ptr)
     std::fill_n(floor_ptr->m_list.begin(), floor_ptr->m_max, MonsterEntity{});
     floor_ptr->m_max = 1;
     floor_ptr->m_cnt = 0;
+    floor_ptr->m_free_list.clear();
     for (int i = 0; i < MAX_MTIMED; i++) {
         floor_ptr->mproc_max[i] = 0;
     }
 
     precalc_cur_num_of_pet(player_ptr);
+    floor_ptr->teleport_destinations.invalidate();
+    floor_ptr->monster_index.invalidate();
     for (POSITION y = 0; y < MAX_HGT; y++) {
         for (POSITION x = 0; x < MAX_WID; x++) {
             auto *g_ptr = &floor_ptr->grid_array[y][x];
@@ -494,6 +499,8 @@ static bool floor_is_connected(const FloorType *const floor_ptr, const IsWallFun
 void generate_floor(PlayerType *player_ptr)
 {
     auto *floor_ptr = player_ptr->current_floor_ptr;
+    auto &profiler = FloorGenerationProfiler::get_instance();
+    profiler.begin_floor(floor_ptr->dungeon_idx, floor_ptr->dun_level);
     set_floor_and_wall(floor_ptr->dungeon_idx);
     for (int num = 0; true; num++) {
         bool okay = true;
@@ -513,7 +520,7 @@ void generate_floor(PlayerType *player_ptr)
                 wilderness_gen(player_ptr);
             }
         } else {
-            okay = level_gen(player_ptr, &why);
+            okay = profiler.measure("level_gen", [&] { return level_gen(player_ptr, &why); });
         }
 
         if (floor_ptr->o_max >= w_ptr->max_o_idx) {
@@ -529,7 +536,7 @@ void generate_floor(PlayerType *player_ptr)
         // 地上、荒野マップ、クエストでは連結性判定は行わない。
         // TODO: 本来はダンジョン生成アルゴリズム自身で連結性を保証するのが理想ではある。
         const bool check_conn = okay && floor_ptr->dun_level > 0 && !floor_ptr->is_in_quest();
-        if (check_conn && !floor_is_connected(floor_ptr, is_permanent_blocker)) {
+        if (check_conn && !profiler.measure("connectivity_check", [&] { return floor_is_connected(floor_ptr, is_permanent_blocker); })) {
             // 一定回数試しても連結にならないなら諦める。
             if (num >= 1000) {
                 plog("cannot generate connected floor. giving up...");
@@ -539,11 +546,12 @@ void generate_floor(PlayerType *player_ptr)
             }
         }
 
+        profiler.record_attempt((okay || !why) ? "" : why);
         if (okay) {
             break;
         }
 
-        if (why) {
+        if (why && !profiler.is_batch_running()) {
             msg_format(_("生成やり直し(%s)", "Generation restarted (%s)"), why);
         }
 
@@ -554,4 +562,5 @@ void generate_floor(PlayerType *player_ptr)
     glow_deep_lava_and_bldg(player_ptr);
     player_ptr->enter_dungeon = false;
     wipe_generate_random_floor_flags(floor_ptr);
+    profiler.end_floor();
 }
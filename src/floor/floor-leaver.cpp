@@ -242,6 +242,7 @@ static void get_out_monster(PlayerType *player_ptr)
         floor_ptr->grid_array[ny][nx].m_idx = m_idx;
         m_ptr->fy = ny;
         m_ptr->fx = nx;
+        floor_ptr->monster_index.move(m_idx, { oy, ox }, { ny, nx });
         return;
     }
 }
@@ -183,6 +183,21 @@ bool make_gold(PlayerType *player_ptr, ItemEntity *j_ptr)
     return true;
 }
 
+/*!
+ * @brief 削除したアイテムの添字を空きとして戻す
+ * @param floor_ptr 現在フロアへの参照ポインタ
+ * @param o_idx 削除したアイテムのID
+ * @details 末尾が空きになった分だけ o_max を縮める. 縮めた範囲の添字が空きリストに残っていても o_pop() で読み飛ばされる
+ */
+static void release_object_idx(FloorType *floor_ptr, OBJECT_IDX o_idx)
+{
+    floor_ptr->o_cnt--;
+    floor_ptr->o_free_list.push_back(o_idx);
+    while ((floor_ptr->o_max > 1) && !floor_ptr->o_list[floor_ptr->o_max - 1].is_valid()) {
+        floor_ptr->o_max--;
+    }
+}
+
 /*!
  * @brief フロア中のアイテムを全て削除する / Deletes all objects at given location
  * Delete a dungeon object
@@ -203,7 +218,7 @@ void delete_all_items_from_floor(PlayerType *player_ptr, POSITION y, POSITION x)
         ItemEntity *o_ptr;
         o_ptr = &floor_ptr->o_list[this_o_idx];
         o_ptr->wipe();
-        floor_ptr->o_cnt--;
+        release_object_idx(floor_ptr, this_o_idx);
     }
 
     g_ptr->o_idx_list.clear();
@@ -284,7 +299,7 @@ void delete_object_idx(PlayerType *player_ptr, OBJECT_IDX o_idx)
     }
 
     j_ptr->wipe();
-    floor_ptr->o_cnt--;
+    release_object_idx(floor_ptr, o_idx);
     static constexpr auto flags = {
         SubWindowRedrawingFlag::FLOOR_ITEMS,
         SubWindowRedrawingFlag::FOUND_ITEMS,
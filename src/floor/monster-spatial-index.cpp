@@ -0,0 +1,163 @@
+/*!
+ * @brief モンスターの位置の索引
+ * @details 周囲のモンスターを探す度に m_list 全体を調べる代わりに、範囲と重なる区画に登録されたモンスターだけを調べる.
+ */
+
+#include "floor/monster-spatial-index.h"
+#include "floor/geometry.h"
+#include "system/floor-type-definition.h"
+#include "system/monster-entity.h"
+#include <algorithm>
+
+namespace {
+constexpr auto REGION_SIZE = 8; //!< 区画の一辺のグリッド数
+}
+
+/*!
+ * @brief 索引を破棄する
+ * @details フロアを作り直した時やモンスターのIDが振り直された時に呼ぶ. 次に使われた時に作り直される.
+ */
+void MonsterSpatialIndex::invalidate()
+{
+    this->is_built = false;
+    this->regions.clear();
+}
+
+/*!
+ * @brief 配置されたモンスターを索引に加える
+ * @param m_idx モンスターID
+ * @param pos 配置された座標
+ */
+void MonsterSpatialIndex::add(MONSTER_IDX m_idx, const Pos2D &pos)
+{
+    if (!this->is_built || !this->contains(pos)) {
+        return;
+    }
+
+    this->regions[this->get_region_index(pos)].push_back(m_idx);
+}
+
+/*!
+ * @brief 削除されたモンスターを索引から除く
+ * @param m_idx モンスターID
+ * @param pos 削除される前にいた座標
+ */
+void MonsterSpatialIndex::remove(MONSTER_IDX m_idx, const Pos2D &pos)
+{
+    if (!this->is_built || !this->contains(pos)) {
+        return;
+    }
+
+    auto &region = this->regions[this->get_region_index(pos)];
+    const auto it = std::find(region.begin(), region.end(), m_idx);
+    if (it == region.end()) {
+        return;
+    }
+
+    *it = region.back();
+    region.pop_back();
+}
+
+/*!
+ * @brief 移動したモンスターを索引に反映する
+ * @param m_idx モンスターID
+ * @param from 移動元の座標
+ * @param to 移動先の座標
+ */
+void MonsterSpatialIndex::move(MONSTER_IDX m_idx, const Pos2D &from, const Pos2D &to)
+{
+    if (!this->is_built || (this->contains(from) && this->contains(to) && (this->get_region_index(from) == this->get_region_index(to)))) {
+        return;
+    }
+
+    this->remove(m_idx, from);
+    this->add(m_idx, to);
+}
+
+/*!
+ * @brief 矩形の範囲内にいるモンスターを集める
+ * @param floor 現在のフロア
+ * @param top_left 範囲の左上の座標
+ * @param bottom_right 範囲の右下の座標
+ * @return 範囲内にいるモンスターのID. m_list を先頭から走査した場合と同じ順に並ぶ
+ */
+std::vector<MONSTER_IDX> MonsterSpatialIndex::collect_in_rect(const FloorType &floor, const Pos2D &top_left, const Pos2D &bottom_right)
+{
+    if (!this->is_built || (this->height != floor.height) || (this->width != floor.width)) {
+        this->build(floor);
+    }
+
+    const auto top = std::max(0, top_left.y);
+    const auto bottom = std::min(floor.height - 1, bottom_right.y);
+    const auto left = std::max(0, top_left.x);
+    const auto right = std::min(floor.width - 1, bottom_right.x);
+    std::vector<MONSTER_IDX> m_idxs;
+    if ((top > bottom) || (left > right)) {
+        return m_idxs;
+    }
+
+    for (auto region_y = top / REGION_SIZE; region_y <= bottom / REGION_SIZE; region_y++) {
+        for (auto region_x = left / REGION_SIZE; region_x <= right / REGION_SIZE; region_x++) {
+            for (const auto m_idx : this->regions[region_y * this->region_cols + region_x]) {
+                const auto &monster = floor.m_list[m_idx];
+                if (!monster.is_valid()) {
+                    continue;
+                }
+
+                if ((monster.fy < top) || (monster.fy > bottom) || (monster.fx < left) || (monster.fx > right)) {
+                    continue;
+                }
+
+                m_idxs.push_back(m_idx);
+            }
+        }
+    }
+
+    std::sort(m_idxs.begin(), m_idxs.end());
+    m_idxs.erase(std::unique(m_idxs.begin(), m_idxs.end()), m_idxs.end());
+    return m_idxs;
+}
+
+/*!
+ * @brief 指定地点から一定距離内にいるモンスターを集める
+ * @param floor 現在のフロア
+ * @param center 中心の座標
+ * @param range 最大距離 (distance() による)
+ * @return 範囲内にいるモンスターのID. m_list を先頭から走査した場合と同じ順に並ぶ
+ */
+std::vector<MONSTER_IDX> MonsterSpatialIndex::collect_in_range(const FloorType &floor, const Pos2D &center, POSITION range)
+{
+    auto m_idxs = this->collect_in_rect(floor, { center.y - range, center.x - range }, { center.y + range, center.x + range });
+    const auto is_out_of_range = [&floor, &center, range](MONSTER_IDX m_idx) {
+        const auto &monster = floor.m_list[m_idx];
+        return distance(center.y, center.x, monster.fy, monster.fx) > range;
+    };
+    m_idxs.erase(std::remove_if(m_idxs.begin(), m_idxs.end(), is_out_of_range), m_idxs.end());
+    return m_idxs;
+}
+
+void MonsterSpatialIndex::build(const FloorType &floor)
+{
+    this->height = floor.height;
+    this->width = floor.width;
+    this->region_cols = (floor.width + REGION_SIZE - 1) / REGION_SIZE;
+    const auto region_rows = (floor.height + REGION_SIZE - 1) / REGION_SIZE;
+    this->regions.assign(region_rows * this->region_cols, {});
+    this->is_built = true;
+    for (MONSTER_IDX m_idx = 1; m_idx < floor.m_max; m_idx++) {
+        const auto &monster = floor.m_list[m_idx];
+        if (monster.is_valid()) {
+            this->add(m_idx, { monster.fy, monster.fx });
+        }
+    }
+}
+
+bool MonsterSpatialIndex::contains(const Pos2D &pos) const
+{
+    return (pos.y >= 0) && (pos.x >= 0) && (pos.y < this->height) && (pos.x < this->width);
+}
+
+int MonsterSpatialIndex::get_region_index(const Pos2D &pos) const
+{
+    return (pos.y / REGION_SIZE) * this->region_cols + (pos.x / REGION_SIZE);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "system/angband.h"
+#include "util/point-2d.h"
+#include <vector>
+
+class FloorType;
+
+/*!
+ * @brief モンスターの位置の索引
+ * @details フロアを格子状に区切った区画ごとに、そこにいるモンスターのIDを保持する.
+ * 索引は最初に使われた時に m_list から作り、以降はモンスターの配置・移動・削除に合わせて更新する.
+ * m_list の添字が変わる圧縮やフロアの作り直しの際は invalidate() で破棄する.
+ * 取り出す時には m_list の実際の位置で範囲を判定するので、削除済のモンスターが残っていても結果には含まれない.
+ */
+class MonsterSpatialIndex {
+public:
+    void invalidate();
+    void add(MONSTER_IDX m_idx, const Pos2D &pos);
+    void remove(MONSTER_IDX m_idx, const Pos2D &pos);
+    void move(MONSTER_IDX m_idx, const Pos2D &from, const Pos2D &to);
+    std::vector<MONSTER_IDX> collect_in_rect(const FloorType &floor, const Pos2D &top_left, const Pos2D &bottom_right);
+    std::vector<MONSTER_IDX> collect_in_range(const FloorType &floor, const Pos2D &center, POSITION range);
+
+private:
+    bool is_built = false;
+    POSITION height = 0;
+    POSITION width = 0;
+    int region_cols = 0;
+    std::vector<std::vector<MONSTER_IDX>> regions;
+
+    void build(const FloorType &floor);
+    bool contains(const Pos2D &pos) const;
+    int get_region_index(const Pos2D &pos) const;
+};
@@ -0,0 +1,122 @@
+/*!
+ * @brief テレポート先候補の索引
+ * @details テレポートの度に周囲の矩形全体を調べる代わりに、範囲と重なる区画に登録されたグリッドだけを調べる.
+ */
+
+#include "floor/teleport-destination-index.h"
+#include "floor/geometry.h"
+#include "grid/feature-flag-types.h"
+#include "system/floor-type-definition.h"
+#include "system/grid-type-definition.h"
+#include "system/terrain-type-definition.h"
+#include <algorithm>
+
+namespace {
+constexpr auto REGION_SIZE = 8; //!< 区画の一辺のグリッド数
+
+bool is_teleportable_terrain(const FloorType &floor, const Pos2D &pos)
+{
+    return floor.get_grid(pos).get_terrain().flags.has(TerrainCharacteristics::TELEPORTABLE);
+}
+}
+
+/*!
+ * @brief 索引を破棄する
+ * @details フロアを作り直した時に呼ぶ. 次に使われた時に作り直される.
+ */
+void TeleportDestinationIndex::invalidate()
+{
+    this->is_built = false;
+    this->regions.clear();
+}
+
+/*!
+ * @brief 地形が変わったグリッドを索引に反映する
+ * @param floor 現在のフロア
+ * @param pos 地形が変わったグリッド
+ */
+void TeleportDestinationIndex::update(const FloorType &floor, const Pos2D &pos)
+{
+    if (!this->is_built || (pos.y <= 0) || (pos.x <= 0) || (pos.y >= this->height - 1) || (pos.x >= this->width - 1)) {
+        return;
+    }
+
+    auto &region = this->regions[this->get_region_index(pos)];
+    const auto it = std::find(region.begin(), region.end(), pos);
+    const auto is_indexed = it != region.end();
+    const auto is_teleportable = is_teleportable_terrain(floor, pos);
+    if (is_indexed && !is_teleportable) {
+        region.erase(it);
+    } else if (!is_indexed && is_teleportable) {
+        region.push_back(pos);
+    }
+}
+
+/*!
+ * @brief 指定地点から一定距離内のテレポート先候補を集める
+ * @param floor 現在のフロア
+ * @param center 中心の座標
+ * @param max_distance 最大距離
+ * @param is_candidate 地形以外の条件 (モンスターの有無など) を判定する関数
+ * @return フロアの外周を除く範囲内の候補. 矩形を上の行から順に走査した場合と同じ順に並ぶ
+ */
+std::vector<Pos2D> TeleportDestinationIndex::collect(const FloorType &floor, const Pos2D &center, POSITION max_distance, const std::function<bool(const Pos2D &)> &is_candidate)
+{
+    if (!this->is_built || (this->height != floor.height) || (this->width != floor.width)) {
+        this->build(floor);
+    }
+
+    const auto top = std::max(1, center.y - max_distance);
+    const auto bottom = std::min(floor.height - 2, center.y + max_distance);
+    const auto left = std::max(1, center.x - max_distance);
+    const auto right = std::min(floor.width - 2, center.x + max_distance);
+    std::vector<Pos2D> candidates;
+    if ((top > bottom) || (left > right)) {
+        return candidates;
+    }
+
+    for (auto region_y = top / REGION_SIZE; region_y <= bottom / REGION_SIZE; region_y++) {
+        for (auto region_x = left / REGION_SIZE; region_x <= right / REGION_SIZE; region_x++) {
+            for (const auto &pos : this->regions[region_y * this->region_cols + region_x]) {
+                if ((pos.y < top) || (pos.y > bottom) || (pos.x < left) || (pos.x > right)) {
+                    continue;
+                }
+
+                if (distance(center.y, center.x, pos.y, pos.x) > max_distance) {
+                    continue;
+                }
+
+                if (is_candidate(pos)) {
+                    candidates.push_back(pos);
+                }
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) { return (a.y != b.y) ? (a.y < b.y) : (a.x < b.x); });
+    return candidates;
+}
+
+void TeleportDestinationIndex::build(const FloorType &floor)
+{
+    this->height = floor.height;
+    this->width = floor.width;
+    this->region_cols = (floor.width + REGION_SIZE - 1) / REGION_SIZE;
+    const auto region_rows = (floor.height + REGION_SIZE - 1) / REGION_SIZE;
+    this->regions.assign(region_rows * this->region_cols, {});
+    for (auto y = 1; y < floor.height - 1; y++) {
+        for (auto x = 1; x < floor.width - 1; x++) {
+            const Pos2D pos(y, x);
+            if (is_teleportable_terrain(floor, pos)) {
+                this->regions[this->get_region_index(pos)].push_back(pos);
+            }
+        }
+    }
+
+    this->is_built = true;
+}
+
+int TeleportDestinationIndex::get_region_index(const Pos2D &pos) const
+{
+    return (pos.y / REGION_SIZE) * this->region_cols + (pos.x / REGION_SIZE);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "system/angband.h"
+#include "util/point-2d.h"
+#include <functional>
+#include <vector>
+
+class FloorType;
+
+/*!
+ * @brief テレポート先になり得るグリッドの索引
+ * @details 地形がテレポート可能なグリッドを、フロアを格子状に区切った区画ごとに保持する.
+ * モンスターやアイテムの有無・プレイヤーの状態など変化の激しい条件は、候補を取り出す時に判定する.
+ * 索引は最初に使われた時に作り、以降は cave_set_feat() による地形の変化に合わせて更新する.
+ */
+class TeleportDestinationIndex {
+public:
+    void invalidate();
+    void update(const FloorType &floor, const Pos2D &pos);
+    std::vector<Pos2D> collect(const FloorType &floor, const Pos2D &center, POSITION max_distance, const std::function<bool(const Pos2D &)> &is_candidate);
+
+private:
+    bool is_built = false;
+    POSITION height = 0;
+    POSITION width = 0;
+    int region_cols = 0;
+    std::vector<std::vector<Pos2D>> regions;
+
+    void build(const FloorType &floor);
+    int get_region_index(const Pos2D &pos) const;
+};
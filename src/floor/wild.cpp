@@ -15,6 +15,7 @@
 #include "dungeon/quest.h"
 #include "floor/cave.h"
 #include "floor/floor-town.h"
+#include "floor/wilderness-tile-cache.h"
 #include "game-option/birth-options.h"
 #include "game-option/map-screen-options.h"
 #include "grid/feature.h"
@@ -326,10 +327,16 @@ static void generate_area(PlayerType *player_ptr, POSITION y, POSITION x, bool i
         if (!is_corner && !is_border) {
             player_ptr->visit |= (1UL << (player_ptr->town_num - 1));
         }
+    } else if (is_corner) {
+        generate_wilderness_area(floor_ptr, wilderness[y][x].terrain, wilderness[y][x].seed, true);
     } else {
-        int terrain = wilderness[y][x].terrain;
-        uint32_t seed = wilderness[y][x].seed;
-        generate_wilderness_area(floor_ptr, terrain, seed, is_corner);
+        const auto terrain = wilderness[y][x].terrain;
+        const auto seed = wilderness[y][x].seed;
+        auto &tile_cache = WildernessTileCache::get_instance();
+        if (!tile_cache.load(*floor_ptr, { y, x }, terrain, seed)) {
+            generate_wilderness_area(floor_ptr, terrain, seed, false);
+            tile_cache.store(*floor_ptr, { y, x }, terrain, seed);
+        }
     }
 
     if (!is_corner && !wilderness[y][x].town) {
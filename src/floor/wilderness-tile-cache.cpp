@@ -0,0 +1,69 @@
+#include "floor/wilderness-tile-cache.h"
+#include "system/floor-type-definition.h"
+#include "system/grid-type-definition.h"
+#include <algorithm>
+
+WildernessTileCache WildernessTileCache::instance{};
+
+WildernessTileCache &WildernessTileCache::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief キャッシュにあるタイルの地形をフロアに書き込む
+ * @param floor 書き込み先のフロア
+ * @param wild_pos タイルの広域座標
+ * @param terrain タイルの地形種別
+ * @param seed タイルの乱数シード
+ * @return キャッシュにあったらtrue
+ */
+bool WildernessTileCache::load(FloorType &floor, const Pos2D &wild_pos, int terrain, uint32_t seed)
+{
+    const auto it = std::find_if(this->tiles.begin(), this->tiles.end(), [&](const Tile &tile) {
+        return (tile.wild_pos == wild_pos) && (tile.terrain == terrain) && (tile.seed == seed);
+    });
+    if (it == this->tiles.end()) {
+        return false;
+    }
+
+    this->tiles.splice(this->tiles.begin(), this->tiles, it);
+    auto feat = it->feats.begin();
+    for (auto y = 0; y < MAX_HGT; y++) {
+        for (auto x = 0; x < MAX_WID; x++) {
+            floor.grid_array[y][x].feat = *feat++;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * @brief フロアに生成したタイルの地形をキャッシュに登録する
+ * @param floor タイルを生成したフロア
+ * @param wild_pos タイルの広域座標
+ * @param terrain タイルの地形種別
+ * @param seed タイルの乱数シード
+ * @details 容量を超えたら最も長く使っていないタイルを捨てる
+ */
+void WildernessTileCache::store(const FloorType &floor, const Pos2D &wild_pos, int terrain, uint32_t seed)
+{
+    if (this->tiles.size() >= CAPACITY) {
+        this->tiles.pop_back();
+    }
+
+    std::vector<FEAT_IDX> feats;
+    feats.reserve(MAX_HGT * MAX_WID);
+    for (auto y = 0; y < MAX_HGT; y++) {
+        for (auto x = 0; x < MAX_WID; x++) {
+            feats.push_back(floor.grid_array[y][x].feat);
+        }
+    }
+
+    this->tiles.push_front({ wild_pos, terrain, seed, std::move(feats) });
+}
+
+void WildernessTileCache::clear()
+{
+    this->tiles.clear();
+}
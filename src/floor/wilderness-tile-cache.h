@@ -0,0 +1,42 @@
+#pragma once
+
+#include "system/angband.h"
+#include "util/point-2d.h"
+#include <list>
+#include <vector>
+
+class FloorType;
+
+/*!
+ * @brief 生成済の荒野タイルの地形を保持するLRUキャッシュ
+ * @details 荒野のタイルの地形は広域座標・地形種別・シードだけで決まるため、
+ * 移動の度にプラズマフラクタルで作り直さず、最近使ったタイルを再利用する.
+ * 辺として使うタイルも中央として使うタイルも同じ地形なので、辺の地形もここから取り出せる.
+ */
+class WildernessTileCache {
+public:
+    WildernessTileCache(const WildernessTileCache &) = delete;
+    WildernessTileCache(WildernessTileCache &&) = delete;
+    WildernessTileCache &operator=(const WildernessTileCache &) = delete;
+    WildernessTileCache &operator=(WildernessTileCache &&) = delete;
+    ~WildernessTileCache() = default;
+
+    static WildernessTileCache &get_instance();
+    bool load(FloorType &floor, const Pos2D &wild_pos, int terrain, uint32_t seed);
+    void store(const FloorType &floor, const Pos2D &wild_pos, int terrain, uint32_t seed);
+    void clear();
+
+private:
+    WildernessTileCache() = default;
+
+    struct Tile {
+        Pos2D wild_pos;
+        int terrain;
+        uint32_t seed;
+        std::vector<FEAT_IDX> feats; //!< MAX_HGT * MAX_WID 個の地形ID (行優先)
+    };
+
+    static constexpr size_t CAPACITY = 16; //!< 3x3の広域範囲を2歩分以上保持できる数
+    static WildernessTileCache instance;
+    std::list<Tile> tiles; //!< 先頭ほど最近使ったタイル
+};
@@ -200,6 +200,7 @@ void cave_set_feat(PlayerType *player_ptr, POSITION y, POSITION x, FEAT_IDX feat
     if (!w_ptr->character_dungeon) {
         g_ptr->mimic = 0;
         g_ptr->feat = feat;
+        floor_ptr->teleport_destinations.update(*floor_ptr, { y, x });
         if (terrain.flags.has(TerrainCharacteristics::GLOW) && dungeon.flags.has_not(DungeonFeatureType::DARKNESS)) {
             for (DIRECTION i = 0; i < 9; i++) {
                 POSITION yy = y + ddy_ddd[i];
@@ -220,6 +221,7 @@ void cave_set_feat(PlayerType *player_ptr, POSITION y, POSITION x, FEAT_IDX feat
 
     g_ptr->mimic = 0;
     g_ptr->feat = feat;
+    floor_ptr->teleport_destinations.update(*floor_ptr, { y, x });
     g_ptr->info &= ~(CAVE_OBJECT);
     if (old_mirror && dungeon.flags.has(DungeonFeatureType::DARKNESS)) {
         g_ptr->info &= ~(CAVE_GLOW);
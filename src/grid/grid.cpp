@@ -64,6 +64,7 @@
 #include "view/display-map.h"
 #include "view/display-messages.h"
 #include "window/main-window-util.h"
+#include "window/overview-map.h"
 #include "world/world.h"
 #include <queue>
 
@@ -409,6 +410,7 @@ void note_spot(PlayerType *player_ptr, POSITION y, POSITION x)
  */
 void lite_spot(PlayerType *player_ptr, POSITION y, POSITION x)
 {
+    OverviewMap::get_instance().mark_changed(y, x);
     if (panel_contains(y, x) && in_bounds2(player_ptr->current_floor_ptr, y, x)) {
         TERM_COLOR a;
         char c;
@@ -25,123 +25,81 @@
 #include "view/display-messages.h"
 #include "world/world.h"
 #include <algorithm>
+#include <map>
+#include <optional>
 #include <sstream>
+#include <string>
+#include <vector>
 
 static concptr variant = "ZANGBAND";
 
+namespace {
 /*!
- * @brief 固定マップ (クエスト＆街＆広域マップ)生成時の分岐処理
- * Helper function for "parse_fixed_map()"
- * @param player_ptr プレイヤーへの参照ポインタ
- * @param sp
- * @param fp
- * @return エラーコード
+ * @brief 固定マップの条件式 ("?:" 行) をコンパイルした構文木
+ * @details 角括弧で囲まれたリストは先頭の要素を演算子とし、それ以外の要素は定数か "$" で始まる変数とする.
  */
-static concptr parse_fixed_map_expression(PlayerType *player_ptr, char **sp, char *fp)
-{
-    static std::string tmp;
-    char b1 = '[';
-    char b2 = ']';
+struct FixedMapExpression {
+    bool is_list = false;
+    bool is_closed = true; //!< リストが "]" で閉じているか
+    std::string token; //!< 定数または変数名 (リストでない場合)
+    std::vector<FixedMapExpression> elements; //!< 演算子と被演算子 (リストの場合)
+};
 
-    char f = ' ';
+/*!
+ * @brief 固定マップファイルの1行をコンパイルした命令
+ * @details 空行とコメント行はコンパイル時に取り除く
+ */
+struct FixedMapStatement {
+    int line_num; //!< エラー表示用の行番号 (0始まり)
+    std::optional<FixedMapExpression> condition; //!< "?:" 行ならばその条件式
+    std::string text; //!< "?:" 行以外ならば行の内容
+};
 
-    char *s;
-    s = (*sp);
+/*!
+ * @brief ファイル名ごとのコンパイル済の固定マップ
+ * @details 固定マップファイルはクエストへの出入りや荒野の移動の度に参照されるため、最初に読み込んだ時の内容を使い回す
+ */
+std::map<std::string, std::vector<FixedMapStatement>, std::less<>> compiled_fixed_maps;
+}
 
+/*!
+ * @brief 固定マップ (クエスト＆街＆広域マップ)の条件式をコンパイルする
+ * Helper function for "parse_fixed_map()"
+ * @param sp 条件式の文字列へのポインタ. 読み進めた位置に更新される
+ * @param fp 読み終えた要素の直後の区切り文字の格納先
+ * @return 条件式の構文木
+ */
+static FixedMapExpression compile_fixed_map_expression(char **sp, char *fp)
+{
+    char f = ' ';
+    auto *s = *sp;
     while (iswspace(*s)) {
         s++;
     }
 
-    char *b;
-    b = s;
-    concptr v = "?o?o?";
-    if (*s == b1) {
-        concptr p;
-        concptr t;
+    FixedMapExpression expression;
+    if (*s == '[') {
+        expression.is_list = true;
         s++;
-        t = parse_fixed_map_expression(player_ptr, &s, &f);
-        if (!*t) {
-            /* Nothing */
-        } else if (streq(t, "IOR")) {
-            v = "0";
-            while (*s && (f != b2)) {
-                t = parse_fixed_map_expression(player_ptr, &s, &f);
-                if (*t && !streq(t, "0")) {
-                    v = "1";
-                }
-            }
-        } else if (streq(t, "AND")) {
-            v = "1";
-            while (*s && (f != b2)) {
-                t = parse_fixed_map_expression(player_ptr, &s, &f);
-                if (*t && streq(t, "0")) {
-                    v = "0";
-                }
-            }
-        } else if (streq(t, "NOT")) {
-            v = "1";
-            while (*s && (f != b2)) {
-                t = parse_fixed_map_expression(player_ptr, &s, &f);
-                if (*t && streq(t, "1")) {
-                    v = "0";
-                }
-            }
-        } else if (streq(t, "EQU")) {
-            v = "0";
-            if (*s && (f != b2)) {
-                t = parse_fixed_map_expression(player_ptr, &s, &f);
-            }
-
-            while (*s && (f != b2)) {
-                p = parse_fixed_map_expression(player_ptr, &s, &f);
-                if (streq(t, p)) {
-                    v = "1";
-                }
-            }
-        } else if (streq(t, "LEQ")) {
-            v = "1";
-            if (*s && (f != b2)) {
-                t = parse_fixed_map_expression(player_ptr, &s, &f);
-            }
-
-            while (*s && (f != b2)) {
-                p = t;
-                t = parse_fixed_map_expression(player_ptr, &s, &f);
-                if (*t && atoi(p) > atoi(t)) {
-                    v = "0";
-                }
-            }
-        } else if (streq(t, "GEQ")) {
-            v = "1";
-            if (*s && (f != b2)) {
-                t = parse_fixed_map_expression(player_ptr, &s, &f);
-            }
-
-            while (*s && (f != b2)) {
-                p = t;
-                t = parse_fixed_map_expression(player_ptr, &s, &f);
-                if (*t && atoi(p) < atoi(t)) {
-                    v = "0";
-                }
-            }
-        } else {
-            while (*s && (f != b2)) {
-                t = parse_fixed_map_expression(player_ptr, &s, &f);
+        expression.elements.push_back(compile_fixed_map_expression(&s, &f));
+        const auto &op = expression.elements.front();
+        if (op.is_list || !op.token.empty()) {
+            while (*s && (f != ']')) {
+                expression.elements.push_back(compile_fixed_map_expression(&s, &f));
             }
         }
 
-        if (f != b2) {
-            v = "?x?x?";
-        }
+        expression.is_closed = f == ']';
         if ((f = *s) != '\0') {
-            *s++ = '\0';
+            s++;
         }
 
-        (*fp) = f;
-        (*sp) = s;
-        return v;
+        *fp = f;
+        *sp = s;
+        return expression;
     }
 
+    auto *b = s;
 #ifdef JP
     while (iskanji(*s) || (isprint(*s) && !angband_strchr(" []", *s))) {
         if (iskanji(*s)) {
@@ -154,91 +112,221 @@ static concptr parse_fixed_map_expression(PlayerType *player_ptr, char **sp, cha
         ++s;
     }
 #endif
+    expression.token.assign(b, s);
     if ((f = *s) != '\0') {
-        *s++ = '\0';
+        s++;
+    }
+
+    *fp = f;
+    *sp = s;
+    return expression;
+}
+
+/*!
+ * @brief 固定マップの条件式に現れる変数の値を返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param name 変数名 ("$" を除く)
+ * @return 変数の値. 未知の変数ならば "?o?o?"
+ */
+static std::string evaluate_fixed_map_variable(PlayerType *player_ptr, std::string_view name)
+{
+    if (name == "SYS") {
+        return ANGBAND_SYS;
     }
 
-    if (*b != '$') {
-        v = b;
-        (*fp) = f;
-        (*sp) = s;
-        return v;
+    if (name == "GRAF") {
+        return ANGBAND_GRAF;
     }
 
-    if (streq(b + 1, "SYS")) {
-        v = ANGBAND_SYS;
-    } else if (streq(b + 1, "GRAF")) {
-        v = ANGBAND_GRAF;
-    } else if (streq(b + 1, "MONOCHROME")) {
-        if (arg_monochrome) {
-            v = "ON";
-        } else {
-            v = "OFF";
-        }
-    } else if (streq(b + 1, "RACE")) {
-        v = _(rp_ptr->E_title, rp_ptr->title);
-    } else if (streq(b + 1, "CLASS")) {
-        v = _(cp_ptr->E_title, cp_ptr->title);
-    } else if (streq(b + 1, "REALM1")) {
-        v = _(E_realm_names[player_ptr->realm1], realm_names[player_ptr->realm1]);
-    } else if (streq(b + 1, "REALM2")) {
-        v = _(E_realm_names[player_ptr->realm2], realm_names[player_ptr->realm2]);
-    } else if (streq(b + 1, "PLAYER")) {
-        static char tmp_player_name[32];
-        char *pn, *tpn;
-        for (pn = player_ptr->name, tpn = tmp_player_name; *pn; pn++, tpn++) {
+    if (name == "MONOCHROME") {
+        return arg_monochrome ? "ON" : "OFF";
+    }
+
+    if (name == "RACE") {
+        return _(rp_ptr->E_title, rp_ptr->title);
+    }
+
+    if (name == "CLASS") {
+        return _(cp_ptr->E_title, cp_ptr->title);
+    }
+
+    if (name == "REALM1") {
+        return _(E_realm_names[player_ptr->realm1], realm_names[player_ptr->realm1]);
+    }
+
+    if (name == "REALM2") {
+        return _(E_realm_names[player_ptr->realm2], realm_names[player_ptr->realm2]);
+    }
+
+    if (name == "PLAYER") {
+        std::string player_name;
+        for (auto *pn = player_ptr->name; *pn; pn++) {
 #ifdef JP
             if (iskanji(*pn)) {
-                *(tpn++) = *(pn++);
-                *tpn = *pn;
+                player_name.push_back(*(pn++));
+                player_name.push_back(*pn);
                 continue;
             }
 #endif
-            *tpn = angband_strchr(" []", *pn) ? '_' : *pn;
+            player_name.push_back(angband_strchr(" []", *pn) ? '_' : *pn);
         }
 
-        *tpn = '\0';
-        v = tmp_player_name;
-    } else if (streq(b + 1, "TOWN")) {
-        tmp = std::to_string(player_ptr->town_num);
-        v = tmp.data();
-    } else if (streq(b + 1, "LEVEL")) {
-        tmp = std::to_string(player_ptr->lev);
-        v = tmp.data();
-    } else if (streq(b + 1, "QUEST_NUMBER")) {
-        tmp = std::to_string(enum2i(player_ptr->current_floor_ptr->quest_number));
-        v = tmp.data();
-    } else if (streq(b + 1, "LEAVING_QUEST")) {
-        tmp = std::to_string(enum2i(leaving_quest));
-        v = tmp.data();
-    } else if (prefix(b + 1, "QUEST_TYPE")) {
+        return player_name;
+    }
+
+    if (name == "TOWN") {
+        return std::to_string(player_ptr->town_num);
+    }
+
+    if (name == "LEVEL") {
+        return std::to_string(player_ptr->lev);
+    }
+
+    if (name == "QUEST_NUMBER") {
+        return std::to_string(enum2i(player_ptr->current_floor_ptr->quest_number));
+    }
+
+    if (name == "LEAVING_QUEST") {
+        return std::to_string(enum2i(leaving_quest));
+    }
+
+    if (name.starts_with("QUEST_TYPE")) {
         const auto &quest_list = QuestList::get_instance();
-        tmp = std::to_string(enum2i(quest_list[i2enum<QuestId>(atoi(b + 11))].type));
-        v = tmp.data();
-    } else if (prefix(b + 1, "QUEST")) {
+        return std::to_string(enum2i(quest_list[i2enum<QuestId>(atoi(name.data() + 10))].type));
+    }
+
+    if (name.starts_with("QUEST")) {
         const auto &quest_list = QuestList::get_instance();
-        tmp = std::to_string(enum2i(quest_list[i2enum<QuestId>(atoi(b + 6))].status));
-        v = tmp.data();
-    } else if (prefix(b + 1, "RANDOM")) {
-        tmp = std::to_string((int)(w_ptr->seed_town % atoi(b + 7)));
-        v = tmp.data();
-    } else if (streq(b + 1, "VARIANT")) {
-        v = variant;
-    } else if (streq(b + 1, "WILDERNESS")) {
+        return std::to_string(enum2i(quest_list[i2enum<QuestId>(atoi(name.data() + 5))].status));
+    }
+
+    if (name.starts_with("RANDOM")) {
+        return std::to_string((int)(w_ptr->seed_town % atoi(name.data() + 6)));
+    }
+
+    if (name == "VARIANT") {
+        return variant;
+    }
+
+    if (name == "WILDERNESS") {
         if (vanilla_town) {
-            v = "NONE";
-        } else if (lite_town) {
-            v = "LITE";
-        } else {
-            v = "NORMAL";
+            return "NONE";
+        }
+
+        return lite_town ? "LITE" : "NORMAL";
+    }
+
+    if (name == "IRONMAN_DOWNWARD") {
+        return ironman_downward ? "1" : "0";
+    }
+
+    return "?o?o?";
+}
+
+/*!
+ * @brief 固定マップ (クエスト＆街＆広域マップ)の条件式を評価する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param expression 条件式の構文木
+ * @return 評価結果. 真偽値ならば "1" か "0"
+ */
+static std::string evaluate_fixed_map_expression(PlayerType *player_ptr, const FixedMapExpression &expression)
+{
+    if (!expression.is_list) {
+        if (expression.token.starts_with('$')) {
+            return evaluate_fixed_map_variable(player_ptr, std::string_view(expression.token).substr(1));
+        }
+
+        return expression.token;
+    }
+
+    if (!expression.is_closed) {
+        return "?x?x?";
+    }
+
+    const auto op = evaluate_fixed_map_expression(player_ptr, expression.elements.front());
+    std::vector<std::string> operands;
+    for (auto it = expression.elements.begin() + 1; it != expression.elements.end(); ++it) {
+        operands.push_back(evaluate_fixed_map_expression(player_ptr, *it));
+    }
+
+    if (op == "IOR") {
+        const auto is_true = std::any_of(operands.begin(), operands.end(), [](const auto &t) { return !t.empty() && (t != "0"); });
+        return is_true ? "1" : "0";
+    }
+
+    if (op == "AND") {
+        const auto is_false = std::any_of(operands.begin(), operands.end(), [](const auto &t) { return t == "0"; });
+        return is_false ? "0" : "1";
+    }
+
+    if (op == "NOT") {
+        const auto is_false = std::any_of(operands.begin(), operands.end(), [](const auto &t) { return t == "1"; });
+        return is_false ? "0" : "1";
+    }
+
+    if (op == "EQU") {
+        const auto is_equal = !operands.empty() && std::any_of(operands.begin() + 1, operands.end(), [&operands](const auto &p) { return p == operands.front(); });
+        return is_equal ? "1" : "0";
+    }
+
+    if ((op == "LEQ") || (op == "GEQ")) {
+        for (size_t i = 1; i < operands.size(); i++) {
+            if (operands[i].empty()) {
+                continue;
+            }
+
+            const auto p = atoi(operands[i - 1].data());
+            const auto t = atoi(operands[i].data());
+            if ((op == "LEQ") ? (p > t) : (p < t)) {
+                return "0";
+            }
+        }
+
+        return "1";
+    }
+
+    return "?o?o?";
+}
+
+/*!
+ * @brief 固定マップファイルを読み込んでコンパイルする
+ * @param name ファイル名
+ * @return コンパイル済の命令列. ファイルが開けなければnullptr
+ * @details 一度コンパイルしたファイルは読み直さない
+ */
+static const std::vector<FixedMapStatement> *compile_fixed_map(std::string_view name)
+{
+    if (const auto it = compiled_fixed_maps.find(name); it != compiled_fixed_maps.end()) {
+        return &it->second;
+    }
+
+    const auto &path = path_build(ANGBAND_DIR_EDIT, name);
+    auto *fp = angband_fopen(path, FileOpenMode::READ);
+    if (fp == nullptr) {
+        return nullptr;
+    }
+
+    std::vector<FixedMapStatement> statements;
+    char buf[1024]{};
+    auto num = -1;
+    while (angband_fgets(fp, buf, sizeof(buf)) == 0) {
+        num++;
+        if (!buf[0] || iswspace(buf[0]) || buf[0] == '#') {
+            continue;
         }
-    } else if (streq(b + 1, "IRONMAN_DOWNWARD")) {
-        v = (ironman_downward ? "1" : "0");
+
+        if ((buf[0] == '?') && (buf[1] == ':')) {
+            char f;
+            auto *s = buf + 2;
+            statements.push_back({ num, compile_fixed_map_expression(&s, &f), "" });
+            continue;
+        }
+
+        statements.push_back({ num, std::nullopt, buf });
     }
 
-    (*fp) = f;
-    (*sp) = s;
-    return v;
+    angband_fclose(fp);
+    return &compiled_fixed_maps.emplace(name, std::move(statements)).first->second;
 }
 
 /*!
@@ -250,12 +338,12 @@ static concptr parse_fixed_map_expression(PlayerType *player_ptr, char **sp, cha
  * @param ymax 詳細不明
  * @param xmax 詳細不明
  * @return エラーコード
+ * @details ファイルは最初の1回だけ読み込んでコンパイルし、以降は条件式の評価と各行の処理だけを行う
  */
 parse_error_type parse_fixed_map(PlayerType *player_ptr, std::string_view name, int ymin, int xmin, int ymax, int xmax)
 {
-    const auto &path = path_build(ANGBAND_DIR_EDIT, name);
-    auto *fp = angband_fopen(path, FileOpenMode::READ);
-    if (fp == nullptr) {
+    const auto *statements = compile_fixed_map(name);
+    if (statements == nullptr) {
         return PARSE_ERROR_GENERIC;
     }
 
@@ -267,18 +355,10 @@ parse_error_type parse_fixed_map(PlayerType *player_ptr, std::string_view name,
     qtwg_type tmp_qg;
     char buf[1024]{};
     qtwg_type *qg_ptr = initialize_quest_generator_type(&tmp_qg, buf, ymin, xmin, ymax, xmax, &y, &x);
-    while (angband_fgets(fp, buf, sizeof(buf)) == 0) {
-        num++;
-        if (!buf[0] || iswspace(buf[0]) || buf[0] == '#') {
-            continue;
-        }
-
-        if ((buf[0] == '?') && (buf[1] == ':')) {
-            char f;
-            char *s;
-            s = buf + 2;
-            concptr v = parse_fixed_map_expression(player_ptr, &s, &f);
-            bypass = streq(v, "0");
+    for (const auto &statement : *statements) {
+        num = statement.line_num;
+        if (statement.condition) {
+            bypass = evaluate_fixed_map_expression(player_ptr, *statement.condition) == "0";
             continue;
         }
 
@@ -286,6 +366,7 @@ parse_error_type parse_fixed_map(PlayerType *player_ptr, std::string_view name,
             continue;
         }
 
+        angband_strcpy(buf, statement.text, sizeof(buf));
         err = generate_fixed_map_floor(player_ptr, qg_ptr, parse_fixed_map);
         if (err != PARSE_ERROR_NONE) {
             break;
@@ -299,7 +380,6 @@ parse_error_type parse_fixed_map(PlayerType *player_ptr, std::string_view name,
         msg_print(nullptr);
     }
 
-    angband_fclose(fp);
     return err;
 }
 
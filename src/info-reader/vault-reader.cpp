@@ -62,3 +62,12 @@ errr parse_vaults_info(std::string_view buf, angband_header *)
 
     return PARSE_ERROR_NONE;
 }
+
+/*!
+ * @brief Vaultの配置データを生成時に使う形式へ展開する
+ * @param head ヘッダ構造体
+ */
+void retouch_vaults_info(angband_header *)
+{
+    compile_vaults_info();
+}
@@ -5,3 +5,4 @@
 
 struct angband_header;
 errr parse_vaults_info(std::string_view buf, angband_header *head);
+void retouch_vaults_info(angband_header *head);
@@ -0,0 +1,430 @@
+/*!
+ * @brief 中継(観戦)用のライブ配信処理
+ * @details epollが使えない環境では配信を開始できない.
+ */
+
+#include "io/chuukei-broadcaster.h"
+#include "io/movie-container.h"
+#include "system/angband.h"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <unordered_map>
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr auto LISTEN_BACKLOG = 16;
+constexpr auto MAX_EVENTS = 64;
+constexpr size_t MAX_SPECTATOR_BACKLOG = 4 * 1024 * 1024; //!< これ以上送信が滞った観戦者は切断する
+constexpr auto SEND_CHUNK_BUFFERS = 64; //!< 1回のsendmsgでまとめて送るバッファ数の上限
+
+/*!
+ * @brief 観戦者1人分の送信状態
+ * @details 送信待ちのバッファは全観戦者で共有しており、ここでは参照と送信済の位置だけを持つ.
+ */
+struct Spectator {
+    std::deque<std::shared_ptr<const std::string>> queue;
+    size_t sent_in_front = 0; //!< queue 先頭のバッファのうち送信済のバイト数
+    size_t queued_bytes = 0;
+    bool is_waiting_keyframe = true;
+    int base_timestamp = 0; //!< 最初に受信したキーフレームの描画時刻
+    bool is_writable = true; //!< falseならEPOLLOUTを待っている
+
+    void enqueue(const std::shared_ptr<const std::string> &buffer)
+    {
+        this->queue.push_back(buffer);
+        this->queued_bytes += buffer->size();
+    }
+};
+}
+
+ChuukeiBroadcaster ChuukeiBroadcaster::instance{};
+
+ChuukeiBroadcaster::~ChuukeiBroadcaster()
+{
+    this->stop();
+}
+
+ChuukeiBroadcaster &ChuukeiBroadcaster::get_instance()
+{
+    return instance;
+}
+
+bool ChuukeiBroadcaster::is_running() const
+{
+    return this->worker.joinable();
+}
+
+/*!
+ * @brief 待ち受けているTCPポート番号を返す
+ * @details ポート番号0で開始した場合は自動的に割り当てられた番号を返す
+ */
+uint16_t ChuukeiBroadcaster::get_port() const
+{
+    return this->port;
+}
+
+/*!
+ * @brief 観戦者からキーフレームの送信を求められているかを返し、要求を取り下げる
+ * @details ゲームスレッドから呼び、trueならば post_keyframe() で画面全体を送ること.
+ */
+bool ChuukeiBroadcaster::consume_keyframe_request()
+{
+    return this->is_keyframe_requested.exchange(false);
+}
+
+/*!
+ * @brief フレームを配信する
+ * @param timestamp フレームの描画時刻 (100ms単位)
+ * @param records フレーム内の描画コマンド列
+ */
+void ChuukeiBroadcaster::post_frame(int timestamp, std::string_view records)
+{
+    timestamp = std::max(timestamp, this->last_timestamp);
+    const auto delta = encode_movie_frame_delta(this->last_records, records);
+    auto buffer = std::make_shared<const std::string>(encode_movie_block(MovieBlockType::FRAME, timestamp - this->last_timestamp, delta));
+    this->last_timestamp = timestamp;
+    this->last_records = records;
+    this->post({ std::move(buffer), false, timestamp });
+}
+
+/*!
+ * @brief キーフレームを配信する
+ * @param timestamp 直前のフレームの描画時刻 (100ms単位)
+ * @param records 画面全体を描画するコマンド列
+ * @details キーフレームを待っている観戦者はここから受信を始める.
+ */
+void ChuukeiBroadcaster::post_keyframe(int timestamp, std::string_view records)
+{
+    timestamp = std::max(timestamp, this->last_timestamp);
+    auto buffer = std::make_shared<const std::string>(records);
+    this->last_timestamp = timestamp;
+    this->last_records = records;
+    this->post({ std::move(buffer), true, timestamp });
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+/*!
+ * @brief 配信を開始する
+ * @param port 待ち受けるTCPポート番号 (0ならば自動的に割り当てる)
+ * @param address 待ち受けるIPv4アドレス. 空ならばループバックアドレスのみで待ち受ける
+ * @return 開始できればtrue
+ */
+bool ChuukeiBroadcaster::start(uint16_t port, std::string_view address)
+{
+    if (this->is_running()) {
+        return true;
+    }
+
+    in_addr listen_address{};
+    listen_address.s_addr = htonl(INADDR_LOOPBACK);
+    if (!address.empty() && (inet_pton(AF_INET, std::string(address).data(), &listen_address) != 1)) {
+        return false;
+    }
+
+    this->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    this->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    auto is_successful = (this->listen_fd >= 0) && (this->wakeup_fd >= 0) && (this->epoll_fd >= 0);
+    if (is_successful) {
+        const int reuse = 1;
+        (void)setsockopt(this->listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in socket_address{};
+        socket_address.sin_family = AF_INET;
+        socket_address.sin_addr = listen_address;
+        socket_address.sin_port = htons(port);
+        is_successful &= bind(this->listen_fd, reinterpret_cast<sockaddr *>(&socket_address), sizeof(socket_address)) == 0;
+        is_successful &= listen(this->listen_fd, LISTEN_BACKLOG) == 0;
+        socklen_t socket_address_size = sizeof(socket_address);
+        is_successful &= getsockname(this->listen_fd, reinterpret_cast<sockaddr *>(&socket_address), &socket_address_size) == 0;
+        this->port = ntohs(socket_address.sin_port);
+    }
+
+    if (is_successful) {
+        epoll_event listen_event{};
+        listen_event.events = EPOLLIN;
+        listen_event.data.fd = this->listen_fd;
+        epoll_event wakeup_event{};
+        wakeup_event.events = EPOLLIN;
+        wakeup_event.data.fd = this->wakeup_fd;
+        is_successful &= epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->listen_fd, &listen_event) == 0;
+        is_successful &= epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->wakeup_fd, &wakeup_event) == 0;
+    }
+
+    if (!is_successful) {
+        for (auto *fd : { &this->listen_fd, &this->wakeup_fd, &this->epoll_fd }) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+
+        return false;
+    }
+
+    this->is_stopping = false;
+    this->worker = std::thread(&ChuukeiBroadcaster::run, this);
+    return true;
+}
+
+/*!
+ * @brief 配信を終了し、全ての観戦者を切断する
+ */
+void ChuukeiBroadcaster::stop()
+{
+    if (!this->is_running()) {
+        return;
+    }
+
+    {
+        std::unique_lock lock(this->mutex);
+        this->is_stopping = true;
+    }
+
+    const uint64_t one = 1;
+    (void)!write(this->wakeup_fd, &one, sizeof(one));
+    this->worker.join();
+    close(this->listen_fd);
+    close(this->wakeup_fd);
+    close(this->epoll_fd);
+    this->listen_fd = this->wakeup_fd = this->epoll_fd = -1;
+    this->pending.clear();
+}
+
+void ChuukeiBroadcaster::post(Packet &&packet)
+{
+    if (!this->is_running()) {
+        return;
+    }
+
+    {
+        std::unique_lock lock(this->mutex);
+        this->pending.push_back(std::move(packet));
+    }
+
+    const uint64_t one = 1;
+    (void)!write(this->wakeup_fd, &one, sizeof(one));
+}
+
+/*!
+ * @brief 送信スレッドの本体
+ * @details 観戦者の受け付け、待ち行列の振り分け、ノンブロッキング送信を1つのepollループで行う.
+ */
+void ChuukeiBroadcaster::run()
+{
+    const auto header = std::make_shared<const std::string>(MOVIE_CONTAINER_MAGIC);
+    std::unordered_map<int, Spectator> spectators;
+    const auto disconnect = [&](int fd) {
+        (void)epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        spectators.erase(fd);
+    };
+
+    const auto set_writable_watch = [&](int fd, Spectator &spectator, bool is_writable) {
+        if (spectator.is_writable == is_writable) {
+            return;
+        }
+
+        spectator.is_writable = is_writable;
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | (is_writable ? 0U : static_cast<uint32_t>(EPOLLOUT));
+        event.data.fd = fd;
+        (void)epoll_ctl(this->epoll_fd, EPOLL_CTL_MOD, fd, &event);
+    };
+
+    /* 送信できるだけ送る. 切断すべきならばfalseを返す */
+    const auto flush = [&](int fd, Spectator &spectator) {
+        while (!spectator.queue.empty()) {
+            iovec iov[SEND_CHUNK_BUFFERS];
+            auto count = 0;
+            for (auto it = spectator.queue.begin(); (it != spectator.queue.end()) && (count < SEND_CHUNK_BUFFERS); ++it, ++count) {
+                const auto offset = (count == 0) ? spectator.sent_in_front : 0;
+                iov[count].iov_base = const_cast<char *>((*it)->data() + offset);
+                iov[count].iov_len = (*it)->size() - offset;
+            }
+
+            msghdr message{};
+            message.msg_iov = iov;
+            message.msg_iovlen = count;
+            auto sent = sendmsg(fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (sent < 0) {
+                if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                    set_writable_watch(fd, spectator, false);
+                    return true;
+                }
+
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return false;
+            }
+
+            spectator.queued_bytes -= sent;
+            while (sent > 0) {
+                const auto remaining = spectator.queue.front()->size() - spectator.sent_in_front;
+                if (static_cast<size_t>(sent) < remaining) {
+                    spectator.sent_in_front += sent;
+                    break;
+                }
+
+                sent -= remaining;
+                spectator.queue.pop_front();
+                spectator.sent_in_front = 0;
+            }
+        }
+
+        set_writable_watch(fd, spectator, true);
+        return true;
+    };
+
+    std::vector<Packet> packets;
+    while (true) {
+        epoll_event events[MAX_EVENTS];
+        const auto event_count = epoll_wait(this->epoll_fd, events, MAX_EVENTS, -1);
+        if ((event_count < 0) && (errno != EINTR)) {
+            break;
+        }
+
+        for (auto i = 0; i < event_count; i++) {
+            const auto fd = events[i].data.fd;
+            if (fd == this->wakeup_fd) {
+                uint64_t count;
+                (void)!read(this->wakeup_fd, &count, sizeof(count));
+                continue;
+            }
+
+            if (fd == this->listen_fd) {
+                while (true) {
+                    const auto client_fd = accept4(this->listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (client_fd < 0) {
+                        break;
+                    }
+
+                    epoll_event event{};
+                    event.events = EPOLLIN | EPOLLRDHUP;
+                    event.data.fd = client_fd;
+                    if (epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, client_fd, &event) != 0) {
+                        close(client_fd);
+                        continue;
+                    }
+
+                    spectators[client_fd].enqueue(header);
+                    this->is_keyframe_requested = true;
+                }
+
+                continue;
+            }
+
+            auto it = spectators.find(fd);
+            if (it == spectators.end()) {
+                continue;
+            }
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+                disconnect(fd);
+                continue;
+            }
+
+            /* 観戦者からの入力は読み捨てる */
+            if (events[i].events & EPOLLIN) {
+                char discard[256];
+                if (recv(fd, discard, sizeof(discard), MSG_DONTWAIT) == 0) {
+                    disconnect(fd);
+                    continue;
+                }
+            }
+
+            if ((events[i].events & EPOLLOUT) && !flush(fd, it->second)) {
+                disconnect(fd);
+            }
+        }
+
+        {
+            std::unique_lock lock(this->mutex);
+            if (this->is_stopping) {
+                break;
+            }
+
+            packets.swap(this->pending);
+        }
+
+        for (const auto &packet : packets) {
+            std::map<int, std::shared_ptr<const std::string>> keyframes; //!< 基準時刻ごとに符号化したキーフレーム
+            for (auto &[fd, spectator] : spectators) {
+                if (spectator.is_waiting_keyframe) {
+                    if (!packet.is_keyframe) {
+                        continue;
+                    }
+
+                    spectator.is_waiting_keyframe = false;
+                    spectator.base_timestamp = packet.timestamp;
+                }
+
+                if (!packet.is_keyframe) {
+                    spectator.enqueue(packet.buffer);
+                    continue;
+                }
+
+                auto &keyframe = keyframes[spectator.base_timestamp];
+                if (!keyframe) {
+                    keyframe = std::make_shared<const std::string>(encode_movie_block(MovieBlockType::KEYFRAME, packet.timestamp - spectator.base_timestamp, *packet.buffer));
+                }
+
+                spectator.enqueue(keyframe);
+            }
+        }
+
+        packets.clear();
+        std::vector<int> slow_spectators;
+        for (auto &[fd, spectator] : spectators) {
+            if (spectator.is_writable && !flush(fd, spectator)) {
+                slow_spectators.push_back(fd);
+                continue;
+            }
+
+            if (spectator.queued_bytes > MAX_SPECTATOR_BACKLOG) {
+                slow_spectators.push_back(fd);
+            }
+        }
+
+        for (const auto fd : slow_spectators) {
+            disconnect(fd);
+        }
+    }
+
+    for (const auto &[fd, spectator] : spectators) {
+        close(fd);
+    }
+}
+#else
+bool ChuukeiBroadcaster::start(uint16_t port, std::string_view address)
+{
+    (void)port;
+    (void)address;
+    return false;
+}
+
+void ChuukeiBroadcaster::stop()
+{
+}
+
+void ChuukeiBroadcaster::post(Packet &&packet)
+{
+    (void)packet;
+}
+
+void ChuukeiBroadcaster::run()
+{
+}
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*!
+ * @brief 中継(観戦)用のライブ配信クラス
+ * @details 各フレームはゲームスレッドで1度だけ符号化し、同じバッファを全ての観戦者で共有する.
+ * 送信は専用スレッドのepollループでノンブロッキングに行い、ゲームスレッドを待たせない.
+ * 途中から接続した観戦者にはキーフレームから配信し、送信が追い付かない観戦者は切断する.
+ * キーフレームのタイムスタンプは観戦者ごとに最初のキーフレームを0とした値に置き換えて送る.
+ * 配信データはキーフレーム付きムービーと同じ形式 (索引なし) のため、受信したものをそのまま再生できる.
+ */
+class ChuukeiBroadcaster {
+public:
+    ChuukeiBroadcaster(const ChuukeiBroadcaster &) = delete;
+    ChuukeiBroadcaster(ChuukeiBroadcaster &&) = delete;
+    ChuukeiBroadcaster &operator=(const ChuukeiBroadcaster &) = delete;
+    ChuukeiBroadcaster &operator=(ChuukeiBroadcaster &&) = delete;
+    ~ChuukeiBroadcaster();
+
+    static ChuukeiBroadcaster &get_instance();
+    bool start(uint16_t port, std::string_view address = "");
+    void stop();
+    bool is_running() const;
+    uint16_t get_port() const;
+    bool consume_keyframe_request();
+    void post_frame(int timestamp, std::string_view records);
+    void post_keyframe(int timestamp, std::string_view records);
+
+private:
+    ChuukeiBroadcaster() = default;
+
+    using SharedBuffer = std::shared_ptr<const std::string>;
+
+    /*!
+     * @brief 送信スレッドへ渡すフレーム1件分
+     * @details キーフレームは観戦者ごとにタイムスタンプを置き換えるため、符号化せずに描画コマンド列のまま渡す.
+     */
+    struct Packet {
+        SharedBuffer buffer; //!< FRAMEならば符号化済のブロック、KEYFRAMEならば描画コマンド列
+        bool is_keyframe;
+        int timestamp; //!< 配信開始からの描画時刻 (100ms単位)
+    };
+
+    static ChuukeiBroadcaster instance;
+    std::thread worker;
+    std::mutex mutex;
+    std::vector<Packet> pending; //!< ゲームスレッドから送信スレッドへ渡す待ち行列
+    std::atomic<bool> is_keyframe_requested = false;
+    int listen_fd = -1;
+    uint16_t port = 0;
+    int wakeup_fd = -1;
+    int epoll_fd = -1;
+    int last_timestamp = 0;
+    std::string last_records; //!< 直前に配信した描画コマンド列 (フレームの差分の基準)
+    bool is_stopping = false;
+
+    void post(Packet &&packet);
+    void run();
+};
@@ -26,6 +26,10 @@
 #include "util/angband-files.h"
 #include "view/display-messages.h"
 #include <algorithm>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <vector>
 #ifdef SAVEFILE_USE_UID
 #include "main-unix/unix-user-ids.h"
 #endif
@@ -103,87 +107,220 @@ void file_character(PlayerType *player_ptr, std::string_view filename)
     msg_print(nullptr);
 }
 
+namespace {
 /*!
- * @brief ファイルからランダムに行を一つ取得する
+ * @brief ランダム行ファイルのN:タグヘッダ
+ */
+struct RandomLineHeader {
+    enum class Kind {
+        ALL, //!< N:* どのIDにも一致する
+        MALE, //!< N:M 男性のモンスターに一致する
+        FEMALE, //!< N:F 女性のモンスターに一致する
+        NUMBER, //!< N:<数値> 同じIDに一致する
+        ERROR, //!< 解釈できないヘッダ
+    };
+
+    Kind kind;
+    int number; //!< kind がNUMBERの時のID
+    int line_num; //!< ファイル内の行番号 (エラーメッセージ用)
+    size_t begin; //!< ヘッダに続く候補行の先頭 (RandomLineCorpus::lines の添字)
+    size_t end; //!< ヘッダに続く候補行の末尾の次
+};
+
+/*!
+ * @brief ランダム行ファイルを一度だけ読み込んで索引付けしたもの
+ * @details ヘッダごとに、その直後から空行までに並ぶ候補行 (N:行とコメントを除く) の範囲を持つ.
+ * ファイル内で最初に一致するヘッダを引けるよう、種類ごと・IDごとに最初のヘッダの位置を控えておく.
+ */
+struct RandomLineCorpus {
+    std::vector<std::string> lines;
+    std::vector<RandomLineHeader> headers;
+    std::optional<size_t> first_all;
+    std::optional<size_t> first_male;
+    std::optional<size_t> first_female;
+    std::optional<size_t> first_error;
+    std::unordered_map<int, size_t> first_numbers;
+};
+
+std::map<std::string, RandomLineCorpus, std::less<>> random_line_corpora;
+
+/*!
+ * @brief N:タグヘッダを解釈する
+ * @param buf ヘッダ行
+ * @param line_num 行番号
+ * @return 解釈したヘッダ (候補行の範囲は未設定)
+ */
+RandomLineHeader parse_random_line_header(const char *buf, int line_num)
+{
+    RandomLineHeader header{ RandomLineHeader::Kind::ERROR, 0, line_num, 0, 0 };
+    if (buf[2] == '*') {
+        header.kind = RandomLineHeader::Kind::ALL;
+    } else if (buf[2] == 'M') {
+        header.kind = RandomLineHeader::Kind::MALE;
+    } else if (buf[2] == 'F') {
+        header.kind = RandomLineHeader::Kind::FEMALE;
+    } else {
+        const auto result = sscanf(&buf[2], "%d", &header.number);
+        if (result == 1) {
+            header.kind = RandomLineHeader::Kind::NUMBER;
+        } else if (result != EOF) {
+            // 数値で始まらないヘッダはどのIDにも一致させない
+            header.kind = RandomLineHeader::Kind::NUMBER;
+            header.number = std::numeric_limits<int>::min();
+        }
+    }
+
+    return header;
+}
+
+/*!
+ * @brief ランダム行ファイルを読み込んで索引付けする
  * @param file_name ファイル名
- * @param entry 特定条件時のN:タグヘッダID
- * @return ファイルから取得した行 (但しファイルがなかったり異常値ならばnullopt)
+ * @return 索引付けしたファイルへの参照 (ファイルがなければnullptr)
+ * @details 一度読み込んだファイルは以後メモリ上の内容を使う
  */
-std::optional<std::string> get_random_line(concptr file_name, int entry)
+const RandomLineCorpus *load_random_line_corpus(concptr file_name)
 {
+    const auto it = random_line_corpora.find(file_name);
+    if (it != random_line_corpora.end()) {
+        return &it->second;
+    }
+
     const auto &path = path_build(ANGBAND_DIR_FILE, file_name);
     auto *fp = angband_fopen(path, FileOpenMode::READ);
     if (!fp) {
-        return std::nullopt;
+        return nullptr;
     }
 
-    int test;
-    auto line_num = 0;
-    while (true) {
-        char buf[1024];
-        if (angband_fgets(fp, buf, sizeof(buf)) != 0) {
-            angband_fclose(fp);
-            return std::nullopt;
+    RandomLineCorpus corpus;
+    std::vector<size_t> open_headers;
+    const auto close_headers = [&corpus, &open_headers] {
+        for (const auto index : open_headers) {
+            corpus.headers[index].end = corpus.lines.size();
         }
 
+        open_headers.clear();
+    };
+
+    auto line_num = 0;
+    char buf[1024];
+    while (angband_fgets(fp, buf, sizeof(buf)) == 0) {
         line_num++;
-        if ((buf[0] != 'N') || (buf[1] != ':')) {
+        if ((buf[0] == 'N') && (buf[1] == ':')) {
+            auto header = parse_random_line_header(buf, line_num);
+            header.begin = corpus.lines.size();
+            header.end = header.begin;
+            open_headers.push_back(corpus.headers.size());
+            corpus.headers.push_back(header);
             continue;
         }
 
-        if (buf[2] == '*') {
-            break;
+        if (buf[0] == '#') {
+            continue;
         }
 
-        if (buf[2] == 'M') {
-            if (is_male(monraces_info[i2enum<MonsterRaceId>(entry)])) {
-                break;
-            }
-        } else if (buf[2] == 'F') {
-            if (is_female(monraces_info[i2enum<MonsterRaceId>(entry)])) {
-                break;
-            }
-        } else if (sscanf(&(buf[2]), "%d", &test) != EOF) {
-            if (test == entry) {
-                break;
-            }
-        } else {
-            msg_format("Error in line %d of %s!", line_num, file_name);
-            angband_fclose(fp);
-            return std::nullopt;
+        if (!buf[0]) {
+            close_headers();
+            continue;
         }
-    }
 
-    auto counter = 0;
-    std::optional<std::string> line{};
-    while (true) {
-        char buf[1024];
-        while (true) {
-            if (angband_fgets(fp, buf, sizeof(buf))) {
-                break;
-            }
-
-            if ((buf[0] == 'N') && (buf[1] == ':')) {
-                continue;
-            }
-
-            if (buf[0] != '#') {
-                break;
-            }
+        if (!open_headers.empty()) {
+            corpus.lines.emplace_back(buf);
         }
+    }
 
-        if (!buf[0]) {
+    angband_fclose(fp);
+    close_headers();
+    for (size_t i = 0; i < corpus.headers.size(); i++) {
+        const auto &header = corpus.headers[i];
+        switch (header.kind) {
+        case RandomLineHeader::Kind::ALL:
+            corpus.first_all = corpus.first_all.value_or(i);
+            break;
+        case RandomLineHeader::Kind::MALE:
+            corpus.first_male = corpus.first_male.value_or(i);
+            break;
+        case RandomLineHeader::Kind::FEMALE:
+            corpus.first_female = corpus.first_female.value_or(i);
+            break;
+        case RandomLineHeader::Kind::NUMBER:
+            corpus.first_numbers.emplace(header.number, i);
+            break;
+        case RandomLineHeader::Kind::ERROR:
+            corpus.first_error = corpus.first_error.value_or(i);
             break;
         }
+    }
 
-        if (one_in_(counter + 1)) {
-            line = buf;
-        }
+    return &random_line_corpora.emplace(file_name, std::move(corpus)).first->second;
+}
+
+/*!
+ * @brief IDに一致するファイル内で最初のヘッダを探す
+ * @param corpus 索引付けしたファイル
+ * @param entry 特定条件時のN:タグヘッダID
+ * @return 一致したヘッダの添字 (なければnullopt)
+ * @details 男性・女性のヘッダはモンスターの性別を調べる必要がある時だけ参照する
+ */
+std::optional<size_t> find_random_line_header(const RandomLineCorpus &corpus, int entry)
+{
+    std::optional<size_t> found = corpus.first_all;
+    const auto is_before_found = [&found](std::optional<size_t> candidate) {
+        return candidate && (!found || (*candidate < *found));
+    };
+    if (is_before_found(corpus.first_error)) {
+        found = corpus.first_error;
+    }
 
-        counter++;
+    if (const auto it = corpus.first_numbers.find(entry); (it != corpus.first_numbers.end()) && is_before_found(it->second)) {
+        found = it->second;
+    }
+
+    if (is_before_found(corpus.first_male) && is_male(monraces_info[i2enum<MonsterRaceId>(entry)])) {
+        found = corpus.first_male;
+    }
+
+    if (is_before_found(corpus.first_female) && is_female(monraces_info[i2enum<MonsterRaceId>(entry)])) {
+        found = corpus.first_female;
+    }
+
+    return found;
+}
+}
+
+/*!
+ * @brief ファイルからランダムに行を一つ取得する
+ * @param file_name ファイル名
+ * @param entry 特定条件時のN:タグヘッダID
+ * @return ファイルから取得した行 (但しファイルがなかったり異常値ならばnullopt)
+ * @details ファイルは初回の呼び出し時に読み込んで索引付けし、以後はファイルを開かない.
+ * 候補行の選択は1行ずつ one_in_() で置き換える方式のままとし、乱数の消費も読み込み時と変えない.
+ */
+std::optional<std::string> get_random_line(concptr file_name, int entry)
+{
+    const auto *corpus = load_random_line_corpus(file_name);
+    if (corpus == nullptr) {
+        return std::nullopt;
+    }
+
+    const auto header_index = find_random_line_header(*corpus, entry);
+    if (!header_index) {
+        return std::nullopt;
+    }
+
+    const auto &header = corpus->headers[*header_index];
+    if (header.kind == RandomLineHeader::Kind::ERROR) {
+        msg_format("Error in line %d of %s!", header.line_num, file_name);
+        return std::nullopt;
+    }
+
+    std::optional<std::string> line{};
+    for (auto i = header.begin; i < header.end; i++) {
+        if (one_in_(static_cast<int>(i - header.begin) + 1)) {
+            line = corpus->lines[i];
+        }
     }
 
-    angband_fclose(fp);
     return line;
 }
 
@@ -0,0 +1,470 @@
+/*!
+ * @brief キーフレーム付きムービーの入出力
+ * @details 一定間隔で画面全体を描画するキーフレームを挟み、末尾にその索引を置くことで、
+ * 再生時に任意の時刻へキーフレーム間隔分の処理だけで移動できるようにする.
+ * 描画コマンドの書式は旧形式のムービーと共通.
+ * フレームの描画コマンド列は直前のブロックの描画コマンドを参照する差分として格納する.
+ */
+
+#include "io/movie-container.h"
+#include "system/angband.h"
+#include "util/angband-files.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+constexpr std::string_view MOVIE_INDEX_MAGIC("HMVI", 4);
+constexpr auto TRAILER_SIZE = 8;
+constexpr auto READ_CHUNK_SIZE = 65536;
+
+void append_varint(std::string &out, unsigned long value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back(static_cast<char>(value));
+}
+
+std::optional<unsigned long> parse_varint(std::string_view &in)
+{
+    unsigned long value = 0;
+    for (auto shift = 0; shift < 64; shift += 7) {
+        if (in.empty()) {
+            return std::nullopt;
+        }
+
+        const auto b = static_cast<uint8_t>(in.front());
+        in.remove_prefix(1);
+        value |= static_cast<unsigned long>(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) {
+            return value;
+        }
+    }
+
+    return std::nullopt;
+}
+
+/*!
+ * @brief 描画コマンド列を '\0' で分割する
+ * @details 分割したものを '\0' で繋げると元に戻る (末尾の '\0' の後ろは空のコマンドとして扱う)
+ */
+std::vector<std::string_view> split_records(std::string_view records)
+{
+    std::vector<std::string_view> commands;
+    while (true) {
+        const auto pos = records.find('\0');
+        if (pos == std::string_view::npos) {
+            commands.push_back(records);
+            return commands;
+        }
+
+        commands.push_back(records.substr(0, pos));
+        records.remove_prefix(pos + 1);
+    }
+}
+}
+
+/*!
+ * @brief 書き込みを開始する
+ * @param fd 書き込み先 (先頭から書き込む)
+ * @param keyframe_interval キーフレームを挟む間隔 (100ms単位)
+ */
+MovieContainerWriter::MovieContainerWriter(int fd, int keyframe_interval)
+    : fd(fd)
+    , keyframe_interval(keyframe_interval)
+{
+    fd_write(this->fd, MOVIE_CONTAINER_MAGIC.data(), MOVIE_CONTAINER_MAGIC.size());
+    this->offset = MOVIE_CONTAINER_MAGIC.size();
+}
+
+/*!
+ * @brief フレームを書き出す
+ * @param timestamp フレームの描画時刻
+ * @param records フレーム内の描画コマンド列
+ */
+void MovieContainerWriter::write_frame(int timestamp, std::string_view records)
+{
+    timestamp = std::max(timestamp, this->last_timestamp);
+    this->write_block(MovieBlockType::FRAME, timestamp - this->last_timestamp, encode_movie_frame_delta(this->last_records, records));
+    this->last_timestamp = timestamp;
+    this->last_records = records;
+}
+
+bool MovieContainerWriter::needs_keyframe(int timestamp) const
+{
+    return !this->last_keyframe_timestamp || (timestamp - *this->last_keyframe_timestamp >= this->keyframe_interval);
+}
+
+/*!
+ * @brief キーフレームを書き出す
+ * @param timestamp 直前のフレームの描画時刻
+ * @param records 画面全体を描画するコマンド列
+ */
+void MovieContainerWriter::add_keyframe(int timestamp, std::string_view records)
+{
+    timestamp = std::max(timestamp, this->last_timestamp);
+    this->index.emplace_back(timestamp, this->offset);
+    this->write_block(MovieBlockType::KEYFRAME, timestamp, records);
+    this->last_keyframe_timestamp = timestamp;
+    this->last_timestamp = timestamp;
+    this->last_records = records;
+}
+
+/*!
+ * @brief 索引とトレイラーを書き出して書き込みを終える
+ */
+void MovieContainerWriter::finish()
+{
+    std::string payload;
+    append_varint(payload, this->index.size());
+    auto prev_timestamp = 0;
+    auto prev_offset = 0L;
+    for (const auto &[timestamp, offset] : this->index) {
+        append_varint(payload, timestamp - prev_timestamp);
+        append_varint(payload, offset - prev_offset);
+        prev_timestamp = timestamp;
+        prev_offset = offset;
+    }
+
+    const auto index_offset = static_cast<uint32_t>(this->offset);
+    this->write_block(MovieBlockType::INDEX, 0, payload);
+
+    std::string trailer;
+    for (auto i = 0; i < 4; i++) {
+        trailer.push_back(static_cast<char>((index_offset >> (i * 8)) & 0xff));
+    }
+
+    trailer.append(MOVIE_INDEX_MAGIC);
+    fd_write(this->fd, trailer.data(), trailer.size());
+}
+
+void MovieContainerWriter::write_block(MovieBlockType type, int timestamp, std::string_view payload)
+{
+    const auto block = encode_movie_block(type, timestamp, payload);
+    fd_write(this->fd, block.data(), block.size());
+    this->offset += block.size();
+}
+
+/*!
+ * @brief 読み込みを開始する
+ * @param fd キーフレーム付きムービーのファイルディスクリプタ
+ * @details 索引が無い (録画が正常に終了しなかった) 場合は全体を走査して索引を作り直す.
+ */
+MovieContainerReader::MovieContainerReader(int fd)
+    : fd(fd)
+{
+    this->load_index();
+    this->seek(MOVIE_CONTAINER_MAGIC.size());
+    this->last_timestamp = 0;
+    this->last_records.clear();
+}
+
+/*!
+ * @brief ファイルがキーフレーム付きムービーかを判定する
+ * @details ファイル位置は先頭に戻す
+ */
+bool MovieContainerReader::is_container(int fd)
+{
+    char magic[MOVIE_CONTAINER_MAGIC.size()]{};
+    auto is_container = (fd_seek(fd, 0) == 0) && (fd_read(fd, magic, sizeof(magic)) == 0);
+    is_container &= std::string_view(magic, sizeof(magic)) == MOVIE_CONTAINER_MAGIC;
+    (void)fd_seek(fd, 0);
+    return is_container;
+}
+
+/*!
+ * @brief 次のブロックを読み込む
+ * @return フレームまたはキーフレーム. 終端に達した場合はnullopt
+ */
+std::optional<MovieBlock> MovieContainerReader::read_block()
+{
+    if (!this->fill(1)) {
+        return std::nullopt;
+    }
+
+    const auto type = static_cast<MovieBlockType>(this->buffer[this->buffer_pos++]);
+    if ((type != MovieBlockType::FRAME) && (type != MovieBlockType::KEYFRAME)) {
+        return std::nullopt;
+    }
+
+    const auto timestamp = this->read_varint();
+    const auto length = this->read_varint();
+    if (!timestamp || !length || !this->fill(*length)) {
+        return std::nullopt;
+    }
+
+    std::string payload(this->buffer.data() + this->buffer_pos, *length);
+    this->buffer_pos += *length;
+    if (type == MovieBlockType::KEYFRAME) {
+        this->last_timestamp = static_cast<int>(*timestamp);
+    } else {
+        auto records = decode_movie_frame_delta(this->last_records, payload);
+        if (!records) {
+            return std::nullopt;
+        }
+
+        payload = std::move(*records);
+        this->last_timestamp += static_cast<int>(*timestamp);
+    }
+
+    this->last_records = payload;
+    return MovieBlock{ type, this->last_timestamp, std::move(payload) };
+}
+
+/*!
+ * @brief 指定時刻以前で最後のキーフレームへ移動する
+ * @param timestamp 移動先の時刻
+ * @return 移動先のキーフレーム. キーフレームが無ければnullopt
+ * @details 以降の read_block() はキーフレームの次のブロックから読み込む
+ */
+std::optional<MovieBlock> MovieContainerReader::seek_keyframe(int timestamp)
+{
+    if (this->index.empty()) {
+        return std::nullopt;
+    }
+
+    auto it = std::upper_bound(this->index.begin(), this->index.end(), timestamp, [](int t, const auto &entry) { return t < entry.first; });
+    if (it != this->index.begin()) {
+        --it;
+    }
+
+    this->seek(it->second);
+    return this->read_block();
+}
+
+int MovieContainerReader::get_last_keyframe_timestamp() const
+{
+    return this->index.empty() ? 0 : this->index.back().first;
+}
+
+bool MovieContainerReader::fill(size_t size)
+{
+    while (this->buffer.size() - this->buffer_pos < size) {
+        if (this->buffer_pos > 0) {
+            this->buffer.erase(this->buffer.begin(), this->buffer.begin() + this->buffer_pos);
+            this->buffer_offset += this->buffer_pos;
+            this->buffer_pos = 0;
+        }
+
+        char chunk[READ_CHUNK_SIZE];
+        const auto read_size = read(this->fd, chunk, sizeof(chunk));
+        if (read_size <= 0) {
+            return false;
+        }
+
+        this->buffer.insert(this->buffer.end(), chunk, chunk + read_size);
+    }
+
+    return true;
+}
+
+std::optional<unsigned long> MovieContainerReader::read_varint()
+{
+    unsigned long value = 0;
+    for (auto shift = 0; shift < 64; shift += 7) {
+        if (!this->fill(1)) {
+            return std::nullopt;
+        }
+
+        const auto b = static_cast<uint8_t>(this->buffer[this->buffer_pos++]);
+        value |= static_cast<unsigned long>(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) {
+            return value;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void MovieContainerReader::seek(long offset)
+{
+    (void)fd_seek(this->fd, offset);
+    this->buffer.clear();
+    this->buffer_pos = 0;
+    this->buffer_offset = offset;
+}
+
+long MovieContainerReader::tell() const
+{
+    return this->buffer_offset + static_cast<long>(this->buffer_pos);
+}
+
+/*!
+ * @brief キーフレームの索引を読み込む
+ * @details トレイラーが壊れている場合は全ブロックを走査して作り直す
+ */
+void MovieContainerReader::load_index()
+{
+    this->index.clear();
+    const auto file_size = static_cast<long>(lseek(this->fd, 0, SEEK_END));
+    if (file_size >= static_cast<long>(MOVIE_CONTAINER_MAGIC.size()) + TRAILER_SIZE) {
+        this->seek(file_size - TRAILER_SIZE);
+        if (this->fill(TRAILER_SIZE) && (std::string_view(this->buffer.data() + 4, 4) == MOVIE_INDEX_MAGIC)) {
+            uint32_t index_offset = 0;
+            for (auto i = 0; i < 4; i++) {
+                index_offset |= static_cast<uint32_t>(static_cast<uint8_t>(this->buffer[i])) << (i * 8);
+            }
+
+            this->seek(index_offset);
+            std::optional<unsigned long> length;
+            if (this->fill(1) && (this->buffer[this->buffer_pos++] == static_cast<char>(MovieBlockType::INDEX)) && this->read_varint() && (length = this->read_varint()) && this->fill(*length)) {
+                std::string_view payload(this->buffer.data() + this->buffer_pos, *length);
+                auto count = parse_varint(payload);
+                auto timestamp = 0;
+                auto offset = 0L;
+                for (auto i = 0UL; count && (i < *count); i++) {
+                    const auto timestamp_delta = parse_varint(payload);
+                    const auto offset_delta = parse_varint(payload);
+                    if (!timestamp_delta || !offset_delta) {
+                        this->index.clear();
+                        break;
+                    }
+
+                    timestamp += static_cast<int>(*timestamp_delta);
+                    offset += static_cast<long>(*offset_delta);
+                    this->index.emplace_back(timestamp, offset);
+                }
+
+                if (count && (this->index.size() == *count)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    this->index.clear();
+    this->seek(MOVIE_CONTAINER_MAGIC.size());
+    while (true) {
+        const auto offset = this->tell();
+        const auto block = this->read_block();
+        if (!block) {
+            break;
+        }
+
+        if (block->type == MovieBlockType::KEYFRAME) {
+            this->index.emplace_back(block->timestamp, offset);
+        }
+    }
+}
+
+/*!
+ * @brief ブロック1件をバイト列に符号化する
+ * @param type ブロック種別
+ * @param timestamp FRAMEならば前ブロックとの差分、KEYFRAMEならば絶対値
+ * @param payload ペイロード
+ * @return 種別(1バイト) + タイムスタンプ(可変長整数) + ペイロード長(可変長整数) + ペイロード
+ */
+std::string encode_movie_block(MovieBlockType type, int timestamp, std::string_view payload)
+{
+    std::string block(1, static_cast<char>(type));
+    append_varint(block, timestamp);
+    append_varint(block, payload.size());
+    block.append(payload);
+    return block;
+}
+
+/*!
+ * @brief フレームの描画コマンド列を直前のブロックとの差分に符号化する
+ * @param base_records 直前のブロックの描画コマンド列
+ * @param records フレームの描画コマンド列
+ * @return 以下の組の列 (値は全て可変長整数).
+ * (0, 個数) + '\0' 終端のコマンド * 個数: 直前のブロックに無いコマンド
+ * (直前のブロックでの位置 + 1, 個数): 直前のブロックと同じ順番で連続するコマンド
+ */
+std::string encode_movie_frame_delta(std::string_view base_records, std::string_view records)
+{
+    const auto base_commands = split_records(base_records);
+    const auto commands = split_records(records);
+    std::unordered_map<std::string_view, size_t> base_positions;
+    for (size_t i = 0; i < base_commands.size(); i++) {
+        base_positions.emplace(base_commands[i], i);
+    }
+
+    std::string delta;
+    for (size_t i = 0; i < commands.size();) {
+        const auto it = base_positions.find(commands[i]);
+        if (it == base_positions.end()) {
+            auto end = i + 1;
+            while ((end < commands.size()) && !base_positions.contains(commands[end])) {
+                end++;
+            }
+
+            append_varint(delta, 0);
+            append_varint(delta, end - i);
+            for (; i < end; i++) {
+                delta.append(commands[i]);
+                delta.push_back('\0');
+            }
+
+            continue;
+        }
+
+        const auto start = it->second;
+        size_t run = 1;
+        while ((i + run < commands.size()) && (start + run < base_commands.size()) && (commands[i + run] == base_commands[start + run])) {
+            run++;
+        }
+
+        append_varint(delta, start + 1);
+        append_varint(delta, run);
+        i += run;
+    }
+
+    return delta;
+}
+
+/*!
+ * @brief 直前のブロックとの差分からフレームの描画コマンド列を復元する
+ * @param base_records 直前のブロックの描画コマンド列
+ * @param delta encode_movie_frame_delta() で符号化した差分
+ * @return 描画コマンド列. 差分が壊れていればnullopt
+ */
+std::optional<std::string> decode_movie_frame_delta(std::string_view base_records, std::string_view delta)
+{
+    const auto base_commands = split_records(base_records);
+    std::string records;
+    auto is_first = true;
+    const auto append_command = [&records, &is_first](std::string_view command) {
+        if (!is_first) {
+            records.push_back('\0');
+        }
+
+        records.append(command);
+        is_first = false;
+    };
+
+    while (!delta.empty()) {
+        const auto position = parse_varint(delta);
+        const auto size = parse_varint(delta);
+        if (!position || !size) {
+            return std::nullopt;
+        }
+
+        if (*position == 0) {
+            for (auto i = 0UL; i < *size; i++) {
+                const auto length = delta.find('\0');
+                if (length == std::string_view::npos) {
+                    return std::nullopt;
+                }
+
+                append_command(delta.substr(0, length));
+                delta.remove_prefix(length + 1);
+            }
+
+            continue;
+        }
+
+        const auto start = *position - 1;
+        if ((start >= base_commands.size()) || (*size > base_commands.size() - start)) {
+            return std::nullopt;
+        }
+
+        for (auto i = 0UL; i < *size; i++) {
+            append_command(base_commands[start + i]);
+        }
+    }
+
+    return records;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+constexpr std::string_view MOVIE_CONTAINER_MAGIC("HBMOVIE2", 8);
+
+/*!
+ * @brief キーフレーム付きムービーのブロック種別
+ */
+enum class MovieBlockType : char {
+    FRAME = 'F', //!< 前フレームからの差分描画 (タイムスタンプは前ブロックとの差分、描画コマンド列は前ブロックとの差分)
+    KEYFRAME = 'K', //!< 画面全体の描画 (タイムスタンプは絶対値)
+    INDEX = 'I', //!< キーフレームの索引 (ファイル末尾)
+};
+
+/*!
+ * @brief ムービーのブロック1件分
+ * @details payload は '\0' で区切られた描画コマンドの列 (FRAMEも差分を展開済のもの).
+ */
+struct MovieBlock {
+    MovieBlockType type;
+    int timestamp; //!< 録画開始からの経過時間 (100ms単位)
+    std::string payload;
+};
+
+/*!
+ * @brief キーフレーム付きムービーの書き込みクラス
+ * @details ファイル構造は以下の通り.
+ * ヘッダ (MOVIE_CONTAINER_MAGIC)
+ * ブロック * n: encode_movie_block() を参照
+ * 索引ブロック: キーフレームの(タイムスタンプ, オフセット)を差分符号化した列
+ * トレイラー: 索引ブロックのオフセット(4バイト) + MOVIE_INDEX_MAGIC
+ */
+class MovieContainerWriter {
+public:
+    MovieContainerWriter(int fd, int keyframe_interval);
+
+    void write_frame(int timestamp, std::string_view records);
+    bool needs_keyframe(int timestamp) const;
+    void add_keyframe(int timestamp, std::string_view records);
+    void finish();
+
+private:
+    int fd;
+    int keyframe_interval;
+    long offset = 0;
+    int last_timestamp = 0;
+    std::string last_records; //!< 直前のブロックの描画コマンド列 (フレームの差分の基準)
+    std::optional<int> last_keyframe_timestamp;
+    std::vector<std::pair<int, long>> index;
+
+    void write_block(MovieBlockType type, int timestamp, std::string_view payload);
+};
+
+/*!
+ * @brief キーフレーム付きムービーの読み込みクラス
+ */
+class MovieContainerReader {
+public:
+    explicit MovieContainerReader(int fd);
+
+    static bool is_container(int fd);
+    std::optional<MovieBlock> read_block();
+    std::optional<MovieBlock> seek_keyframe(int timestamp);
+    int get_last_keyframe_timestamp() const;
+
+private:
+    int fd;
+    std::vector<char> buffer;
+    size_t buffer_pos = 0;
+    long buffer_offset = 0; //!< buffer 先頭のファイル内オフセット
+    int last_timestamp = 0;
+    std::string last_records; //!< 直前のブロックの描画コマンド列 (フレームの差分の基準)
+    std::vector<std::pair<int, long>> index;
+
+    bool fill(size_t size);
+    std::optional<unsigned long> read_varint();
+    void seek(long offset);
+    void load_index();
+    long tell() const;
+};
+
+std::string encode_movie_block(MovieBlockType type, int timestamp, std::string_view payload);
+std::string encode_movie_frame_delta(std::string_view base_records, std::string_view records);
+std::optional<std::string> decode_movie_frame_delta(std::string_view base_records, std::string_view delta);
@@ -8,15 +8,20 @@
 #include "cmd-io/cmd-dump.h"
 #include "cmd-visual/cmd-draw.h"
 #include "core/asking-player.h"
+#include "io/chuukei-broadcaster.h"
 #include "io/files-util.h"
+#include "io/movie-container.h"
 #include "io/signal-handlers.h"
 #include "locale/japanese.h"
 #include "system/player-type-definition.h"
 #include "term/gameterm.h"
 #include "term/z-form.h"
 #include "util/angband-files.h"
+#include "util/int-char-converter.h"
 #include "view/display-messages.h"
 #include <algorithm>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <vector>
 
@@ -37,11 +42,19 @@
 #define RECVBUF_SIZE 1024
 /* 「n」、「t」、および「w」コマンドでは、長さが「signed char」に配置されるときに負の値を回避するために、これよりも長い長さを使用しないでください。 */
 static constexpr auto SPLIT_MAX = 127;
+static constexpr auto KEYFRAME_INTERVAL = 100; /* キーフレームを挟む間隔(100ms単位) */
+static constexpr auto FAST_FORWARD_SPEED = 16; /* 早送りの倍率 */
+static constexpr auto SEEK_STEP = 600; /* 1回のシークで移動する時間(100ms単位) */
+static constexpr auto KEYFRAME_REPEAT_MIN = 4; /* キーフレームで「n」コマンドにまとめる最短の繰り返し */
+static constexpr byte AF_TILE1 = 0x80; /* タイル描画される属性 (z-term.cpp と同じ値) */
 
 static long epoch_time; /* バッファ開始時刻 */
+static long movie_epoch_time; /* 録画開始時刻 */
 static int browse_delay; /* 表示するまでの時間(100ms単位)(この間にラグを吸収する) */
 static int movie_fd;
 static int movie_mode;
+static std::unique_ptr<MovieContainerWriter> movie_writer; /* キーフレーム付き形式で録画中ならば非null */
+static std::string frame_records; /* 録画・配信中のフレームに含まれる描画コマンド列 */
 
 /* 描画する時刻を覚えておくキュー構造体 */
 static struct {
@@ -67,8 +80,17 @@ static errr (*old_bigcurs_hook)(int x, int y);
 static errr (*old_wipe_hook)(int x, int y, int n);
 static errr (*old_text_hook)(int x, int y, int n, TERM_COLOR a, concptr s);
 
+static bool is_streaming_frames()
+{
+    return movie_writer || ChuukeiBroadcaster::get_instance().is_running();
+}
+
 static void disable_chuukei_server(void)
 {
+    if (ChuukeiBroadcaster::get_instance().is_running()) {
+        return;
+    }
+
     term_type *t = angband_terms[0];
     t->xtra_hook = old_xtra_hook;
     t->curs_hook = old_curs_hook;
@@ -107,6 +129,13 @@ static long get_current_time(void)
  */
 static errr insert_ringbuf(std::string_view header, std::string_view payload = "")
 {
+    if (is_streaming_frames()) {
+        frame_records.append(header);
+        frame_records.append(payload);
+        frame_records.push_back('\0');
+        return 0;
+    }
+
     if (movie_mode) {
         fd_write(movie_fd, header.data(), header.length());
         if (!payload.empty()) {
@@ -215,33 +244,36 @@ static int find_split(concptr str, int len)
 }
 #endif
 
-static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
+/*!
+ * @brief 文字列描画をコマンド列に変換する
+ * @param emit 変換したコマンドのヘッダとペイロードを受け取る関数
+ */
+template <typename F>
+static void encode_text_records(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str, F &&emit)
 {
     if (len == 1) {
-        insert_ringbuf(format("s%c%c%c%c", x + 1, y + 1, col, *str));
-        return (*old_text_hook)(x, y, len, col, str);
+        emit(format("s%c%c%c%c", x + 1, y + 1, col, *str), "");
+        return;
     }
 
     if (string_is_repeat(str, len)) {
         while (len > SPLIT_MAX) {
-            insert_ringbuf(format("n%c%c%c%c%c", x + 1, y + 1, SPLIT_MAX, col, *str));
+            emit(format("n%c%c%c%c%c", x + 1, y + 1, SPLIT_MAX, col, *str), "");
             x += SPLIT_MAX;
             len -= SPLIT_MAX;
         }
 
-        std::string formatted_text;
         if (len > 1) {
-            formatted_text = format("n%c%c%c%c%c", x + 1, y + 1, len, col, *str);
+            emit(format("n%c%c%c%c%c", x + 1, y + 1, len, col, *str), "");
         } else {
-            formatted_text = format("s%c%c%c%c", x + 1, y + 1, col, *str);
+            emit(format("s%c%c%c%c", x + 1, y + 1, col, *str), "");
         }
 
-        insert_ringbuf(formatted_text);
-        return (*old_text_hook)(x, y, len, col, str);
+        return;
     }
 
 #if defined(SJIS) && defined(JP)
-    std::string buffer = str; // strは書き換わって欲しくないのでコピーする.
+    std::string buffer(str, len); // strは書き換わって欲しくないのでコピーする.
     auto *payload = buffer.data();
     sjis2euc(payload);
 #else
@@ -249,16 +281,91 @@ static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_CO
 #endif
     while (len > SPLIT_MAX) {
         auto split_len = _(find_split(payload, SPLIT_MAX), SPLIT_MAX);
-        insert_ringbuf(format("t%c%c%c%c", x + 1, y + 1, split_len, col), std::string_view(payload, split_len));
+        emit(format("t%c%c%c%c", x + 1, y + 1, split_len, col), std::string_view(payload, split_len));
         x += split_len;
         len -= split_len;
         payload += split_len;
     }
 
-    insert_ringbuf(format("t%c%c%c%c", x + 1, y + 1, len, col), std::string_view(payload, len));
+    emit(format("t%c%c%c%c", x + 1, y + 1, len, col), std::string_view(payload, len));
+}
+
+static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
+{
+    encode_text_records(x, y, len, col, str, [](std::string_view header, std::string_view payload) { insert_ringbuf(header, payload); });
     return (*old_text_hook)(x, y, len, col, str);
 }
 
+/*!
+ * @brief 現在の画面全体を描画するコマンド列を作る
+ * @return '\0' 区切りのコマンド列
+ * @details 画面消去の後、属性が同じ連続区間ごとに描画する. 同じ文字の長い繰り返しは「n」コマンドにまとめる.
+ */
+static std::string make_keyframe_records()
+{
+    std::string records;
+    const auto emit = [&records](std::string_view header, std::string_view payload) {
+        records.append(header);
+        records.append(payload);
+        records.push_back('\0');
+    };
+
+    emit(format("x%c", TERM_XTRA_CLEAR + 1), "");
+    const auto *t0 = angband_terms[0];
+    const auto &screen = t0->old;
+    for (auto y = 0; y < t0->hgt; y++) {
+        const auto &aa = screen->a[y];
+        const auto &cc = screen->c[y];
+        auto x = 0;
+        while (x < t0->wid) {
+            const auto col = aa[x];
+            if ((col & AF_TILE1) || (cc[x] == ' ')) {
+                x++;
+                continue;
+            }
+
+            auto end = x;
+            auto literal_start = x;
+            while ((end < t0->wid) && (aa[end] == col) && (cc[end] != ' ')) {
+                auto repeat_end = end + 1;
+#ifdef JP
+                const auto is_kanji = iskanji(cc[end]);
+#else
+                const auto is_kanji = false;
+#endif
+                if (is_kanji) {
+                    end += 2;
+                    continue;
+                }
+
+                while ((repeat_end < t0->wid) && (aa[repeat_end] == col) && (cc[repeat_end] == cc[end])) {
+                    repeat_end++;
+                }
+
+                if (repeat_end - end >= KEYFRAME_REPEAT_MIN) {
+                    if (end > literal_start) {
+                        encode_text_records(literal_start, y, end - literal_start, col, &cc[literal_start], emit);
+                    }
+
+                    encode_text_records(end, y, repeat_end - end, col, &cc[end], emit);
+                    literal_start = repeat_end;
+                }
+
+                end = repeat_end;
+            }
+
+            end = std::min<int>(end, t0->wid);
+            if (end > literal_start) {
+                encode_text_records(literal_start, y, end - literal_start, col, &cc[literal_start], emit);
+            }
+
+            x = end;
+        }
+    }
+
+    return records;
+}
+
 static errr send_wipe_to_chuukei_server(int x, int y, int len)
 {
     while (len > SPLIT_MAX) {
@@ -271,13 +378,54 @@ static errr send_wipe_to_chuukei_server(int x, int y, int len)
     return (*old_wipe_hook)(x, y, len);
 }
 
+/*!
+ * @brief 溜めたフレームを録画・配信先へ送り、必要ならばキーフレームも送る
+ * @param current_time フレームの描画時刻 (get_current_time() の値)
+ * @details キーフレームの描画コマンド列は録画と配信で共有する.
+ * 描画時刻は録画では録画開始から、配信では配信開始からの経過時間とする.
+ */
+static void send_frame(long current_time)
+{
+    auto &broadcaster = ChuukeiBroadcaster::get_instance();
+    const auto movie_timestamp = static_cast<int>(current_time - movie_epoch_time);
+    const auto broadcast_timestamp = static_cast<int>(current_time - epoch_time);
+    if (movie_writer) {
+        movie_writer->write_frame(movie_timestamp, frame_records);
+    }
+
+    if (broadcaster.is_running()) {
+        broadcaster.post_frame(broadcast_timestamp, frame_records);
+    }
+
+    frame_records.clear();
+    const auto is_keyframe_written = movie_writer && movie_writer->needs_keyframe(movie_timestamp);
+    const auto is_keyframe_broadcasted = broadcaster.is_running() && broadcaster.consume_keyframe_request();
+    if (!is_keyframe_written && !is_keyframe_broadcasted) {
+        return;
+    }
+
+    const auto keyframe = make_keyframe_records();
+    if (is_keyframe_written) {
+        movie_writer->add_keyframe(movie_timestamp, keyframe);
+    }
+
+    if (is_keyframe_broadcasted) {
+        broadcaster.post_keyframe(broadcast_timestamp, keyframe);
+    }
+}
+
 static errr send_xtra_to_chuukei_server(int n, int v)
 {
     if (n == TERM_XTRA_CLEAR || n == TERM_XTRA_FRESH || n == TERM_XTRA_SHAPE) {
         insert_ringbuf(format("x%c", n + 1));
 
         if (n == TERM_XTRA_FRESH) {
-            insert_ringbuf("d", std::to_string(get_current_time() - epoch_time));
+            const auto current_time = get_current_time();
+            if (is_streaming_frames()) {
+                send_frame(current_time);
+            } else {
+                insert_ringbuf("d", std::to_string(current_time - epoch_time));
+            }
         }
     }
 
@@ -309,6 +457,9 @@ static errr send_bigcurs_to_chuukei_server(int x, int y)
 void prepare_chuukei_hooks(void)
 {
     term_type *t0 = angband_terms[0];
+    if (t0->text_hook == send_text_to_chuukei_server) {
+        return;
+    }
 
     /* Save original z-term hooks */
     old_xtra_hook = t0->xtra_hook;
@@ -325,6 +476,24 @@ void prepare_chuukei_hooks(void)
     t0->text_hook = send_text_to_chuukei_server;
 }
 
+/*!
+ * @brief 中継(観戦)用のライブ配信を開始する
+ * @param port 待ち受けるTCPポート番号
+ * @param address 待ち受けるIPv4アドレス. 空ならばループバックアドレスのみで待ち受ける
+ * @return 開始できればtrue
+ */
+bool prepare_chuukei_server(uint16_t port, std::string_view address)
+{
+    if (!ChuukeiBroadcaster::get_instance().start(port, address)) {
+        return false;
+    }
+
+    epoch_time = get_current_time();
+
+    prepare_chuukei_hooks();
+    return true;
+}
+
 /*
  * Prepare z-term hooks to call send_*_to_chuukei_server()'s
  */
@@ -335,6 +504,12 @@ void prepare_movie_hooks(PlayerType *player_ptr)
     if (movie_mode) {
         movie_mode = 0;
         disable_chuukei_server();
+        movie_writer->finish();
+        movie_writer.reset();
+        if (!is_streaming_frames()) {
+            frame_records.clear();
+        }
+
         fd_close(movie_fd);
         msg_print(_("録画を終了しました。", "Stopped recording."));
         return;
@@ -372,6 +547,9 @@ void prepare_movie_hooks(PlayerType *player_ptr)
     }
 
     movie_mode = 1;
+    movie_epoch_time = get_current_time();
+
+    movie_writer = std::make_unique<MovieContainerWriter>(movie_fd, KEYFRAME_INTERVAL);
     prepare_chuukei_hooks();
     do_cmd_redraw(player_ptr);
 }
@@ -517,6 +695,87 @@ static void update_term_size(int x, int y, int len)
     }
 }
 
+/*!
+ * @brief 描画コマンドを1件実行する
+ * @param buf '\0' で終端された描画コマンド (「n」コマンドの展開に使うため書き換わる)
+ */
+static void draw_movie_record(char *buf)
+{
+    auto id = buf[0];
+    auto x = static_cast<uint8_t>(buf[1]) - 1;
+    auto y = static_cast<uint8_t>(buf[2]) - 1;
+    int len = static_cast<uint8_t>(buf[3]);
+    uint8_t col = buf[4];
+    char *mesg;
+    if (id == 's') {
+        col = buf[3];
+        mesg = &buf[4];
+    } else {
+        mesg = &buf[5];
+    }
+#ifndef WINDOWS
+    win2unix(col, mesg);
+#endif
+
+    switch (id) {
+    case 't': /* 通常 */
+#if defined(SJIS) && defined(JP)
+        euc2sjis(mesg);
+#endif
+        update_term_size(x, y, len);
+        (void)((*angband_terms[0]->text_hook)(x, y, len, (byte)col, mesg));
+        std::copy_n(mesg, len, &game_term->scr->c[y][x]);
+        for (auto i = x; i < x + len; i++) {
+            game_term->scr->a[y][i] = col;
+        }
+
+        break;
+    case 'n': /* 繰り返し */
+        for (auto i = 1; i < len + 1; i++) {
+            if (i == len) {
+                mesg[i] = '\0';
+                break;
+            }
+
+            mesg[i] = mesg[0];
+        }
+
+        update_term_size(x, y, len);
+        (void)((*angband_terms[0]->text_hook)(x, y, len, (byte)col, mesg));
+        std::copy_n(mesg, len, &game_term->scr->c[y][x]);
+        for (auto i = x; i < x + len; i++) {
+            game_term->scr->a[y][i] = col;
+        }
+
+        break;
+    case 's': /* 一文字 */
+        update_term_size(x, y, 1);
+        (void)((*angband_terms[0]->text_hook)(x, y, 1, (byte)col, mesg));
+        std::copy_n(&game_term->scr->c[y][x], 1, mesg);
+        game_term->scr->a[y][x] = col;
+        break;
+    case 'w':
+        update_term_size(x, y, len);
+        (void)((*angband_terms[0]->wipe_hook)(x, y, len));
+        break;
+    case 'x':
+        if (x == TERM_XTRA_CLEAR) {
+            term_clear();
+        }
+
+        (void)((*angband_terms[0]->xtra_hook)(x, 0));
+        break;
+    case 'c':
+        update_term_size(x, y, 1);
+        (void)((*angband_terms[0]->curs_hook)(x, y));
+        break;
+    case 'C':
+        update_term_size(x, y, 1);
+        (void)((*angband_terms[0]->bigcurs_hook)(x, y));
+        break;
+    }
+}
+
 static bool flush_ringbuf_client()
 {
     /* 書くデータなし */
@@ -532,79 +791,7 @@ static bool flush_ringbuf_client()
     /* 時間情報(区切り)が得られるまで書く */
     char buf[1024]{};
     while (get_nextbuf(buf)) {
-        auto id = buf[0];
-        auto x = static_cast<uint8_t>(buf[1]) - 1;
-        auto y = static_cast<uint8_t>(buf[2]) - 1;
-        int len = static_cast<uint8_t>(buf[3]);
-        uint8_t col = buf[4];
-        char *mesg;
-        if (id == 's') {
-            col = buf[3];
-            mesg = &buf[4];
-        } else {
-            mesg = &buf[5];
-        }
-#ifndef WINDOWS
-        win2unix(col, mesg);
-#endif
-
-        switch (id) {
-        case 't': /* 通常 */
-#if defined(SJIS) && defined(JP)
-            euc2sjis(mesg);
-#endif
-            update_term_size(x, y, len);
-            (void)((*angband_terms[0]->text_hook)(x, y, len, (byte)col, mesg));
-            std::copy_n(mesg, len, &game_term->scr->c[y][x]);
-            for (auto i = x; i < x + len; i++) {
-                game_term->scr->a[y][i] = col;
-            }
-
-            break;
-        case 'n': /* 繰り返し */
-            for (auto i = 1; i < len + 1; i++) {
-                if (i == len) {
-                    mesg[i] = '\0';
-                    break;
-                }
-
-                mesg[i] = mesg[0];
-            }
-
-            update_term_size(x, y, len);
-            (void)((*angband_terms[0]->text_hook)(x, y, len, (byte)col, mesg));
-            std::copy_n(mesg, len, &game_term->scr->c[y][x]);
-            for (auto i = x; i < x + len; i++) {
-                game_term->scr->a[y][i] = col;
-            }
-
-            break;
-        case 's': /* 一文字 */
-            update_term_size(x, y, 1);
-            (void)((*angband_terms[0]->text_hook)(x, y, 1, (byte)col, mesg));
-            std::copy_n(&game_term->scr->c[y][x], 1, mesg);
-            game_term->scr->a[y][x] = col;
-            break;
-        case 'w':
-            update_term_size(x, y, len);
-            (void)((*angband_terms[0]->wipe_hook)(x, y, len));
-            break;
-        case 'x':
-            if (x == TERM_XTRA_CLEAR) {
-                term_clear();
-            }
-
-            (void)((*angband_terms[0]->xtra_hook)(x, 0));
-            break;
-        case 'c':
-            update_term_size(x, y, 1);
-            (void)((*angband_terms[0]->curs_hook)(x, y));
-            break;
-        case 'C':
-            update_term_size(x, y, 1);
-            (void)((*angband_terms[0]->bigcurs_hook)(x, y));
-            break;
-        }
+        draw_movie_record(buf);
     }
 
     fresh_queue.next++;
@@ -620,12 +807,128 @@ void prepare_browse_movie_without_path_build(const std::filesystem::path &path)
     init_buffer();
 }
 
+/*!
+ * @brief '\0' 区切りの描画コマンド列を実行する
+ */
+static void draw_movie_records(std::string_view records)
+{
+    while (!records.empty()) {
+        const auto length = std::min(records.find('\0'), records.length());
+        char buf[1024]{};
+        std::copy_n(records.begin(), std::min<size_t>(length, sizeof(buf) - 1), buf);
+        draw_movie_record(buf);
+        records.remove_prefix(std::min(length + 1, records.length()));
+    }
+}
+
+/*!
+ * @brief キーフレーム付きムービーを再生する
+ * @details 再生中に以下のキーを受け付ける.
+ * 「<」「>」: 前後へシーク / 「f」: 早送りの切り替え / スペース: 一時停止の切り替え / 「q」・ESC: 終了
+ * シークは目標時刻以前で最後のキーフレームを描画し、目標時刻までのフレームを待たずに描画する.
+ */
+static void browse_keyframed_movie()
+{
+    MovieContainerReader reader(movie_fd);
+    auto speed = 1;
+    auto is_paused = false;
+    auto base_movie_time = 0L;
+    auto base_clock = get_current_time();
+    const auto get_movie_time = [&] {
+        return is_paused ? base_movie_time : base_movie_time + (get_current_time() - base_clock) * speed;
+    };
+    const auto reset_clock = [&](long movie_time) {
+        base_movie_time = movie_time;
+        base_clock = get_current_time();
+    };
+
+    auto block = reader.read_block();
+    if (block) {
+        /* 配信を途中から受信したものは開始時刻が0ではない */
+        reset_clock(block->timestamp);
+    }
+
+    auto is_screen_drawn = false;
+    while (block) {
+        char ch;
+        while (term_inkey(&ch, false, true) == 0) {
+            const auto movie_time = get_movie_time();
+            switch (ch) {
+            case ESCAPE:
+            case 'q':
+                return;
+            case 'f':
+                reset_clock(movie_time);
+                speed = (speed == 1) ? FAST_FORWARD_SPEED : 1;
+                break;
+            case ' ':
+                reset_clock(movie_time);
+                is_paused = !is_paused;
+                break;
+            case '<':
+            case '>': {
+                const auto target = std::max(0L, movie_time + ((ch == '>') ? SEEK_STEP : -SEEK_STEP));
+                const auto keyframe = reader.seek_keyframe(target);
+                if (!keyframe) {
+                    break;
+                }
+
+                draw_movie_records(keyframe->payload);
+                is_screen_drawn = true;
+                block = reader.read_block();
+                while (block && (block->timestamp <= target)) {
+                    if (block->type == MovieBlockType::FRAME) {
+                        draw_movie_records(block->payload);
+                    }
+
+                    block = reader.read_block();
+                }
+
+                term_fresh();
+                reset_clock(target);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        if (!block) {
+            break;
+        }
+
+        /* 連続して再生している間は画面が既に一致しているので不要. 配信を途中から受信したものは最初のキーフレームから描画する */
+        if ((block->type == MovieBlockType::KEYFRAME) && is_screen_drawn) {
+            block = reader.read_block();
+            continue;
+        }
+
+        if (block->timestamp > get_movie_time()) {
+#ifdef WINDOWS
+            Sleep(WAIT);
+#else
+            usleep(WAIT);
+#endif
+            continue;
+        }
+
+        draw_movie_records(block->payload);
+        is_screen_drawn = true;
+        block = reader.read_block();
+    }
+}
+
 void browse_movie(void)
 {
     term_clear();
     term_fresh();
     term_xtra(TERM_XTRA_REACT, 0);
 
+    if (MovieContainerReader::is_container(movie_fd)) {
+        browse_keyframed_movie();
+        return;
+    }
+
     while (read_movie_file() == 0) {
         while (fresh_queue.next != fresh_queue.tail) {
             if (!flush_ringbuf_client()) {
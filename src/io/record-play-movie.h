@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <string_view>
 
 class PlayerType;
 void prepare_movie_hooks(PlayerType *player_ptr);
+bool prepare_chuukei_server(uint16_t port, std::string_view address);
 void prepare_browse_movie_without_path_build(const std::filesystem::path &path);
 void browse_movie();
 #ifndef WINDOWS
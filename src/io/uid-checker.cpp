@@ -65,3 +65,22 @@ void safe_setuid_grab()
 #else
 #endif
 }
+
+/*!
+ * @brief 権限の取得/放棄によって実効IDが切り替わるかを判定する
+ * @return setuid/setgidされた実行形式として動作しているならばtrue
+ * @details 権限の切り替えはプロセス全体に作用するため、ゲームスレッド以外でファイルを操作してよいかの判定に用いる.
+ */
+bool is_setuid_privileged()
+{
+#if defined(SET_UID) && defined(SAFE_SETUID)
+#ifdef SAFE_SETUID_POSIX
+    const auto &ids = UnixUserIds::get_instance();
+    return (ids.get_effective_user_id() != static_cast<int>(getuid())) || (ids.get_effective_group_id() != static_cast<int>(getgid()));
+#else
+    return (geteuid() != getuid()) || (getegid() != getgid());
+#endif
+#else
+    return false;
+#endif
+}
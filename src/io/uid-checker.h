@@ -2,3 +2,4 @@
 
 void safe_setuid_drop();
 void safe_setuid_grab();
+bool is_setuid_privileged();
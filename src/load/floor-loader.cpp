@@ -199,6 +199,8 @@ errr rd_saved_floor(PlayerType *player_ptr, saved_floor_type *sf_ptr)
         m_ptr->get_real_monrace().cur_num++;
     }
 
+    floor_ptr->monster_index.invalidate();
+
     return 0;
 }
 
@@ -768,6 +768,8 @@ errr rd_dungeon_old(PlayerType *player_ptr)
         m_ptr->get_real_monrace().cur_num++;
     }
 
+    floor_ptr->monster_index.invalidate();
+
     if (h_older_than(0, 3, 13) && !floor_ptr->dun_level && !floor_ptr->inside_arena) {
         w_ptr->character_dungeon = false;
     } else {
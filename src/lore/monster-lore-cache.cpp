@@ -0,0 +1,99 @@
+/*!
+ * @brief モンスターの思い出の文章のキャッシュ
+ */
+
+#include "lore/monster-lore-cache.h"
+#include "game-option/birth-options.h"
+#include "game-option/cheat-options.h"
+#include "game-option/text-display-options.h"
+#include "lore/monster-lore.h"
+#include "monster-race/monster-race.h"
+#include "system/player-type-definition.h"
+#include "util/finalizer.h"
+#include <algorithm>
+
+MonsterLoreCache MonsterLoreCache::instance{};
+
+MonsterLoreCache &MonsterLoreCache::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief モンスターの思い出を hook_c_roff に出力する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param r_idx モンスターの種族ID
+ * @param mode 表示オプション
+ * @details 出力内容は process_monster_lore() と同じ. キャッシュが古ければ作り直してから出力する
+ */
+void MonsterLoreCache::output(PlayerType *player_ptr, MonsterRaceId r_idx, monster_lore_mode mode)
+{
+    auto signature = create_signature(player_ptr, r_idx);
+    const auto key = std::make_pair(r_idx, mode);
+    auto it = this->entries.find(key);
+    if ((it == this->entries.end()) || (it->second.signature != signature)) {
+        Entry entry{ std::move(signature), {} };
+        const auto hook = hook_c_roff;
+        this->recording = &entry.segments;
+        hook_c_roff = record;
+        const auto finalizer = util::make_finalizer([this, hook] {
+            hook_c_roff = hook;
+            this->recording = nullptr;
+        });
+        process_monster_lore(player_ptr, r_idx, mode);
+        it = this->entries.insert_or_assign(key, std::move(entry)).first;
+    }
+
+    for (const auto &[attr, str] : it->second.segments) {
+        hook_c_roff(attr, str);
+    }
+}
+
+/*!
+ * @brief 思い出の内容を左右する現在の値を集める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param r_idx モンスターの種族ID
+ */
+MonsterLoreCache::Signature MonsterLoreCache::create_signature(PlayerType *player_ptr, MonsterRaceId r_idx)
+{
+    const auto &monrace = monraces_info[r_idx];
+    Signature signature;
+    signature.max_num = monrace.max_num;
+    signature.r_sights = monrace.r_sights;
+    signature.r_deaths = monrace.r_deaths;
+    signature.r_pkills = monrace.r_pkills;
+    signature.r_akills = monrace.r_akills;
+    signature.r_tkills = monrace.r_tkills;
+    signature.r_wake = monrace.r_wake;
+    signature.r_ignore = monrace.r_ignore;
+    signature.r_can_evolve = monrace.r_can_evolve;
+    signature.r_drop_gold = monrace.r_drop_gold;
+    signature.r_drop_item = monrace.r_drop_item;
+    signature.r_cast_spell = monrace.r_cast_spell;
+    std::copy(std::begin(monrace.r_blows), std::end(monrace.r_blows), signature.r_blows.begin());
+    signature.r_flags1 = monrace.r_flags1;
+    signature.r_flags2 = monrace.r_flags2;
+    signature.r_flags3 = monrace.r_flags3;
+    signature.r_ability_flags = monrace.r_ability_flags;
+    signature.r_aura_flags = monrace.r_aura_flags;
+    signature.r_behavior_flags = monrace.r_behavior_flags;
+    signature.r_kind_flags = monrace.r_kind_flags;
+    signature.r_resistance_flags = monrace.r_resistance_flags;
+    signature.r_drop_flags = monrace.r_drop_flags;
+    signature.r_feature_flags = monrace.r_feature_flags;
+    signature.lev = player_ptr->lev;
+    signature.max_plv = player_ptr->max_plv;
+    if (monrace.ability_flags.has(MonsterAbilityType::HAND_DOOM)) {
+        signature.doom_hp = player_ptr->chp;
+    }
+
+    signature.cheat_know = cheat_know;
+    signature.ironman_nightmare = ironman_nightmare;
+    signature.depth_in_feet = depth_in_feet;
+    return signature;
+}
+
+void MonsterLoreCache::record(TERM_COLOR attr, std::string_view str)
+{
+    instance.recording->push_back({ attr, std::string(str) });
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "lore/lore-util.h"
+#include "system/angband.h"
+#include "system/monster-race-info.h"
+#include "util/flag-group.h"
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class MonsterRaceId : int16_t;
+class PlayerType;
+
+/*!
+ * @brief モンスターの思い出の文章をキャッシュするクラス
+ * @details 戦闘中は思い出のサブウィンドウが同じ種族の思い出を何度も描き直すので、
+ * process_monster_lore() が出力した文字列を種族・表示モードごとに保存しておき、
+ * 思い出の内容を左右する値が変わっていなければ保存した文字列を出力し直すだけにする.
+ * 折り返しは出力し直す時に行うので、ウィンドウの幅が変わっても作り直す必要はない.
+ */
+class MonsterLoreCache {
+public:
+    MonsterLoreCache(const MonsterLoreCache &) = delete;
+    MonsterLoreCache(MonsterLoreCache &&) = delete;
+    MonsterLoreCache &operator=(const MonsterLoreCache &) = delete;
+    MonsterLoreCache &operator=(MonsterLoreCache &&) = delete;
+    ~MonsterLoreCache() = default;
+
+    static MonsterLoreCache &get_instance();
+    void output(PlayerType *player_ptr, MonsterRaceId r_idx, monster_lore_mode mode);
+
+private:
+    MonsterLoreCache() = default;
+
+    struct Segment {
+        TERM_COLOR attr;
+        std::string str;
+    };
+
+    /*!
+     * @brief 思い出の内容を左右する値
+     * @details 種族の r_* (プレイヤーが知り得た情報) とプレイヤーのレベル等. 全て一致すれば同じ文章が出力される
+     */
+    struct Signature {
+        MONSTER_NUMBER max_num = 0;
+        MONSTER_NUMBER r_sights = 0;
+        MONSTER_NUMBER r_deaths = 0;
+        MONSTER_NUMBER r_pkills = 0;
+        MONSTER_NUMBER r_akills = 0;
+        MONSTER_NUMBER r_tkills = 0;
+        byte r_wake = 0;
+        byte r_ignore = 0;
+        bool r_can_evolve = false;
+        ITEM_NUMBER r_drop_gold = 0;
+        ITEM_NUMBER r_drop_item = 0;
+        byte r_cast_spell = 0;
+        std::array<byte, MAX_NUM_BLOWS> r_blows{};
+        uint32_t r_flags1 = 0;
+        uint32_t r_flags2 = 0;
+        uint32_t r_flags3 = 0;
+        EnumClassFlagGroup<MonsterAbilityType> r_ability_flags;
+        EnumClassFlagGroup<MonsterAuraType> r_aura_flags;
+        EnumClassFlagGroup<MonsterBehaviorType> r_behavior_flags;
+        EnumClassFlagGroup<MonsterKindType> r_kind_flags;
+        EnumClassFlagGroup<MonsterResistanceType> r_resistance_flags;
+        EnumClassFlagGroup<MonsterDropType> r_drop_flags;
+        EnumClassFlagGroup<MonsterFeatureType> r_feature_flags;
+        PLAYER_LEVEL lev = 0;
+        PLAYER_LEVEL max_plv = 0;
+        int doom_hp = 0; //!< 破滅の手の威力に関わるプレイヤーの現在HP (破滅の手を使わない種族では常に0)
+        bool cheat_know = false;
+        bool ironman_nightmare = false;
+        bool depth_in_feet = false;
+
+        bool operator==(const Signature &other) const = default;
+    };
+
+    struct Entry {
+        Signature signature;
+        std::vector<Segment> segments;
+    };
+
+    static MonsterLoreCache instance;
+    std::map<std::pair<MonsterRaceId, monster_lore_mode>, Entry> entries;
+    std::vector<Segment> *recording = nullptr;
+
+    static Signature create_signature(PlayerType *player_ptr, MonsterRaceId r_idx);
+    static void record(TERM_COLOR attr, std::string_view str);
+};
@@ -171,9 +171,14 @@
 #include "term/term-color-types.h"
 #include "term/z-form.h"
 #include "util/angband-files.h"
+#include "util/spsc-queue.h"
 #include "view/display-map.h"
 
 #ifdef USE_GCU
+#include <algorithm>
+#include <atomic>
+#include <poll.h>
+#include <thread>
 
 /*
  * Hack -- play games with "bool"
@@ -370,6 +375,64 @@ static int colortable[16];
  */
 static int bg_color = COLOR_BLACK;
 
+/*
+ * Threaded input ("-- -i").  A dedicated thread reads stdin and hands the
+ * bytes to the game thread through a lock-free queue, so the non-blocking
+ * key checks made while resting, running or repeating cost no system calls.
+ * A '\0' in the queue means stdin is broken (NULs are never valid keys).
+ */
+static bool use_input_thread = false;
+static SpscQueue<char, 1024> input_queue;
+static std::atomic<bool> is_input_paused = false;
+static std::atomic<bool> is_input_stopping = false;
+static int input_wakeup_pipe[2] = { -1, -1 };
+static std::thread input_thread;
+
+/*
+ * Wake the input thread up from poll()
+ * The pipe is non-blocking, and a full pipe already holds a pending wakeup.
+ * Returns false if no wakeup could be queued.
+ */
+static bool wake_input_thread()
+{
+    while (write(input_wakeup_pipe[1], "", 1) < 0) {
+        if (errno == EAGAIN) {
+            return true;
+        }
+
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Discard the wakeups queued in the pipe
+ */
+static void drain_input_wakeups()
+{
+    char buf[16];
+    while (true) {
+        const auto len = read(input_wakeup_pipe[0], buf, sizeof(buf));
+        if ((len > 0) || ((len < 0) && (errno == EINTR))) {
+            continue;
+        }
+
+        return;
+    }
+}
+
+#ifdef JP
+/*
+ * The start of a UTF-8 character whose remaining bytes have not been read
+ * yet.  It is converted together with the following input.
+ */
+static char utf8_tail[4];
+static int utf8_tail_len = 0;
+#endif
+
 #endif
 
 /*
@@ -532,6 +595,14 @@ static void keymap_game_prepare(void)
 static errr game_term_xtra_gcu_alive(int v)
 {
     if (!v) {
+        /* Stop stealing keys from the shell */
+        if (use_input_thread) {
+            is_input_paused = true;
+            if (!wake_input_thread()) {
+                plog("Failed to wake the input thread up");
+            }
+        }
+
         /* Go to normal keymap mode */
         keymap_norm();
 
@@ -562,6 +633,12 @@ static errr game_term_xtra_gcu_alive(int v)
 
         /* Go to angband keymap mode */
         keymap_game();
+
+        /* Read keys again */
+        if (use_input_thread) {
+            is_input_paused = false;
+            is_input_paused.notify_one();
+        }
     }
 
     return 0;
@@ -857,6 +934,191 @@ static errr game_term_xtra_gcu_event(int v)
 
 #endif /* USE_GETCH */
 
+/*
+ * Pass a byte read from stdin to the game thread
+ */
+static void input_queue_push(char c)
+{
+    while (!input_queue.push(c)) {
+        if (is_input_stopping) {
+            return;
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+/*
+ * The body of the input thread
+ */
+static void read_input_thread()
+{
+    while (true) {
+        is_input_paused.wait(true);
+        if (is_input_stopping) {
+            return;
+        }
+
+        pollfd fds[2] = { { 0, POLLIN, 0 }, { input_wakeup_pipe[0], POLLIN, 0 } };
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            drain_input_wakeups();
+            if (is_input_stopping) {
+                return;
+            }
+
+            continue;
+        }
+
+        if (is_input_paused || !fds[0].revents) {
+            continue;
+        }
+
+        char buf[256];
+        auto len = read(0, buf, sizeof(buf));
+        if ((len < 0) && (errno == EINTR)) {
+            continue;
+        }
+
+        if (len <= 0) {
+            break;
+        }
+
+        for (auto i = 0; i < len; i++) {
+            if (buf[i]) {
+                input_queue_push(buf[i]);
+            }
+        }
+    }
+
+    /* Broken input is special */
+    input_queue_push('\0');
+}
+
+#ifdef JP
+/*
+ * Count the bytes of an incomplete UTF-8 character at the end of a buffer
+ */
+static int count_incomplete_utf8_tail(const char *buf, int len)
+{
+    for (auto i = 1; (i <= 3) && (i <= len); i++) {
+        const auto c = static_cast<unsigned char>(buf[len - i]);
+        if ((c & 0xc0) == 0x80) {
+            continue;
+        }
+
+        const auto char_len = (c >= 0xf0) ? 4 : (c >= 0xe0) ? 3 : (c >= 0xc0) ? 2 : 1;
+        return (char_len > i) ? i : 0;
+    }
+
+    return 0;
+}
+#endif
+
+/*
+ * Process events queued by the input thread, with optional wait
+ */
+static errr game_term_xtra_gcu_event_threaded(int v)
+{
+    if (v) {
+        input_queue.wait();
+    }
+
+    char buf[256];
+    char *bp = buf;
+#ifdef JP
+    /* Resume the character split by the previous read */
+    std::copy_n(utf8_tail, utf8_tail_len, buf);
+    bp += utf8_tail_len;
+#endif
+    const auto *bp_start = bp;
+    while (bp != &buf[255]) {
+        auto key = input_queue.pop();
+        if (!key) {
+            break;
+        }
+
+        if (*key == '\0') {
+            exit_game_panic(p_ptr);
+        }
+
+        *bp++ = *key;
+    }
+
+    /* None ready */
+    if (bp == bp_start) {
+        return 1;
+    }
+
+#ifdef JP
+    /* Keep a character whose remaining bytes are still on the way */
+    utf8_tail_len = count_incomplete_utf8_tail(buf, static_cast<int>(bp - buf));
+    bp -= utf8_tail_len;
+    std::copy_n(bp, utf8_tail_len, utf8_tail);
+    if (bp == buf) {
+        return 1;
+    }
+#endif
+
+    *bp = '\0';
+#ifdef JP
+    char eucbuf[sizeof(buf)];
+    /* strlen + 1 を渡して文字列終端('\0')を含めて変換する */
+    if (utf8_to_euc(buf, strlen(buf) + 1, eucbuf, sizeof(eucbuf)) < 0) {
+        return -1;
+    }
+#endif
+    term_string_push(_(eucbuf, buf));
+    return 0;
+}
+
+/*
+ * Start reading stdin on its own thread
+ */
+static void start_input_thread()
+{
+    if (pipe(input_wakeup_pipe) != 0) {
+        quit("Failed to create a pipe for the input thread");
+    }
+
+    for (const auto fd : input_wakeup_pipe) {
+        if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) < 0) {
+            quit("Failed to set up the pipe for the input thread");
+        }
+    }
+
+    input_thread = std::thread(read_input_thread);
+}
+
+/*
+ * Wake the input thread up and wait for it to finish
+ */
+static void stop_input_thread()
+{
+    if (!input_thread.joinable()) {
+        return;
+    }
+
+    is_input_stopping = true;
+    is_input_paused = false;
+    is_input_paused.notify_one();
+
+    /* A crash on the input thread itself cannot wait for it, nor can an input thread which cannot be woken up */
+    if (!wake_input_thread() || (input_thread.get_id() == std::this_thread::get_id())) {
+        input_thread.detach();
+        return;
+    }
+
+    input_thread.join();
+}
+
 /*
  * Hack -- make a sound
  */
@@ -986,10 +1248,22 @@ static errr game_term_xtra_gcu(int n, int v)
 
     /* Process events */
     case TERM_XTRA_EVENT:
+        if (use_input_thread) {
+            return game_term_xtra_gcu_event_threaded(v);
+        }
+
         return game_term_xtra_gcu_event(v);
 
     /* Flush events */
     case TERM_XTRA_FLUSH:
+        if (use_input_thread) {
+            while (!game_term_xtra_gcu_event_threaded(false)) {
+                ;
+            }
+
+            return 0;
+        }
+
         while (!game_term_xtra_gcu_event(false)) {
             ;
         }
@@ -1221,6 +1495,8 @@ static void hook_quit(concptr str)
     /* Unused */
     (void)str;
 
+    stop_input_thread();
+
     /* Exit curses */
     endwin();
 }
@@ -1250,6 +1526,10 @@ errr init_gcu(int argc, char *argv[])
         if (prefix(argv[i], "-o")) {
             nobigscreen = true;
         }
+
+        if (streq(argv[i], "-i")) {
+            use_input_thread = true;
+        }
     }
 
     if (initscr() == (WINDOW *)ERR) {
@@ -1584,6 +1864,10 @@ errr init_gcu(int argc, char *argv[])
     /* Store */
     term_screen = &data[0].t;
 
+    if (use_input_thread) {
+        start_input_thread();
+    }
+
     /* Success */
     return 0;
 }
@@ -108,9 +108,12 @@
 #include "util/int-char-converter.h"
 #include "util/string-processor.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <poll.h>
 #include <span>
 #include <string>
+#include <thread>
 
 /*
  * Available graphic modes
@@ -1031,6 +1034,43 @@ struct term_data {
  */
 static term_data data[MAX_TERM_DATA];
 
+/*
+ * Threaded input ("-- -i").  Xlib may only be called from the game thread,
+ * so the input thread merely watches the display connection and raises a
+ * flag.  The non-blocking event checks made while resting, running or
+ * repeating skip XPending() (and its system calls) while the flag is down
+ * and nothing is left in Xlib's own queue.
+ */
+static bool use_input_thread = false;
+static std::atomic<bool> is_input_ready = false;
+
+/*
+ * The body of the input thread
+ */
+static void watch_input_thread(int fd)
+{
+    while (true) {
+        pollfd pfd = { fd, POLLIN, 0 };
+        if (poll(&pfd, 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            break;
+        }
+
+        is_input_ready = true;
+        if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            return;
+        }
+
+        /* Sleep until the game thread has read the connection */
+        is_input_ready.wait(true);
+    }
+
+    is_input_ready = true;
+}
+
 /* Use short names for the most commonly used elements of various structures. */
 #define DPY (Metadpy->dpy)
 #define WIN (Infowin->win)
@@ -1662,6 +1702,16 @@ static errr CheckEvent(bool wait)
 
     int i;
 
+    if (use_input_thread) {
+        if (!wait && !is_input_ready && (XQLength(Metadpy->dpy) == 0)) {
+            return 1;
+        }
+
+        if (is_input_ready.exchange(false)) {
+            is_input_ready.notify_one();
+        }
+    }
+
 #ifdef USE_XIM
     do {
 #endif
@@ -2496,6 +2546,11 @@ errr init_x11(int argc, char *argv[])
             continue;
         }
 
+        if (prefix(argv[i], "-i")) {
+            use_input_thread = true;
+            continue;
+        }
+
         if (prefix(argv[i], "--")) {
             continue;
         }
@@ -2578,6 +2633,11 @@ errr init_x11(int argc, char *argv[])
         init_sound();
     }
 
+    if (use_input_thread) {
+        /* Blocked in poll() until exit, so never joined */
+        std::thread(watch_input_thread, ConnectionNumber(Metadpy->dpy)).detach();
+    }
+
 #ifndef USE_XFT
     char filename[1024]{};
     switch (arg_graphics) {
@@ -6,9 +6,12 @@
  * are included in all such copies.
  */
 
+#include "artifact/random-art-profiler.h"
+#include "birth/game-play-initializer.h"
 #include "core/asking-player.h"
 #include "core/game-play.h"
 #include "core/scores.h"
+#include "floor/floor-generation-profiler.h"
 #include "game-option/runtime-arguments.h"
 #include "io/files-util.h"
 #include "io/record-play-movie.h"
@@ -28,7 +31,10 @@
 #include "view/display-scores.h"
 #include "wizard/spoiler-util.h"
 #include "wizard/wizard-spoiler.h"
+#include <cstdlib>
+#include <optional>
 #include <string>
+#include <string_view>
 
 /*
  * Available graphic modes
@@ -153,8 +159,14 @@ static void display_usage(const char *program)
     puts("  -u<who>  Use your <who> savefile");
     puts("  -m<sys>  Force 'main-<sys>.c' usage");
     puts("  -d<def>  Define a 'lib' dir sub-path");
+    puts("  -c[<addr>:]<port>");
+    puts("           Broadcast the game to spectators on <port> of <addr> (default: 127.0.0.1)");
     puts("  --output-spoilers");
     puts("           Output auto generated spoilers and exit");
+    puts("  --profile-floors=<num>");
+    puts("           Generate <num> floors per dungeon, output the profile and exit");
+    puts("  --profile-artifacts=<num>");
+    puts("           Generate <num> random artifacts per base item and source, output the profile and exit");
     puts("");
 
 #ifdef USE_X11
@@ -166,6 +178,7 @@ static void display_usage(const char *program)
     puts("  -- -b    Request Bigtile graphics mode");
     puts("  -- -s    Turn off smoothscaling graphics");
     puts("  -- -n#   Number of terms to use");
+    puts("  -- -i    Watch for input on a separate thread");
     puts("");
 #endif /* USE_X11 */
 
@@ -173,6 +186,7 @@ static void display_usage(const char *program)
     puts("  -mgcu    To use GCU (GNU Curses)");
     puts("  --       Sub options");
     puts("  -- -o    old subwindow layout (no bigscreen)");
+    puts("  -- -i    Read keys on a separate input thread");
 #endif /* USE_GCU */
 
 #ifdef USE_CAP
@@ -183,15 +197,74 @@ static void display_usage(const char *program)
     quit(nullptr);
 }
 
+/*
+ * @brief フロア生成を計測して結果をJSONで出力し、終了する
+ * @param count ダンジョン毎の生成数
+ */
+static void profile_floors(std::string_view count)
+{
+    const auto floors_per_dungeon = std::atoi(std::string(count).data());
+    if (floors_per_dungeon <= 0) {
+        quit("The number of floors must be positive.");
+    }
+
+    init_stuff();
+    init_angband(p_ptr, true);
+    player_wipe_without_name(p_ptr);
+    generate_floors_for_profiling(p_ptr, floors_per_dungeon);
+    if (!FloorGenerationProfiler::get_instance().save("floor-generation.json")) {
+        quit("Cannot create a floor generation profile.");
+    }
+
+    puts("Successfully created a floor generation profile.");
+    quit(nullptr);
+}
+
+/*
+ * @brief ランダムアーティファクト生成を計測して結果をJSONで出力し、終了する
+ * @param count ベースアイテム・生成元毎の生成数
+ */
+static void profile_artifacts(std::string_view count)
+{
+    const auto artifacts_per_item = std::atoi(std::string(count).data());
+    if (artifacts_per_item <= 0) {
+        quit("The number of artifacts must be positive.");
+    }
+
+    init_stuff();
+    init_angband(p_ptr, true);
+    player_wipe_without_name(p_ptr);
+    generate_random_artifacts_for_profiling(p_ptr, artifacts_per_item);
+    if (!RandomArtifactProfiler::get_instance().save("random-artifacts.json")) {
+        quit("Cannot create a random artifact profile.");
+    }
+
+    puts("Successfully created a random artifact profile.");
+    quit(nullptr);
+}
+
 /*
  * @brief 2文字以上のコマンドライン引数 (オプション)を実行する
  * @param opt コマンドライン引数
  * @return Usageを表示する必要があるか否か
- * @details v3.0.0 Alpha21時点では、スポイラー出力モードの判定及び実行を行う
+ * @details スポイラー出力モードと、フロア生成・ランダムアーティファクト生成の計測モードの判定及び実行を行う
  */
 static bool parse_long_opt(const char *opt)
 {
-    if (strcmp(opt + 2, "output-spoilers") != 0) {
+    constexpr std::string_view profile_floors_opt = "profile-floors=";
+    constexpr std::string_view profile_artifacts_opt = "profile-artifacts=";
+    const std::string_view long_opt(opt + 2);
+    if (long_opt.starts_with(profile_floors_opt)) {
+        profile_floors(long_opt.substr(profile_floors_opt.size()));
+        return false;
+    }
+
+    if (long_opt.starts_with(profile_artifacts_opt)) {
+        profile_artifacts(long_opt.substr(profile_artifacts_opt.size()));
+        return false;
+    }
+
+    if (long_opt != "output-spoilers") {
         return true;
     }
 
@@ -261,6 +334,8 @@ int main(int argc, char *argv[])
 #endif /* SET_UID */
 
     auto browsing_movie = false;
+    std::optional<uint16_t> chuukei_port;
+    std::string chuukei_address;
     for (auto i = 1; args && (i < argc); i++) {
         if (argv[i][0] != '-') {
             display_usage(argv[0]);
@@ -325,6 +400,19 @@ int main(int argc, char *argv[])
         case 'D':
             change_path(&argv[i][2]);
             break;
+        case 'c': {
+            const std::string_view chuukei_opt(&argv[i][2]);
+            const auto separator = chuukei_opt.rfind(':');
+            const auto port = std::atoi(std::string(chuukei_opt.substr((separator == std::string_view::npos) ? 0 : separator + 1)).data());
+            if ((port <= 0) || (port > 65535)) {
+                is_usage_needed = true;
+                break;
+            }
+
+            chuukei_port = static_cast<uint16_t>(port);
+            chuukei_address = (separator == std::string_view::npos) ? "" : chuukei_opt.substr(0, separator);
+            break;
+        }
         case 'x':
             if (!argv[i][2]) {
                 is_usage_needed = true;
@@ -411,6 +499,10 @@ int main(int argc, char *argv[])
         pause_line(MAIN_TERM_MIN_ROWS - 1);
     }
 
+    if (chuukei_port && !browsing_movie && !prepare_chuukei_server(*chuukei_port, chuukei_address)) {
+        plog_fmt("Failed to broadcast on port %d", *chuukei_port);
+    }
+
     play_game(p_ptr, new_game, browsing_movie);
     quit(nullptr);
     return 0;
@@ -55,6 +55,10 @@ void init_other(PlayerType *player_ptr)
         list.assign(w_ptr->max_m_idx, {});
     }
 
+    for (auto &positions : floor_ptr->mproc_positions) {
+        positions.assign(w_ptr->max_m_idx, -1);
+    }
+
     max_dlv.assign(dungeons_info.size(), {});
     floor_ptr->grid_array.assign(MAX_HGT, std::vector<Grid>(MAX_WID));
     init_gf_colors();
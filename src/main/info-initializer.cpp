@@ -229,7 +229,9 @@ errr init_monster_race_definitions()
 errr init_vaults_info()
 {
     init_header(&vaults_header);
-    return init_info("VaultDefinitions.txt", vaults_header, vaults_info, parse_vaults_info);
+    auto *parser = parse_vaults_info;
+    auto *retoucher = retouch_vaults_info;
+    return init_info("VaultDefinitions.txt", vaults_header, vaults_info, parser, retoucher);
 }
 
 static bool read_wilderness_definition(std::ifstream &ifs)
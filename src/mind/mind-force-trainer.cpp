@@ -250,6 +250,7 @@ bool shock_power(PlayerType *player_ptr)
     player_ptr->current_floor_ptr->grid_array[ty][tx].m_idx = m_idx;
     m_ptr->fy = ty;
     m_ptr->fx = tx;
+    player_ptr->current_floor_ptr->monster_index.move(m_idx, { oy, ox }, { ty, tx });
 
     update_monster(player_ptr, m_idx, true);
     lite_spot(player_ptr, oy, ox);
@@ -82,8 +82,9 @@ void delete_monster_idx(PlayerType *player_ptr, MONSTER_IDX i)
     }
 
     floor_ptr->grid_array[y][x].m_idx = 0;
-    for (auto it = m_ptr->hold_o_idx_list.begin(); it != m_ptr->hold_o_idx_list.end();) {
-        const OBJECT_IDX this_o_idx = *it++;
+    floor_ptr->monster_index.remove(i, { y, x });
+    const auto o_idx_list = m_ptr->hold_o_idx_list; // delete_object_idx() で所持リストから取り除かれるので複製を走査する
+    for (const OBJECT_IDX this_o_idx : o_idx_list) {
         delete_object_idx(player_ptr, this_o_idx);
     }
 
@@ -98,6 +99,11 @@ void delete_monster_idx(PlayerType *player_ptr, MONSTER_IDX i)
 
     *m_ptr = {};
     floor_ptr->m_cnt--;
+    floor_ptr->m_free_list.push_back(i);
+    while ((floor_ptr->m_max > 1) && !floor_ptr->m_list[floor_ptr->m_max - 1].is_valid()) {
+        floor_ptr->m_max--;
+    }
+
     lite_spot(player_ptr, y, x);
     if (r_ptr->brightness_flags.has_any_of(ld_mask)) {
         RedrawingFlagsUpdater::get_instance().set_flag(StatusRecalculatingFlag::MONSTER_LITE);
@@ -134,6 +140,8 @@ void wipe_monsters_list(PlayerType *player_ptr)
 
     floor_ptr->m_max = 1;
     floor_ptr->m_cnt = 0;
+    floor_ptr->m_free_list.clear();
+    floor_ptr->monster_index.invalidate();
     for (int i = 0; i < MAX_MTIMED; i++) {
         floor_ptr->mproc_max[i] = 0;
     }
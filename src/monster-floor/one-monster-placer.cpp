@@ -321,6 +321,7 @@ bool place_monster_one(PlayerType *player_ptr, MONSTER_IDX who, POSITION y, POSI
     m_ptr->fy = y;
     m_ptr->fx = x;
     m_ptr->current_floor_ptr = &floor;
+    floor.monster_index.add(g_ptr->m_idx, { y, x });
 
     for (int cmi = 0; cmi < MAX_MTIMED; cmi++) {
         m_ptr->mtimed[cmi] = 0;
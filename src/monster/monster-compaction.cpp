@@ -82,6 +82,8 @@ static void compact_monsters_aux(PlayerType *player_ptr, MONSTER_IDX i1, MONSTER
         int mproc_idx = get_mproc_idx(floor_ptr, i1, i);
         if (mproc_idx >= 0) {
             floor_ptr->mproc_list[i][mproc_idx] = i2;
+            floor_ptr->mproc_positions[i][i2] = static_cast<int16_t>(mproc_idx);
+            floor_ptr->mproc_positions[i][i1] = -1;
         }
     }
 }
@@ -159,4 +161,7 @@ void compact_monsters(PlayerType *player_ptr, int size)
         compact_monsters_aux(player_ptr, floor_ptr->m_max - 1, i);
         floor_ptr->m_max--;
     }
+
+    floor_ptr->m_free_list.clear();
+    floor_ptr->monster_index.invalidate();
 }
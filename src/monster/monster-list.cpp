@@ -58,9 +58,21 @@
  * @return 利用可能なモンスター配列の添字
  * @details
  * This routine should almost never fail, but it *can* happen.
+ * 削除されたモンスターの添字を優先して再利用する. 末尾が空いた分の m_max は delete_monster_idx() で縮める.
  */
 MONSTER_IDX m_pop(FloorType *floor_ptr)
 {
+    while (!floor_ptr->m_free_list.empty()) {
+        const auto i = floor_ptr->m_free_list.back();
+        floor_ptr->m_free_list.pop_back();
+        if ((i < 1) || (i >= floor_ptr->m_max) || floor_ptr->m_list[i].is_valid()) {
+            continue;
+        }
+
+        floor_ptr->m_cnt++;
+        return i;
+    }
+
     /* Normal allocation */
     if (floor_ptr->m_max < w_ptr->max_m_idx) {
         MONSTER_IDX i = floor_ptr->m_max;
@@ -71,9 +71,16 @@ void anger_monster(PlayerType *player_ptr, MonsterEntity *m_ptr)
 static void mproc_remove(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type)
 {
     int mproc_idx = get_mproc_idx(floor_ptr, m_idx, mproc_type);
-    if (mproc_idx >= 0) {
-        floor_ptr->mproc_list[mproc_type][mproc_idx] = floor_ptr->mproc_list[mproc_type][--floor_ptr->mproc_max[mproc_type]];
+    if (mproc_idx < 0) {
+        return;
     }
+
+    auto &cur_mproc_list = floor_ptr->mproc_list[mproc_type];
+    auto &positions = floor_ptr->mproc_positions[mproc_type];
+    const auto last_m_idx = cur_mproc_list[--floor_ptr->mproc_max[mproc_type]];
+    cur_mproc_list[mproc_idx] = last_m_idx;
+    positions[last_m_idx] = static_cast<int16_t>(mproc_idx);
+    positions[m_idx] = -1;
 }
 
 /*!
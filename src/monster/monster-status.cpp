@@ -104,14 +104,17 @@ int mon_damage_mod(PlayerType *player_ptr, MonsterEntity *m_ptr, int dam, bool i
  */
 int get_mproc_idx(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type)
 {
-    const auto &cur_mproc_list = floor_ptr->mproc_list[mproc_type];
-    for (int i = floor_ptr->mproc_max[mproc_type] - 1; i >= 0; i--) {
-        if (cur_mproc_list[i] == m_idx) {
-            return i;
-        }
+    const auto &positions = floor_ptr->mproc_positions[mproc_type];
+    if ((m_idx < 0) || (m_idx >= static_cast<MONSTER_IDX>(positions.size()))) {
+        return -1;
+    }
+
+    const auto mproc_idx = positions[m_idx];
+    if ((mproc_idx < 0) || (mproc_idx >= floor_ptr->mproc_max[mproc_type]) || (floor_ptr->mproc_list[mproc_type][mproc_idx] != m_idx)) {
+        return -1;
     }
 
-    return -1;
+    return mproc_idx;
 }
 
 /*!
@@ -119,12 +122,21 @@ int get_mproc_idx(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type)
  * @param floor_ptr 現在フロアへの参照ポインタ
  * @return m_idx モンスターの参照ID
  * @return mproc_type 追加したいモンスターの時限ステータスID
+ * @details リスト内の位置をモンスターごとに控えておき、削除や付け替えの時に探さずに済むようにする
  */
 void mproc_add(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type)
 {
-    if (floor_ptr->mproc_max[mproc_type] < w_ptr->max_m_idx) {
-        floor_ptr->mproc_list[mproc_type][floor_ptr->mproc_max[mproc_type]++] = (int16_t)m_idx;
+    if (floor_ptr->mproc_max[mproc_type] >= w_ptr->max_m_idx) {
+        return;
     }
+
+    auto &positions = floor_ptr->mproc_positions[mproc_type];
+    if (positions.size() < static_cast<size_t>(w_ptr->max_m_idx)) {
+        positions.resize(w_ptr->max_m_idx, -1);
+    }
+
+    positions[m_idx] = floor_ptr->mproc_max[mproc_type];
+    floor_ptr->mproc_list[mproc_type][floor_ptr->mproc_max[mproc_type]++] = (int16_t)m_idx;
 }
 
 /*!
@@ -80,16 +80,19 @@ bool update_riding_monster(PlayerType *player_ptr, turn_flags *turn_flags_ptr, M
         return move_player_effect(player_ptr, ny, nx, MPE_DONT_PICKUP);
     }
 
+    auto &monster_index = player_ptr->current_floor_ptr->monster_index;
     player_ptr->current_floor_ptr->grid_array[oy][ox].m_idx = g_ptr->m_idx;
     if (g_ptr->m_idx) {
         y_ptr->fy = oy;
         y_ptr->fx = ox;
+        monster_index.move(g_ptr->m_idx, { ny, nx }, { oy, ox });
         update_monster(player_ptr, g_ptr->m_idx, true);
     }
 
     g_ptr->m_idx = m_idx;
     m_ptr->fy = ny;
     m_ptr->fx = nx;
+    monster_index.move(m_idx, { oy, ox }, { ny, nx });
     update_monster(player_ptr, m_idx, true);
 
     lite_spot(player_ptr, oy, ox);
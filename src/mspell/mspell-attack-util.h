@@ -13,6 +13,26 @@ enum mspell_lite_type {
     DO_SPELL_BA_LITE = 3,
 };
 
+/*!
+ * @brief 候補の魔法を選択の目的ごとに分類したリスト
+ * @details 一つの魔法が複数の分類に含まれることもある
+ */
+struct MonsterSpellCategories {
+    std::vector<MonsterAbilityType> escape;
+    std::vector<MonsterAbilityType> attack;
+    std::vector<MonsterAbilityType> summon;
+    std::vector<MonsterAbilityType> tactic;
+    std::vector<MonsterAbilityType> annoy;
+    std::vector<MonsterAbilityType> invul;
+    std::vector<MonsterAbilityType> haste;
+    std::vector<MonsterAbilityType> world;
+    std::vector<MonsterAbilityType> special;
+    std::vector<MonsterAbilityType> psy_spe;
+    std::vector<MonsterAbilityType> raise;
+    std::vector<MonsterAbilityType> heal;
+    std::vector<MonsterAbilityType> dispel;
+};
+
 // Monster Spell Attack.
 class MonsterEntity;
 class MonsterRaceInfo;
@@ -25,6 +45,7 @@ struct msa_type {
     bool in_no_magic_dungeon = false;
     bool success = false;
     std::vector<MonsterAbilityType> mspells{};
+    MonsterSpellCategories spell_categories{};
     std::string m_name = "";
     bool can_remember = false;
     int dam = 0;
@@ -131,6 +131,7 @@ static bool check_mspell_non_stupid(PlayerType *player_ptr, msa_type *msa_ptr)
 static void set_mspell_list(msa_type *msa_ptr)
 {
     EnumClassFlagGroup<MonsterAbilityType>::get_flags(msa_ptr->ability_flags, std::back_inserter(msa_ptr->mspells));
+    msa_ptr->spell_categories = classify_attack_spells(msa_ptr->ability_flags);
 }
 
 static bool switch_do_spell(PlayerType *player_ptr, msa_type *msa_ptr)
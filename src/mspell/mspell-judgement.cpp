@@ -156,12 +156,12 @@ bool breath_direct(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2
         }
     } else {
         int grids = 0;
-        POSITION gx[1024], gy[1024];
-        POSITION gm[32];
+        ProjectionArea area;
+        area.clear();
         POSITION gm_rad = rad;
-        breath_shape(player_ptr, grid_g, path_n, &grids, gx, gy, gm, &gm_rad, rad, y1, x1, y, x, typ);
+        breath_shape(player_ptr, grid_g, path_n, &grids, area, &gm_rad, rad, y1, x1, y, x, typ);
         for (auto i = 0; i < grids; i++) {
-            const Pos2D pos(gy[i], gx[i]);
+            const Pos2D pos(area.gy[i], area.gx[i]);
             if ((pos.y == y2) && (pos.x == x2)) {
                 hit2 = true;
             }
@@ -22,164 +22,72 @@
 #include "system/player-type-definition.h"
 #include "util/enum-converter.h"
 #include "world/world.h"
+#include <iterator>
 
+namespace {
 /*!
- * @brief ID値が攻撃魔法のIDかどうかを返す /
- * Return TRUE if a spell is good for hurting the player (directly).
- * @param spell 判定対象のID
- * @return 正しいIDならばTRUEを返す。
- */
-static bool spell_attack(MonsterAbilityType spell)
-{
-    return RF_ABILITY_ATTACK_SPELLS_MASK.has(spell);
-}
-
-/*!
- * @brief ID値が退避目的に適したモンスター魔法IDかどうかを返す /
- * Return TRUE if a spell is good for escaping.
- * @param spell 判定対象のID
- * @return 適した魔法のIDならばTRUEを返す。
- */
-static bool spell_escape(MonsterAbilityType spell)
-{
-    /* Blink or Teleport */
-    if (spell == MonsterAbilityType::BLINK || spell == MonsterAbilityType::TPORT) {
-        return true;
-    }
-
-    /* Teleport the player away */
-    if (spell == MonsterAbilityType::TELE_AWAY || spell == MonsterAbilityType::TELE_LEVEL) {
-        return true;
-    }
-
-    /* Isn't good for escaping */
-    return false;
-}
-
-/*!
- * @brief ID値が妨害目的に適したモンスター魔法IDかどうかを返す /
- * Return TRUE if a spell is good for annoying the player.
- * @param spell 判定対象のID
- * @return 適した魔法のIDならばTRUEを返す。
+ * @brief 退避目的に適した魔法 (短距離/長距離テレポート、テレポート・アウェイ、テレポート・レベル)
  */
-static bool spell_annoy(MonsterAbilityType spell)
-{
-    return RF_ABILITY_ANNOY_SPELLS_MASK.has(spell);
-}
+const EnumClassFlagGroup<MonsterAbilityType> ESCAPE_SPELLS_MASK = {
+    MonsterAbilityType::BLINK, MonsterAbilityType::TPORT, MonsterAbilityType::TELE_AWAY, MonsterAbilityType::TELE_LEVEL
+};
 
 /*!
- * @brief ID値が召喚型のモンスター魔法IDかどうかを返す /
- * Return TRUE if a spell is good for annoying the player.
- * @param spell 判定対象のID
- * @return 召喚型魔法のIDならばTRUEを返す。
+ * @brief ability_flags のうち mask に含まれる魔法をIDの昇順に並べる
+ * @param ability_flags 候補の魔法
+ * @param mask 分類のマスク
+ * @return 該当する魔法のリスト
  */
-static bool spell_summon(MonsterAbilityType spell)
+std::vector<MonsterAbilityType> extract_spells(const EnumClassFlagGroup<MonsterAbilityType> &ability_flags, const EnumClassFlagGroup<MonsterAbilityType> &mask)
 {
-    return RF_ABILITY_SUMMON_MASK.has(spell);
+    std::vector<MonsterAbilityType> spells;
+    EnumClassFlagGroup<MonsterAbilityType>::get_flags(ability_flags & mask, std::back_inserter(spells));
+    return spells;
 }
 
 /*!
- * @brief ID値が死者復活処理かどうかを返す /
- * Return TRUE if a spell is good for annoying the player.
+ * @brief ability_flags に spell が含まれていれば spell だけのリストを返す
+ * @param ability_flags 候補の魔法
  * @param spell 判定対象のID
- * @return 死者復活の処理ならばTRUEを返す。
+ * @return 含まれていれば要素数1、含まれていなければ空のリスト
  */
-static bool spell_raise(MonsterAbilityType spell)
+std::vector<MonsterAbilityType> extract_spell(const EnumClassFlagGroup<MonsterAbilityType> &ability_flags, MonsterAbilityType spell)
 {
-    return spell == MonsterAbilityType::RAISE_DEAD;
-}
-
-/*!
- * @brief ID値が戦術的なモンスター魔法IDかどうかを返す /
- * Return TRUE if a spell is good in a tactical situation.
- * @param spell 判定対象のID
- * @return 戦術的な魔法のIDならばTRUEを返す。
- */
-static bool spell_tactic(MonsterAbilityType spell)
-{
-    return spell == MonsterAbilityType::BLINK;
-}
-
-/*!
- * @brief ID値が無敵化するモンスター魔法IDかどうかを返す /
- * Return TRUE if a spell makes invulnerable.
- * @param spell 判定対象のID
- * @return 召喚型魔法のIDならばTRUEを返す。
- */
-static bool spell_invulner(MonsterAbilityType spell)
-{
-    return spell == MonsterAbilityType::INVULNER;
-}
-
-/*!
- * @brief ID値が加速するモンスター魔法IDかどうかを返す /
- * Return TRUE if a spell hastes.
- * @param spell 判定対象のID
- * @return 召喚型魔法のIDならばTRUEを返す。
- */
-static bool spell_haste(MonsterAbilityType spell)
-{
-    return spell == MonsterAbilityType::HASTE;
-}
-
-/*!
- * @brief ID値が時間停止を行うモンスター魔法IDかどうかを返す /
- * Return TRUE if a spell world.
- * @param spell 判定対象のID
- * @return 時間停止魔法のIDならばTRUEを返す。
- */
-static bool spell_world(MonsterAbilityType spell)
-{
-    return spell == MonsterAbilityType::WORLD;
-}
-
-/*!
- * @brief ID値が特別効果のモンスター魔法IDかどうかを返す /
- * Return TRUE if a spell special.
- * @param player_ptr プレイヤーへの参照ポインタ
- * @param spell 判定対象のID
- * @return 特別効果魔法のIDならばTRUEを返す。
- */
-static bool spell_special(MonsterAbilityType spell)
-{
-    if (AngbandSystem::get_instance().is_phase_out()) {
-        return false;
+    if (ability_flags.has_not(spell)) {
+        return {};
     }
 
-    return spell == MonsterAbilityType::SPECIAL;
+    return { spell };
 }
-
-/*!
- * @brief ID値が光の剣のモンスター魔法IDかどうかを返す /
- * Return TRUE if a spell psycho-spear.
- * @param spell 判定対象のID
- * @return 光の剣のIDならばTRUEを返す。
- */
-static bool spell_psy_spe(MonsterAbilityType spell)
-{
-    return spell == MonsterAbilityType::PSY_SPEAR;
 }
 
 /*!
- * @brief ID値が治癒魔法かどうかを返す /
- * Return TRUE if a spell is good for healing.
- * @param spell 判定対象のID
- * @return 治癒魔法のIDならばTRUEを返す。
+ * @brief 候補の魔法を選択の目的ごとに分類する
+ * @param ability_flags 候補の魔法
+ * @return 分類した魔法のリスト
+ * @details 各リストは候補の魔法の並び (IDの昇順) を保つ.
+ * 闘技場の観戦中は特別な行動を分類に含めない.
  */
-static bool spell_heal(MonsterAbilityType spell)
+MonsterSpellCategories classify_attack_spells(const EnumClassFlagGroup<MonsterAbilityType> &ability_flags)
 {
-    return spell == MonsterAbilityType::HEAL;
-}
-
-/*!
- * @brief ID値が魔力消去かどうかを返す /
- * Return TRUE if a spell is good for dispel.
- * @param spell 判定対象のID
- * @return 魔力消去のIDならばTRUEを返す。
- */
-static bool spell_dispel(MonsterAbilityType spell)
-{
-    return spell == MonsterAbilityType::DISPEL;
+    MonsterSpellCategories categories;
+    categories.escape = extract_spells(ability_flags, ESCAPE_SPELLS_MASK);
+    categories.attack = extract_spells(ability_flags, RF_ABILITY_ATTACK_SPELLS_MASK);
+    categories.summon = extract_spells(ability_flags, RF_ABILITY_SUMMON_MASK);
+    categories.tactic = extract_spell(ability_flags, MonsterAbilityType::BLINK);
+    categories.annoy = extract_spells(ability_flags, RF_ABILITY_ANNOY_SPELLS_MASK);
+    categories.invul = extract_spell(ability_flags, MonsterAbilityType::INVULNER);
+    categories.haste = extract_spell(ability_flags, MonsterAbilityType::HASTE);
+    categories.world = extract_spell(ability_flags, MonsterAbilityType::WORLD);
+    if (!AngbandSystem::get_instance().is_phase_out()) {
+        categories.special = extract_spell(ability_flags, MonsterAbilityType::SPECIAL);
+    }
+
+    categories.psy_spe = extract_spell(ability_flags, MonsterAbilityType::PSY_SPEAR);
+    categories.raise = extract_spell(ability_flags, MonsterAbilityType::RAISE_DEAD);
+    categories.heal = extract_spell(ability_flags, MonsterAbilityType::HEAL);
+    categories.dispel = extract_spell(ability_flags, MonsterAbilityType::DISPEL);
+    return categories;
 }
 
 /*!
@@ -208,9 +116,7 @@ static bool decide_select_special(MonsterRaceId r_idx)
  * @brief モンスターの魔法選択ルーチン
  * Have a monster choose a spell from a list of "useful" spells.
  * @param player_ptr プレイヤーへの参照ポインタ
- * @param m_idx モンスターの構造体配列ID
- * @param spells 候補魔法IDをまとめた配列
- * @param num spellsの長さ
+ * @param msa_ptr モンスター魔法攻撃の情報 (候補の魔法は分類済であること)
  * @return 選択したモンスター魔法のID
  * @details
  * Note that this list does NOT include spells that will just hit\n
@@ -220,87 +126,18 @@ static bool decide_select_special(MonsterRaceId r_idx)
  * Stupid monsters will just pick a spell randomly.  Smart monsters\n
  * will choose more "intelligently".\n
  *\n
- * Use the helper functions above to put spells into categories.\n
- *\n
- * This function may well be an efficiency bottleneck.\n
+ * 選択は1回の詠唱で最大10回やり直すので、候補の分類は classify_attack_spells() で事前に1回だけ行っておく.
  * @todo 長過ぎる。切り分けが必要
  */
 MonsterAbilityType choose_attack_spell(PlayerType *player_ptr, msa_type *msa_ptr)
 {
-    std::vector<MonsterAbilityType> escape;
-    std::vector<MonsterAbilityType> attack;
-    std::vector<MonsterAbilityType> summon;
-    std::vector<MonsterAbilityType> tactic;
-    std::vector<MonsterAbilityType> annoy;
-    std::vector<MonsterAbilityType> invul;
-    std::vector<MonsterAbilityType> haste;
-    std::vector<MonsterAbilityType> world;
-    std::vector<MonsterAbilityType> special;
-    std::vector<MonsterAbilityType> psy_spe;
-    std::vector<MonsterAbilityType> raise;
-    std::vector<MonsterAbilityType> heal;
-    std::vector<MonsterAbilityType> dispel;
-
     auto *m_ptr = &player_ptr->current_floor_ptr->m_list[msa_ptr->m_idx];
     auto *r_ptr = &m_ptr->get_monrace();
     if (r_ptr->flags2 & RF2_STUPID) {
         return rand_choice(msa_ptr->mspells);
     }
 
-    for (size_t i = 0; i < msa_ptr->mspells.size(); i++) {
-        if (spell_escape(msa_ptr->mspells[i])) {
-            escape.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_attack(msa_ptr->mspells[i])) {
-            attack.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_summon(msa_ptr->mspells[i])) {
-            summon.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_tactic(msa_ptr->mspells[i])) {
-            tactic.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_annoy(msa_ptr->mspells[i])) {
-            annoy.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_invulner(msa_ptr->mspells[i])) {
-            invul.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_haste(msa_ptr->mspells[i])) {
-            haste.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_world(msa_ptr->mspells[i])) {
-            world.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_special(msa_ptr->mspells[i])) {
-            special.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_psy_spe(msa_ptr->mspells[i])) {
-            psy_spe.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_raise(msa_ptr->mspells[i])) {
-            raise.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_heal(msa_ptr->mspells[i])) {
-            heal.push_back(msa_ptr->mspells[i]);
-        }
-
-        if (spell_dispel(msa_ptr->mspells[i])) {
-            dispel.push_back(msa_ptr->mspells[i]);
-        }
-    }
-
+    const auto &[escape, attack, summon, tactic, annoy, invul, haste, world, special, psy_spe, raise, heal, dispel] = msa_ptr->spell_categories;
     if (!world.empty() && (randint0(100) < 15) && !w_ptr->timewalk_m_idx) {
         return rand_choice(world);
     }
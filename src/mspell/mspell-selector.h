@@ -1,8 +1,11 @@
 #pragma once
 
+#include "monster-race/race-ability-flags.h"
+#include "mspell/mspell-attack-util.h"
 #include "system/angband.h"
+#include "util/flag-group.h"
 
-enum class MonsterAbilityType;
 struct msa_type;
 class PlayerType;
+MonsterSpellCategories classify_attack_spells(const EnumClassFlagGroup<MonsterAbilityType> &ability_flags);
 MonsterAbilityType choose_attack_spell(PlayerType *player_ptr, msa_type *msa_ptr);
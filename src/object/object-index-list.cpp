@@ -4,36 +4,131 @@
 
 #include <algorithm>
 
+ObjectIndexList::ObjectIndexList(const ObjectIndexList &other)
+{
+    *this = other;
+}
+
+ObjectIndexList::ObjectIndexList(ObjectIndexList &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+ObjectIndexList &ObjectIndexList::operator=(const ObjectIndexList &other)
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    size_ = 0;
+    reserve(other.size_);
+    std::copy(other.begin(), other.end(), data());
+    size_ = other.size_;
+    return *this;
+}
+
+ObjectIndexList &ObjectIndexList::operator=(ObjectIndexList &&other) noexcept
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    release();
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    if (other.is_spilled()) {
+        spilled_o_idxs_ = other.spilled_o_idxs_;
+    } else {
+        inline_o_idxs_ = other.inline_o_idxs_;
+    }
+
+    other.size_ = 0;
+    other.capacity_ = INLINE_CAPACITY;
+    other.inline_o_idxs_ = {};
+    return *this;
+}
+
+ObjectIndexList::~ObjectIndexList()
+{
+    release();
+}
+
 void ObjectIndexList::add(FloorType *floor_ptr, OBJECT_IDX o_idx, IDX stack_idx)
 {
     if (stack_idx <= 0) {
-        stack_idx = o_idx_list_.empty() ? 1 : floor_ptr->o_list[o_idx_list_.front()].stack_idx + 1;
+        stack_idx = empty() ? 1 : floor_ptr->o_list[front()].stack_idx + 1;
     }
 
-    auto it = std::partition_point(
-        o_idx_list_.begin(), o_idx_list_.end(), [floor_ptr, stack_idx](IDX idx) { return floor_ptr->o_list[idx].stack_idx > stack_idx; });
-
-    o_idx_list_.insert(it, o_idx);
+    reserve(size_ + 1);
+    const auto it = std::partition_point(begin(), end(), [floor_ptr, stack_idx](IDX idx) { return floor_ptr->o_list[idx].stack_idx > stack_idx; });
+    std::copy_backward(it, end(), end() + 1);
+    *it = o_idx;
+    size_++;
     floor_ptr->o_list[o_idx].stack_idx = stack_idx;
 }
 
 void ObjectIndexList::remove(OBJECT_IDX o_idx)
 {
-    o_idx_list_.remove(o_idx);
+    size_ = static_cast<uint16_t>(std::remove(begin(), end(), o_idx) - begin());
 }
 
 void ObjectIndexList::rotate(FloorType *floor_ptr)
 {
-    if (o_idx_list_.size() < 2) {
+    if (size_ < 2) {
         return;
     }
 
-    o_idx_list_.push_back(o_idx_list_.front());
-    o_idx_list_.pop_front();
-
-    for (const auto o_idx : o_idx_list_) {
+    std::rotate(begin(), begin() + 1, end());
+    for (const auto o_idx : *this) {
         floor_ptr->o_list[o_idx].stack_idx++;
     }
 
-    floor_ptr->o_list[o_idx_list_.back()].stack_idx = 1;
+    floor_ptr->o_list[*(end() - 1)].stack_idx = 1;
+}
+
+void ObjectIndexList::clear() noexcept
+{
+    release();
+}
+
+void ObjectIndexList::pop_front() noexcept
+{
+    std::copy(begin() + 1, end(), begin());
+    size_--;
+}
+
+/*!
+ * @brief 指定した数の要素番号を保持できるようにする
+ * @param capacity 保持する要素番号の数
+ * @details オブジェクト内に収まらない場合はヒープに確保した配列へ移す. 確保する数は倍々に増やす
+ */
+void ObjectIndexList::reserve(size_t capacity)
+{
+    if (capacity <= capacity_) {
+        return;
+    }
+
+    const auto new_capacity = std::max<size_t>(capacity, capacity_ * 2);
+    auto *new_o_idxs = new OBJECT_IDX[new_capacity];
+    std::copy(begin(), end(), new_o_idxs);
+    if (is_spilled()) {
+        delete[] spilled_o_idxs_;
+    }
+
+    spilled_o_idxs_ = new_o_idxs;
+    capacity_ = static_cast<uint16_t>(new_capacity);
+}
+
+/*!
+ * @brief ヒープに確保した配列を解放し、空のリストに戻す
+ */
+void ObjectIndexList::release() noexcept
+{
+    if (is_spilled()) {
+        delete[] spilled_o_idxs_;
+    }
+
+    size_ = 0;
+    capacity_ = INLINE_CAPACITY;
+    inline_o_idxs_ = {};
 }
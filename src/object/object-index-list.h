@@ -2,7 +2,9 @@
 
 #include "system/angband.h"
 
-#include <list>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
 class FloorType;
 
@@ -10,6 +12,11 @@ class FloorType;
  * @brief アイテムリスト(床上スタック/モンスター所持)を管理するクラス
  *
  * @details ItemEntity 自体を保持するのではなく、フロア全体の ItemEntity 配列上のアイテムの要素番号を保持する
+ *
+ * ほとんどのグリッドはアイテムを持たないか1つだけ持つので、INLINE_CAPACITY 個までの要素番号はオブジェクト内に直接保持し、
+ * それを超えた時だけヒープに確保した配列へ移す。
+ * 要素番号は連続した領域に並ぶため、アイテムの削除や追加を行うと走査中のイテレータは無効になる。
+ * 走査しながらアイテムを削除する場合はリストを複製してから走査すること。
  */
 class ObjectIndexList {
 public:
@@ -17,6 +24,11 @@ public:
      * @brief デフォルトコンストラクタ
      */
     ObjectIndexList() = default;
+    ObjectIndexList(const ObjectIndexList &other);
+    ObjectIndexList(ObjectIndexList &&other) noexcept;
+    ObjectIndexList &operator=(const ObjectIndexList &other);
+    ObjectIndexList &operator=(ObjectIndexList &&other) noexcept;
+    ~ObjectIndexList();
 
     /**
      * @brief アイテムリストにフロア全体のアイテム配列上の指定した要素番号のアイテムを追加する
@@ -52,45 +64,61 @@ public:
     void rotate(FloorType *floor_ptr);
 
     //
-    // 以下のメソッドは内部で保持している std::list オブジェクトに対して使用できる同名のメソッド
+    // 以下のメソッドは STL のコンテナに対して使用できる同名のメソッドと同じ動作をする
     //
-    auto empty() const noexcept
+    bool empty() const noexcept
     {
-        return o_idx_list_.empty();
+        return size_ == 0;
     }
-    auto size() const noexcept
+    size_t size() const noexcept
     {
-        return o_idx_list_.size();
+        return size_;
     }
-    void clear() noexcept
+    void clear() noexcept;
+    OBJECT_IDX &front() noexcept
     {
-        o_idx_list_.clear();
+        return data()[0];
     }
-    auto &front() noexcept
+    void pop_front() noexcept;
+    OBJECT_IDX *begin() noexcept
     {
-        return o_idx_list_.front();
+        return data();
     }
-    void pop_front() noexcept
+    OBJECT_IDX *end() noexcept
     {
-        return o_idx_list_.pop_front();
+        return data() + size_;
     }
-    auto begin() noexcept
+    const OBJECT_IDX *begin() const noexcept
     {
-        return o_idx_list_.begin();
+        return data();
     }
-    auto end() noexcept
+    const OBJECT_IDX *end() const noexcept
     {
-        return o_idx_list_.end();
+        return data() + size_;
     }
-    auto begin() const noexcept
+
+private:
+    static constexpr uint16_t INLINE_CAPACITY = 4; //!< オブジェクト内に直接保持できる要素番号の数
+
+    uint16_t size_ = 0;
+    uint16_t capacity_ = INLINE_CAPACITY;
+    union {
+        std::array<OBJECT_IDX, INLINE_CAPACITY> inline_o_idxs_{};
+        OBJECT_IDX *spilled_o_idxs_; //!< capacity_ が INLINE_CAPACITY を超えている時のみ有効
+    };
+
+    bool is_spilled() const noexcept
     {
-        return o_idx_list_.begin();
+        return capacity_ > INLINE_CAPACITY;
     }
-    auto end() const noexcept
+    OBJECT_IDX *data() noexcept
     {
-        return o_idx_list_.end();
+        return is_spilled() ? spilled_o_idxs_ : inline_o_idxs_.data();
     }
-
-private:
-    std::list<OBJECT_IDX> o_idx_list_;
+    const OBJECT_IDX *data() const noexcept
+    {
+        return is_spilled() ? spilled_o_idxs_ : inline_o_idxs_.data();
+    }
+    void reserve(size_t capacity);
+    void release() noexcept;
 };
@@ -38,8 +38,91 @@
 #include "timed-effect/timed-effects.h"
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
+#include <array>
+#include <optional>
+#include <utility>
 #include <vector>
 
+namespace {
+constexpr auto WARNING_AWARE_RANGE = 12;
+
+/*!
+ * @brief 反魔法洞窟では使えない、警告対象の魔法と効果属性の組
+ */
+constexpr std::array<std::pair<MonsterAbilityType, AttributeType>, 8> WARNING_MAGIC_SPELLS = { {
+    { MonsterAbilityType::BA_CHAO, AttributeType::CHAOS },
+    { MonsterAbilityType::BA_MANA, AttributeType::MANA },
+    { MonsterAbilityType::BA_DARK, AttributeType::DARK },
+    { MonsterAbilityType::BA_LITE, AttributeType::LITE },
+    { MonsterAbilityType::HAND_DOOM, AttributeType::HAND_DOOM },
+    { MonsterAbilityType::PSY_SPEAR, AttributeType::PSY_SPEAR },
+    { MonsterAbilityType::BA_VOID, AttributeType::VOID_MAGIC },
+    { MonsterAbilityType::BA_ABYSS, AttributeType::ABYSS },
+} };
+
+/*!
+ * @brief 反魔法洞窟でも使える、警告対象のブレスと効果属性の組
+ */
+constexpr std::array<std::pair<MonsterAbilityType, AttributeType>, 25> WARNING_BREATHS = { {
+    { MonsterAbilityType::ROCKET, AttributeType::ROCKET },
+    { MonsterAbilityType::BR_ACID, AttributeType::ACID },
+    { MonsterAbilityType::BR_ELEC, AttributeType::ELEC },
+    { MonsterAbilityType::BR_FIRE, AttributeType::FIRE },
+    { MonsterAbilityType::BR_COLD, AttributeType::COLD },
+    { MonsterAbilityType::BR_POIS, AttributeType::POIS },
+    { MonsterAbilityType::BR_NETH, AttributeType::NETHER },
+    { MonsterAbilityType::BR_LITE, AttributeType::LITE },
+    { MonsterAbilityType::BR_DARK, AttributeType::DARK },
+    { MonsterAbilityType::BR_CONF, AttributeType::CONFUSION },
+    { MonsterAbilityType::BR_SOUN, AttributeType::SOUND },
+    { MonsterAbilityType::BR_CHAO, AttributeType::CHAOS },
+    { MonsterAbilityType::BR_DISE, AttributeType::DISENCHANT },
+    { MonsterAbilityType::BR_NEXU, AttributeType::NEXUS },
+    { MonsterAbilityType::BR_TIME, AttributeType::TIME },
+    { MonsterAbilityType::BR_INER, AttributeType::INERTIAL },
+    { MonsterAbilityType::BR_GRAV, AttributeType::GRAVITY },
+    { MonsterAbilityType::BR_SHAR, AttributeType::SHARDS },
+    { MonsterAbilityType::BR_PLAS, AttributeType::PLASMA },
+    { MonsterAbilityType::BR_FORC, AttributeType::FORCE },
+    { MonsterAbilityType::BR_MANA, AttributeType::MANA },
+    { MonsterAbilityType::BR_NUKE, AttributeType::NUKE },
+    { MonsterAbilityType::BR_DISI, AttributeType::DISINTEGRATE },
+    { MonsterAbilityType::BR_VOID, AttributeType::VOID_MAGIC },
+    { MonsterAbilityType::BR_ABYSS, AttributeType::ABYSS },
+} };
+
+/*!
+ * @brief 危険度の計算に関わるプレイヤーの状態
+ * @details いずれかが変わったら、モンスターごとに保持している危険度を全て計算し直す
+ */
+struct WarningDefense {
+    int chp;
+    ARMOUR_CLASS ac;
+    short skill_sav;
+    bool wraith_form;
+    bool is_blind;
+    bool is_spectre;
+    std::array<bool, 6> immunities; //!< 電撃・酸・冷気・火炎・暗黒の免疫と矢弾無効
+    std::vector<PERCENTAGE> damage_rates;
+
+    bool operator==(const WarningDefense &other) const = default;
+};
+
+/*!
+ * @brief モンスター1体の最大ダメージ (地形と位置関係を考慮しないもの)
+ */
+struct WarningThreat {
+    MonsterRaceId r_idx;
+    int max_maxhp;
+    int magic_damage; //!< 反魔法洞窟では使えない魔法の最大ダメージ
+    int breath_damage; //!< ブレス等の最大ダメージ
+    int melee_damage; //!< 隣接した時の打撃の合計ダメージ
+};
+
+std::optional<WarningDefense> warning_defense;
+std::vector<std::optional<WarningThreat>> warning_threats;
+}
+
 /*!
  * @brief 警告を放つアイテムを選択する /
  * Choose one of items that have warning flag
@@ -342,183 +425,169 @@ static int blow_damcalc(MonsterEntity *m_ptr, PlayerType *player_ptr, const Mons
     return dam;
 }
 
+/*!
+ * @brief 危険度の計算に関わるプレイヤーの状態を取得する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return プレイヤーの状態
+ */
+static WarningDefense capture_warning_defense(PlayerType *player_ptr)
+{
+    return {
+        player_ptr->chp,
+        static_cast<ARMOUR_CLASS>(player_ptr->ac + player_ptr->to_a),
+        player_ptr->skill_sav,
+        player_ptr->wraith_form != 0,
+        player_ptr->effects()->blindness()->is_blind(),
+        PlayerRace(player_ptr).equals(PlayerRaceType::SPECTRE),
+        {
+            has_immune_elec(player_ptr) != 0,
+            has_immune_acid(player_ptr) != 0,
+            has_immune_cold(player_ptr) != 0,
+            has_immune_fire(player_ptr) != 0,
+            has_immune_dark(player_ptr) != 0,
+            has_invuln_arrow(player_ptr) != 0,
+        },
+        {
+            calc_elec_damage_rate(player_ptr),
+            calc_pois_damage_rate(player_ptr),
+            calc_acid_damage_rate(player_ptr),
+            calc_cold_damage_rate(player_ptr),
+            calc_fire_damage_rate(player_ptr),
+            calc_nuke_damage_rate(player_ptr),
+            calc_lite_damage_rate(player_ptr, CALC_MAX),
+            calc_dark_damage_rate(player_ptr, CALC_MAX),
+            calc_shards_damage_rate(player_ptr, CALC_MAX),
+            calc_sound_damage_rate(player_ptr, CALC_MAX),
+            calc_conf_damage_rate(player_ptr, CALC_MAX),
+            calc_chaos_damage_rate(player_ptr, CALC_MAX),
+            calc_nether_damage_rate(player_ptr, CALC_MAX),
+            calc_disenchant_damage_rate(player_ptr, CALC_MAX),
+            calc_nexus_damage_rate(player_ptr, CALC_MAX),
+            calc_time_damage_rate(player_ptr, CALC_MAX),
+            calc_gravity_damage_rate(player_ptr, CALC_MAX),
+            calc_rocket_damage_rate(player_ptr, CALC_MAX),
+            calc_deathray_damage_rate(player_ptr, CALC_MAX),
+            calc_holy_fire_damage_rate(player_ptr, CALC_MAX),
+            calc_hell_fire_damage_rate(player_ptr, CALC_MAX),
+            calc_abyss_damage_rate(player_ptr, CALC_MAX),
+            calc_void_damage_rate(player_ptr, CALC_MAX),
+        },
+    };
+}
+
+/*!
+ * @brief モンスター1体の最大ダメージを取得する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param m_idx モンスターID
+ * @return 最大ダメージ
+ * @details 最大ダメージはモンスターの種族と最大HP、及びプレイヤーの状態だけで決まるので、
+ * それらが変わらない限り前回の計算結果を使う.
+ */
+static const WarningThreat &get_warning_threat(PlayerType *player_ptr, MONSTER_IDX m_idx)
+{
+    auto *m_ptr = &player_ptr->current_floor_ptr->m_list[m_idx];
+    if (warning_threats.size() <= static_cast<size_t>(m_idx)) {
+        warning_threats.resize(m_idx + 1);
+    }
+
+    auto &threat = warning_threats[m_idx];
+    if (threat && (threat->r_idx == m_ptr->r_idx) && (threat->max_maxhp == m_ptr->max_maxhp)) {
+        return *threat;
+    }
+
+    threat = WarningThreat{ m_ptr->r_idx, m_ptr->max_maxhp, 0, 0, 0 };
+    const auto &monrace = m_ptr->get_monrace();
+    for (const auto &[ms_type, typ] : WARNING_MAGIC_SPELLS) {
+        if (monrace.ability_flags.has(ms_type)) {
+            spell_damcalc_by_spellnum(player_ptr, ms_type, typ, m_idx, &threat->magic_damage);
+        }
+    }
+
+    for (const auto &[ms_type, typ] : WARNING_BREATHS) {
+        if (monrace.ability_flags.has(ms_type)) {
+            spell_damcalc_by_spellnum(player_ptr, ms_type, typ, m_idx, &threat->breath_damage);
+        }
+    }
+
+    for (const auto &blow : monrace.blows) {
+        /* Skip non-attacks */
+        if (blow.method == RaceBlowMethodType::NONE || (blow.method == RaceBlowMethodType::SHOOT)) {
+            continue;
+        }
+
+        /* Extract the attack info */
+        threat->melee_damage += blow_damcalc(m_ptr, player_ptr, blow);
+        if (blow.method == RaceBlowMethodType::EXPLODE) {
+            break;
+        }
+    }
+
+    return *threat;
+}
+
 /*!
  * @brief プレイヤーが特定地点へ移動した場合に警告を発する処理 /
  * Examine the grid (xx,yy) and warn the player if there are any danger
  * @param xx 危険性を調査するマスのX座標
  * @param yy 危険性を調査するマスのY座標
  * @return 警告を無視して進むことを選択するかか問題が無ければTRUE、警告に従ったならFALSEを返す。
+ * @details モンスターごとの最大ダメージは get_warning_threat() で使い回し、移動の度には位置関係だけを調べる
  */
 bool process_warning(PlayerType *player_ptr, POSITION xx, POSITION yy)
 {
-    POSITION mx, my;
-#define WARNING_AWARE_RANGE 12
     int dam_max = 0;
     static int old_damage = 0;
 
+    const auto defense = capture_warning_defense(player_ptr);
+    if (warning_defense != defense) {
+        warning_defense = defense;
+        warning_threats.clear();
+    }
+
     auto &floor = *player_ptr->current_floor_ptr;
     const auto &dungeon = floor.get_dungeon_definition();
-    for (mx = xx - WARNING_AWARE_RANGE; mx < xx + WARNING_AWARE_RANGE + 1; mx++) {
-        for (my = yy - WARNING_AWARE_RANGE; my < yy + WARNING_AWARE_RANGE + 1; my++) {
-            int dam_max0 = 0;
-            if (!in_bounds(&floor, my, mx) || (distance(my, mx, yy, xx) > WARNING_AWARE_RANGE)) {
-                continue;
-            }
-
-            const auto *g_ptr = &floor.grid_array[my][mx];
-
-            if (!g_ptr->m_idx) {
-                continue;
-            }
+    for (const auto m_idx : floor.monster_index.collect_in_range(floor, { yy, xx }, WARNING_AWARE_RANGE)) {
+        const auto &monster = floor.m_list[m_idx];
+        const auto my = monster.fy;
+        const auto mx = monster.fx;
+        if (!in_bounds(&floor, my, mx)) {
+            continue;
+        }
 
-            auto *m_ptr = &floor.m_list[g_ptr->m_idx];
+        if (monster.is_asleep()) {
+            continue;
+        }
+        if (!monster.is_hostile()) {
+            continue;
+        }
 
-            if (m_ptr->is_asleep()) {
-                continue;
-            }
-            if (!m_ptr->is_hostile()) {
-                continue;
-            }
+        const auto &threat = get_warning_threat(player_ptr, m_idx);
+        int dam_max0 = 0;
 
-            auto *r_ptr = &m_ptr->get_monrace();
-
-            /* Monster spells (only powerful ones)*/
-            if (projectable(player_ptr, my, mx, yy, xx)) {
-                const auto flags = r_ptr->ability_flags;
-
-                if (dungeon.flags.has_not(DungeonFeatureType::NO_MAGIC)) {
-                    if (flags.has(MonsterAbilityType::BA_CHAO)) {
-                        spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BA_CHAO, AttributeType::CHAOS, g_ptr->m_idx, &dam_max0);
-                    }
-                    if (flags.has(MonsterAbilityType::BA_MANA)) {
-                        spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BA_MANA, AttributeType::MANA, g_ptr->m_idx, &dam_max0);
-                    }
-                    if (flags.has(MonsterAbilityType::BA_DARK)) {
-                        spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BA_DARK, AttributeType::DARK, g_ptr->m_idx, &dam_max0);
-                    }
-                    if (flags.has(MonsterAbilityType::BA_LITE)) {
-                        spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BA_LITE, AttributeType::LITE, g_ptr->m_idx, &dam_max0);
-                    }
-                    if (flags.has(MonsterAbilityType::HAND_DOOM)) {
-                        spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::HAND_DOOM, AttributeType::HAND_DOOM, g_ptr->m_idx, &dam_max0);
-                    }
-                    if (flags.has(MonsterAbilityType::PSY_SPEAR)) {
-                        spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::PSY_SPEAR, AttributeType::PSY_SPEAR, g_ptr->m_idx, &dam_max0);
-                    }
-                    if (flags.has(MonsterAbilityType::BA_VOID)) {
-                        spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BA_VOID, AttributeType::VOID_MAGIC, g_ptr->m_idx, &dam_max0);
-                    }
-                    if (flags.has(MonsterAbilityType::BA_ABYSS)) {
-                        spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BA_ABYSS, AttributeType::ABYSS, g_ptr->m_idx, &dam_max0);
-                    }
-                }
-
-                if (flags.has(MonsterAbilityType::ROCKET)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::ROCKET, AttributeType::ROCKET, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_ACID)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_ACID, AttributeType::ACID, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_ELEC)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_ELEC, AttributeType::ELEC, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_FIRE)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_FIRE, AttributeType::FIRE, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_COLD)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_COLD, AttributeType::COLD, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_POIS)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_POIS, AttributeType::POIS, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_NETH)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_NETH, AttributeType::NETHER, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_LITE)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_LITE, AttributeType::LITE, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_DARK)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_DARK, AttributeType::DARK, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_CONF)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_CONF, AttributeType::CONFUSION, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_SOUN)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_SOUN, AttributeType::SOUND, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_CHAO)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_CHAO, AttributeType::CHAOS, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_DISE)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_DISE, AttributeType::DISENCHANT, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_NEXU)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_NEXU, AttributeType::NEXUS, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_TIME)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_TIME, AttributeType::TIME, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_INER)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_INER, AttributeType::INERTIAL, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_GRAV)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_GRAV, AttributeType::GRAVITY, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_SHAR)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_SHAR, AttributeType::SHARDS, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_PLAS)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_PLAS, AttributeType::PLASMA, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_FORC)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_FORC, AttributeType::FORCE, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_MANA)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_MANA, AttributeType::MANA, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_NUKE)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_NUKE, AttributeType::NUKE, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_DISI)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_DISI, AttributeType::DISINTEGRATE, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_VOID)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_VOID, AttributeType::VOID_MAGIC, g_ptr->m_idx, &dam_max0);
-                }
-                if (flags.has(MonsterAbilityType::BR_ABYSS)) {
-                    spell_damcalc_by_spellnum(player_ptr, MonsterAbilityType::BR_ABYSS, AttributeType::ABYSS, g_ptr->m_idx, &dam_max0);
-                }
-            }
-            /* Monster melee attacks */
-            if (r_ptr->behavior_flags.has(MonsterBehaviorType::NEVER_BLOW) || dungeon.flags.has(DungeonFeatureType::NO_MELEE)) {
-                dam_max += dam_max0;
-                continue;
+        /* Monster spells (only powerful ones)*/
+        if (projectable(player_ptr, my, mx, yy, xx)) {
+            if (dungeon.flags.has_not(DungeonFeatureType::NO_MAGIC)) {
+                dam_max0 = threat.magic_damage;
             }
 
-            if (!(mx <= xx + 1 && mx >= xx - 1 && my <= yy + 1 && my >= yy - 1)) {
-                dam_max += dam_max0;
-                continue;
-            }
+            dam_max0 = std::max(dam_max0, threat.breath_damage);
+        }
 
-            int dam_melee = 0;
-            for (const auto &blow : r_ptr->blows) {
-                /* Skip non-attacks */
-                if (blow.method == RaceBlowMethodType::NONE || (blow.method == RaceBlowMethodType::SHOOT)) {
-                    continue;
-                }
-
-                /* Extract the attack info */
-                dam_melee += blow_damcalc(m_ptr, player_ptr, blow);
-                if (blow.method == RaceBlowMethodType::EXPLODE) {
-                    break;
-                }
-            }
+        /* Monster melee attacks */
+        if (monster.get_monrace().behavior_flags.has(MonsterBehaviorType::NEVER_BLOW) || dungeon.flags.has(DungeonFeatureType::NO_MELEE)) {
+            dam_max += dam_max0;
+            continue;
+        }
 
-            if (dam_melee > dam_max0) {
-                dam_max0 = dam_melee;
-            }
+        if (!(mx <= xx + 1 && mx >= xx - 1 && my <= yy + 1 && my >= yy - 1)) {
             dam_max += dam_max0;
+            continue;
+        }
+
+        if (threat.melee_damage > dam_max0) {
+            dam_max0 = threat.melee_damage;
         }
+        dam_max += dam_max0;
     }
 
     /* Prevent excessive warning */
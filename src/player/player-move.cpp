@@ -153,6 +153,7 @@ bool move_player_effect(PlayerType *player_ptr, POSITION ny, POSITION nx, BIT_FL
                 MonsterEntity *om_ptr = &floor.m_list[om_idx];
                 om_ptr->fy = pos_new.y;
                 om_ptr->fx = pos_new.x;
+                floor.monster_index.move(om_idx, pos_old, pos_new);
                 update_monster(player_ptr, om_idx, true);
             }
 
@@ -160,6 +161,7 @@ bool move_player_effect(PlayerType *player_ptr, POSITION ny, POSITION nx, BIT_FL
                 MonsterEntity *nm_ptr = &floor.m_list[nm_idx];
                 nm_ptr->fy = pos_old.y;
                 nm_ptr->fx = pos_old.x;
+                floor.monster_index.move(nm_idx, pos_new, pos_old);
                 update_monster(player_ptr, nm_idx, true);
             }
         }
@@ -420,6 +420,7 @@ std::optional<std::string> do_hissatsu_spell(PlayerType *player_ptr, SPELL_IDX s
                     player_ptr->current_floor_ptr->grid_array[ty][tx].m_idx = m_idx;
                     m_ptr->fy = ty;
                     m_ptr->fx = tx;
+                    player_ptr->current_floor_ptr->monster_index.move(m_idx, { oy, ox }, { ty, tx });
 
                     update_monster(player_ptr, m_idx, true);
                     lite_spot(player_ptr, oy, ox);
@@ -849,6 +850,7 @@ std::optional<std::string> do_hissatsu_spell(PlayerType *player_ptr, SPELL_IDX s
                 player_ptr->current_floor_ptr->grid_array[ny][nx].m_idx = m_idx;
                 m_ptr->fy = ny;
                 m_ptr->fx = nx;
+                player_ptr->current_floor_ptr->monster_index.move(m_idx, { y, x }, { ny, nx });
 
                 update_monster(player_ptr, m_idx, true);
 
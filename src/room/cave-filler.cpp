@@ -8,6 +8,7 @@
 #include "dungeon/dungeon-flag-types.h"
 #include "floor//geometry.h"
 #include "floor/cave.h"
+#include "floor/floor-generation-profiler.h"
 #include "grid/feature.h"
 #include "grid/grid.h"
 #include "room/lake-types.h"
@@ -269,7 +270,7 @@ static void cave_fill(PlayerType *player_ptr, const POSITION y, const POSITION x
     }
 }
 
-bool generate_fracave(PlayerType *player_ptr, POSITION y0, POSITION x0, POSITION xsize, POSITION ysize, int cutoff, bool light, bool room)
+static bool generate_fracave_impl(PlayerType *player_ptr, POSITION y0, POSITION x0, POSITION xsize, POSITION ysize, int cutoff, bool light, bool room)
 {
     POSITION xhsize = xsize / 2;
     POSITION yhsize = ysize / 2;
@@ -399,6 +400,11 @@ bool generate_fracave(PlayerType *player_ptr, POSITION y0, POSITION x0, POSITION
     return true;
 }
 
+bool generate_fracave(PlayerType *player_ptr, POSITION y0, POSITION x0, POSITION xsize, POSITION ysize, int cutoff, bool light, bool room)
+{
+    return FloorGenerationProfiler::get_instance().measure("generate_fracave", [&] { return generate_fracave_impl(player_ptr, y0, x0, xsize, ysize, cutoff, light, room); });
+}
+
 bool generate_lake(PlayerType *player_ptr, POSITION y0, POSITION x0, POSITION xsize, POSITION ysize, int c1, int c2, int c3, int type)
 {
     FEAT_IDX feat1, feat2, feat3;
@@ -1,5 +1,6 @@
 #include "room/room-generator.h"
 #include "dungeon/dungeon-flag-types.h"
+#include "floor/floor-generation-profiler.h"
 #include "game-option/birth-options.h"
 #include "game-option/cheat-types.h"
 #include "room/door-definition.h"
@@ -19,6 +20,8 @@
 #include "system/player-type-definition.h"
 #include "util/probability-table.h"
 #include "wizard/wizard-messages.h"
+#include <map>
+#include <string_view>
 
 /*!
  * @brief 与えられた部屋型IDに応じて部屋の生成処理分岐を行い結果を返す / Attempt to build a room of the given type at the given block
@@ -69,6 +72,37 @@ static bool room_build(PlayerType *player_ptr, dun_data_type *dd_ptr, RoomType t
     }
 }
 
+/*!
+ * @brief 部屋の生成処理を計測する際の区間名を返す
+ * @param typ 部屋型ID
+ * @return 区間名
+ */
+static std::string_view get_room_phase_name(RoomType typ)
+{
+    static const std::map<RoomType, std::string_view> room_phase_names = {
+        { RoomType::NORMAL, "room:normal" },
+        { RoomType::OVERLAP, "room:overlap" },
+        { RoomType::CROSS, "room:cross" },
+        { RoomType::INNER_FEAT, "room:inner_feat" },
+        { RoomType::NEST, "room:nest" },
+        { RoomType::PIT, "room:pit" },
+        { RoomType::LESSER_VAULT, "room:lesser_vault" },
+        { RoomType::GREATER_VAULT, "room:greater_vault" },
+        { RoomType::FRACAVE, "room:fracave" },
+        { RoomType::RANDOM_VAULT, "room:random_vault" },
+        { RoomType::OVAL, "room:oval" },
+        { RoomType::CRYPT, "room:crypt" },
+        { RoomType::TRAP_PIT, "room:trap_pit" },
+        { RoomType::TRAP, "room:trap" },
+        { RoomType::GLASS, "room:glass" },
+        { RoomType::ARCADE, "room:arcade" },
+        { RoomType::FIXED, "room:fixed" },
+    };
+
+    const auto it = room_phase_names.find(typ);
+    return it != room_phase_names.end() ? it->second : "room:unknown";
+}
+
 /*!
  * @brief 指定した部屋の生成確率を別の部屋に加算し、指定した部屋の生成率を0にする
  * @param dst 確率を移す先の部屋種ID
@@ -184,6 +218,7 @@ bool generate_rooms(PlayerType *player_ptr, dun_data_type *dd_ptr)
         }
     }
 
+    auto &profiler = FloorGenerationProfiler::get_instance();
     bool remain;
     while (true) {
         remain = false;
@@ -194,7 +229,7 @@ bool generate_rooms(PlayerType *player_ptr, dun_data_type *dd_ptr)
             }
 
             room_num[room_type]--;
-            if (!room_build(player_ptr, dd_ptr, room_type)) {
+            if (!profiler.measure(get_room_phase_name(room_type), [&] { return room_build(player_ptr, dd_ptr, room_type); })) {
                 continue;
             }
 
@@ -30,12 +30,12 @@
 #include "room/treasure-deployment.h"
 #include "store/store-util.h"
 #include "store/store.h"
+#include "system/angband-exceptions.h"
 #include "system/dungeon-data-definition.h"
 #include "system/dungeon-info.h"
 #include "system/floor-type-definition.h"
 #include "system/grid-type-definition.h"
 #include "system/player-type-definition.h"
-#include "util/probability-table.h"
 #include "wizard/wizard-messages.h"
 
 /*
@@ -43,6 +43,11 @@
  */
 std::vector<vault_type> vaults_info;
 
+/*
+ * 種別ごとのVault ID一覧
+ */
+static std::vector<std::vector<short>> vault_ids_by_type;
+
 /*
  * This function creates a random vault that looks like a collection of bubbles.
  * It works by getting a set of coordinates that represent the center of each
@@ -302,50 +307,102 @@ static void coord_trans(POSITION *x, POSITION *y, POSITION xoffset, POSITION yof
     *y += yoffset;
 }
 
+/*!
+ * @brief Vaultを展開済の配置データに変換する
+ * @details 空白も含め、行優先の順に並べる
+ */
+void vault_type::compile_layout()
+{
+    this->cells.clear();
+    for (auto dy = 0; dy < this->hgt; dy++) {
+        for (auto dx = 0; dx < this->wid; dx++) {
+            const size_t pos = dy * this->wid + dx;
+            const auto symbol = pos < this->text.size() ? this->text[pos] : ' ';
+            this->cells.push_back({ dy, dx, symbol });
+        }
+    }
+
+    this->transformed_cells.fill(std::nullopt);
+}
+
+/*!
+ * @brief 回転・反転を適用した配置データを返す
+ * @param transno 変換ID (0-7)
+ * @return 変換後の配置データ
+ * @details 変換IDごとに初回だけ計算し、以降は使い回す
+ */
+const std::vector<VaultCell> &vault_type::get_layout(int transno) const
+{
+    auto &layout = this->transformed_cells[transno];
+    if (layout) {
+        return *layout;
+    }
+
+    POSITION x = this->wid;
+    POSITION y = this->hgt;
+    coord_trans(&x, &y, 0, 0, transno);
+    const POSITION xoffset = (x < 0) ? -x - 1 : 0;
+    const POSITION yoffset = (y < 0) ? -y - 1 : 0;
+    layout.emplace();
+    layout->reserve(this->cells.size());
+    for (const auto &cell : this->cells) {
+        POSITION i = cell.x;
+        POSITION j = cell.y;
+        coord_trans(&i, &j, xoffset, yoffset, transno);
+        layout->push_back({ j, i, cell.symbol });
+    }
+
+    return *layout;
+}
+
+/*!
+ * @brief 全Vaultの配置データを展開し、種別ごとの索引を作る
+ */
+void compile_vaults_info()
+{
+    vault_ids_by_type.clear();
+    for (auto &vault : vaults_info) {
+        vault.compile_layout();
+        if (static_cast<size_t>(vault.typ) >= vault_ids_by_type.size()) {
+            vault_ids_by_type.resize(vault.typ + 1);
+        }
+
+        vault_ids_by_type[vault.typ].push_back(vault.idx);
+    }
+}
+
 /*!
  * @brief Vaultをフロアに配置する / Hack -- fill in "vault" rooms
  * @param player_ptr プレイヤーへの参照ポインタ
  * @param yval 生成基準Y座標
  * @param xval 生成基準X座標
- * @param ymax VaultのYサイズ
- * @param xmax VaultのXサイズ
- * @param data Vaultのデータ文字列
- * @param xoffset 変換基準X座標
- * @param yoffset 変換基準Y座標
+ * @param vault 配置するVault
  * @param transno 変換ID
  */
-static void build_vault(
-    PlayerType *player_ptr, POSITION yval, POSITION xval, POSITION ymax, POSITION xmax, concptr data, POSITION xoffset, POSITION yoffset, int transno)
+static void build_vault(PlayerType *player_ptr, POSITION yval, POSITION xval, const vault_type &vault, int transno)
 {
-    POSITION dx, dy, x, y, i, j;
-    concptr t;
+    POSITION dx, dy, x, y;
     Grid *g_ptr;
 
+    const auto &layout = vault.get_layout(transno);
+    const auto ymax = vault.hgt;
+    const auto xmax = vault.wid;
+    const auto y0 = yval - ((transno % 2 == 0) ? ymax : xmax) / 2;
+    const auto x0 = xval - ((transno % 2 == 0) ? xmax : ymax) / 2;
+
     /* Place dungeon features and objects */
     auto *floor_ptr = player_ptr->current_floor_ptr;
-    for (t = data, dy = 0; dy < ymax; dy++) {
-        for (dx = 0; dx < xmax; dx++, t++) {
-            /* prevent loop counter from being overwritten */
-            i = dx;
-            j = dy;
-
-            /* Flip / rotate */
-            coord_trans(&i, &j, xoffset, yoffset, transno);
-
-            if (transno % 2 == 0) {
-                /* no swap of x/y */
-                x = xval - (xmax / 2) + i;
-                y = yval - (ymax / 2) + j;
-            } else {
-                /* swap of x/y */
-                x = xval - (ymax / 2) + i;
-                y = yval - (xmax / 2) + j;
-            }
-
+    for (dy = 0; dy < ymax; dy++) {
+        for (dx = 0; dx < xmax; dx++) {
             /* Hack -- skip "non-grids" */
-            if (*t == ' ') {
+            const auto &cell = layout[dy * xmax + dx];
+            if (cell.symbol == ' ') {
                 continue;
             }
+
+            /* Flipped / rotated position */
+            x = x0 + cell.x;
+            y = y0 + cell.y;
             g_ptr = &floor_ptr->grid_array[y][x];
 
             /* Lay down a floor */
@@ -358,7 +415,7 @@ static void build_vault(
             g_ptr->info |= (CAVE_ROOM | CAVE_ICKY);
 
             /* Analyze the grid */
-            switch (*t) {
+            switch (cell.symbol) {
                 /* Granite wall (outer) */
             case '%':
                 place_grid(player_ptr, g_ptr, GB_OUTER_NOPERM);
@@ -522,32 +579,20 @@ static void build_vault(
     }
 
     /* Place dungeon monsters and objects */
-    for (t = data, dy = 0; dy < ymax; dy++) {
-        for (dx = 0; dx < xmax; dx++, t++) {
-            /* prevent loop counter from being overwritten */
-            i = dx;
-            j = dy;
-
-            /* Flip / rotate */
-            coord_trans(&i, &j, xoffset, yoffset, transno);
-
-            if (transno % 2 == 0) {
-                /* no swap of x/y */
-                x = xval - (xmax / 2) + i;
-                y = yval - (ymax / 2) + j;
-            } else {
-                /* swap of x/y */
-                x = xval - (ymax / 2) + i;
-                y = yval - (xmax / 2) + j;
-            }
-
+    for (dy = 0; dy < ymax; dy++) {
+        for (dx = 0; dx < xmax; dx++) {
             /* Hack -- skip "non-grids" */
-            if (*t == ' ') {
+            const auto &cell = layout[dy * xmax + dx];
+            if (cell.symbol == ' ') {
                 continue;
             }
 
+            /* Flipped / rotated position */
+            x = x0 + cell.x;
+            y = y0 + cell.y;
+
             /* Analyze the symbol */
-            switch (*t) {
+            switch (cell.symbol) {
             case '&': {
                 floor_ptr->monster_level = floor_ptr->base_level + 5;
                 place_random_monster(player_ptr, y, x, (PM_ALLOW_SLEEP | PM_ALLOW_GROUP));
@@ -1010,31 +1055,22 @@ bool build_type10(PlayerType *player_ptr, dun_data_type *dd_ptr)
  */
 bool build_fixed_room(PlayerType *player_ptr, dun_data_type *dd_ptr, int typ, bool more_space)
 {
-    vault_type *v_ptr = nullptr;
-    POSITION x, y;
     POSITION xval, yval;
-    POSITION xoffset, yoffset;
-    int transno;
-
-    ProbabilityTable<int> prob_table;
 
     /* Pick fixed room */
-    for (const auto &v_ref : vaults_info) {
-        if (v_ref.typ == typ) {
-            prob_table.entry_item(v_ref.idx, 1);
-        }
+    if ((typ < 0) || (typ >= static_cast<int>(vault_ids_by_type.size())) || vault_ids_by_type[typ].empty()) {
+        THROW_EXCEPTION(std::runtime_error, "There is no fixed room of the type.");
     }
 
-    auto result = prob_table.pick_one_at_random();
-
-    v_ptr = &vaults_info[result];
+    const auto &ids = vault_ids_by_type[typ];
+    const auto &vault = vaults_info[ids[randint0(ids.size())]];
 
     /* pick type of transformation (0-7) */
-    transno = randint0(8);
+    auto transno = randint0(8);
 
     /* calculate offsets */
-    x = v_ptr->wid;
-    y = v_ptr->hgt;
+    POSITION x = vault.wid;
+    POSITION y = vault.hgt;
 
     /* Some huge vault cannot be ratated to fit in the dungeon */
     auto *floor_ptr = player_ptr->current_floor_ptr;
@@ -1045,18 +1081,6 @@ bool build_fixed_room(PlayerType *player_ptr, dun_data_type *dd_ptr, int typ, bo
 
     coord_trans(&x, &y, 0, 0, transno);
 
-    if (x < 0) {
-        xoffset = -x - 1;
-    } else {
-        xoffset = 0;
-    }
-
-    if (y < 0) {
-        yoffset = -y - 1;
-    } else {
-        yoffset = 0;
-    }
-
     /*
      * Try to allocate space for room.  If fails, exit
      *
@@ -1070,10 +1094,10 @@ bool build_fixed_room(PlayerType *player_ptr, dun_data_type *dd_ptr, int typ, bo
         return false;
     }
 
-    msg_format_wizard(player_ptr, CHEAT_DUNGEON, _("固定部屋(%s)を生成しました。", "Fixed room (%s)."), v_ptr->name.data());
+    msg_format_wizard(player_ptr, CHEAT_DUNGEON, _("固定部屋(%s)を生成しました。", "Fixed room (%s)."), vault.name.data());
 
     /* Hack -- Build the vault */
-    build_vault(player_ptr, yval, xval, v_ptr->hgt, v_ptr->wid, v_ptr->text.data(), xoffset, yoffset, transno);
+    build_vault(player_ptr, yval, xval, vault, transno);
 
     return true;
 }
@@ -1,9 +1,21 @@
 #pragma once
 
+#include <array>
+#include <optional>
 #include <stdint.h>
 #include <string>
 #include <vector>
 
+/*!
+ * @brief Vaultの1マス
+ * @details 座標は回転・反転と、配置用のオフセットを適用した後のもの
+ */
+struct VaultCell {
+    int y;
+    int x;
+    char symbol;
+};
+
 struct vault_type {
     vault_type() = default;
     short idx = 0;
@@ -15,9 +27,18 @@ struct vault_type {
     int rat = 0; /* Vault rating (unused) */
     int hgt = 0; /* Vault height */
     int wid = 0; /* Vault width */
+
+    std::vector<VaultCell> cells{}; /* 無変換の配置 (空白を含め行優先の順に並ぶ) */
+
+    void compile_layout();
+    const std::vector<VaultCell> &get_layout(int transno) const;
+
+private:
+    mutable std::array<std::optional<std::vector<VaultCell>>, 8> transformed_cells{};
 };
 
 extern std::vector<vault_type> vaults_info;
+void compile_vaults_info();
 
 struct dun_data_type;
 class PlayerType;
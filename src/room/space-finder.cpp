@@ -1,6 +1,7 @@
 #include "room/space-finder.h"
 #include "dungeon/dungeon-flag-types.h"
 #include "floor/cave.h"
+#include "floor/floor-generation-profiler.h"
 #include "grid/grid.h"
 #include "system/dungeon-data-definition.h"
 #include "system/dungeon-info.h"
@@ -161,28 +162,7 @@ static bool find_space_aux(dun_data_type *dd_ptr, const Pos2D &max_block_size, c
     return true;
 }
 
-/*!
- * @brief 部屋生成が可能なスペースを確保する / Find a good spot for the next room.  -LM-
- * @param player_ptr プレイヤーへの参照ポインタ
- * @param y 部屋の生成が可能な中心Y座標を返す参照ポインタ
- * @param x 部屋の生成が可能な中心X座標を返す参照ポインタ
- * @param height 確保したい領域の高さ
- * @param width 確保したい領域の幅
- * @return 所定の範囲が確保できた場合TRUEを返す
- * @details
- * Find and allocate a free space in the dungeon large enough to hold\n
- * the room calling this function.\n
- *\n
- * We allocate space in 11x11 blocks, but want to make sure that rooms\n
- * alignment neatly on the standard screen.  Therefore, we make them use\n
- * blocks in few 11x33 rectangles as possible.\n
- *\n
- * Be careful to include the edges of the room in height and width!\n
- *\n
- * Return TRUE and values for the center of the room if all went well.\n
- * Otherwise, return FALSE.\n
- */
-bool find_space(PlayerType *player_ptr, dun_data_type *dd_ptr, POSITION *y, POSITION *x, POSITION height, POSITION width)
+static bool find_space_impl(PlayerType *player_ptr, dun_data_type *dd_ptr, POSITION *y, POSITION *x, POSITION height, POSITION width)
 {
     int pick;
     POSITION block_y = 0;
@@ -253,3 +233,29 @@ bool find_space(PlayerType *player_ptr, dun_data_type *dd_ptr, POSITION *y, POSI
     check_room_boundary(player_ptr, { *y - height / 2 - 1, *x - width / 2 - 1 }, { *y + (height - 1) / 2 + 1, *x + (width - 1) / 2 + 1 });
     return true;
 }
+
+/*!
+ * @brief 部屋生成が可能なスペースを確保する / Find a good spot for the next room.  -LM-
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param y 部屋の生成が可能な中心Y座標を返す参照ポインタ
+ * @param x 部屋の生成が可能な中心X座標を返す参照ポインタ
+ * @param height 確保したい領域の高さ
+ * @param width 確保したい領域の幅
+ * @return 所定の範囲が確保できた場合TRUEを返す
+ * @details
+ * Find and allocate a free space in the dungeon large enough to hold\n
+ * the room calling this function.\n
+ *\n
+ * We allocate space in 11x11 blocks, but want to make sure that rooms\n
+ * alignment neatly on the standard screen.  Therefore, we make them use\n
+ * blocks in few 11x33 rectangles as possible.\n
+ *\n
+ * Be careful to include the edges of the room in height and width!\n
+ *\n
+ * Return TRUE and values for the center of the room if all went well.\n
+ * Otherwise, return FALSE.\n
+ */
+bool find_space(PlayerType *player_ptr, dun_data_type *dd_ptr, POSITION *y, POSITION *x, POSITION height, POSITION width)
+{
+    return FloorGenerationProfiler::get_instance().measure("find_space", [&] { return find_space_impl(player_ptr, dd_ptr, y, x, height, width); });
+}
@@ -12,6 +12,7 @@
 #include "save/item-writer.h"
 #include "save/monster-writer.h"
 #include "save/save-util.h"
+#include "save/savefile-writer.h"
 #include "system/floor-type-definition.h"
 #include "system/grid-type-definition.h"
 #include "system/item-entity.h"
@@ -231,8 +232,7 @@ static bool save_floor_aux(PlayerType *player_ptr, saved_floor_type *sf_ptr)
     wr_saved_floor(player_ptr, sf_ptr);
     wr_u32b(v_stamp);
     wr_u32b(x_stamp);
-
-    return !ferror(saving_savefile) && (fflush(saving_savefile) != EOF);
+    return true;
 }
 /*!
  * @brief ゲームプレイ中のフロア一時保存出力処理メインルーチン / Attempt to save the temporarily saved-floor data
@@ -242,13 +242,13 @@ static bool save_floor_aux(PlayerType *player_ptr, saved_floor_type *sf_ptr)
  */
 bool save_floor(PlayerType *player_ptr, saved_floor_type *sf_ptr, BIT_FLAGS mode)
 {
-    FILE *old_fff = nullptr;
+    std::vector<byte> *old_buffer = nullptr;
     byte old_xor_byte = 0;
     uint32_t old_v_stamp = 0;
     uint32_t old_x_stamp = 0;
 
     if ((mode & SLF_SECOND) != 0) {
-        old_fff = saving_savefile;
+        old_buffer = saving_buffer;
         old_xor_byte = save_xor_byte;
         old_v_stamp = v_stamp;
         old_x_stamp = x_stamp;
@@ -258,40 +258,20 @@ bool save_floor(PlayerType *player_ptr, saved_floor_type *sf_ptr, BIT_FLAGS mode
     char ext[32];
     strnfmt(ext, sizeof(ext), ".F%02d", (int)sf_ptr->savefile_id);
     floor_savefile.append(ext);
-    safe_setuid_grab();
-    fd_kill(floor_savefile);
-    safe_setuid_drop();
-    saving_savefile = nullptr;
-    safe_setuid_grab();
 
-    auto fd = fd_make(floor_savefile);
-    safe_setuid_drop();
-    bool is_save_successful = false;
-    if (fd >= 0) {
-        (void)fd_close(fd);
+    std::vector<byte> buffer;
+    saving_buffer = &buffer;
+    auto is_save_successful = save_floor_aux(player_ptr, sf_ptr);
+    saving_buffer = nullptr;
+    if (is_save_successful) {
         safe_setuid_grab();
-        saving_savefile = angband_fopen(floor_savefile, FileOpenMode::WRITE,
-            true, FileOpenType::RAW);
+        fd_kill(floor_savefile);
+        is_save_successful = write_savefile_bytes(floor_savefile, buffer, FileOpenType::RAW, false);
         safe_setuid_drop();
-        if (saving_savefile) {
-            if (save_floor_aux(player_ptr, sf_ptr)) {
-                is_save_successful = true;
-            }
-
-            if (angband_fclose(saving_savefile)) {
-                is_save_successful = false;
-            }
-        }
-
-        if (!is_save_successful) {
-            safe_setuid_grab();
-            (void)fd_kill(floor_savefile);
-            safe_setuid_drop();
-        }
     }
 
     if ((mode & SLF_SECOND) != 0) {
-        saving_savefile = old_fff;
+        saving_buffer = old_buffer;
         save_xor_byte = old_xor_byte;
         v_stamp = old_v_stamp;
         x_stamp = old_x_stamp;
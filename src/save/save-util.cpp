@@ -1,19 +1,20 @@
 #include "save/save-util.h"
 
-FILE *saving_savefile; /* Current save "file" */
+std::vector<byte> *saving_buffer; /* Current save "buffer" */
 byte save_xor_byte; /* Simple encryption */
 uint32_t v_stamp = 0L; /* A simple "checksum" on the actual values */
 uint32_t x_stamp = 0L; /* A simple "checksum" on the encoded bytes */
 
 /*!
- * @brief 1バイトをファイルに書き込む / These functions place information into a savefile a byte at a time
+ * @brief 1バイトをバッファに書き込む / These functions place information into a savefile a byte at a time
  * @param v 書き込むバイト値
+ * @details ファイルへの書き出しはバッファの完成後にまとめて行う.
  */
 static void sf_put(byte v)
 {
     /* Encode the value, write a character */
     save_xor_byte ^= v;
-    (void)putc((int)save_xor_byte, saving_savefile);
+    saving_buffer->push_back(save_xor_byte);
 
     /* Maintain the checksum info */
     v_stamp += v;
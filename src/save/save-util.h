@@ -2,8 +2,9 @@
 
 #include "system/angband.h"
 #include <string_view>
+#include <vector>
 
-extern FILE *saving_savefile;
+extern std::vector<byte> *saving_buffer;
 extern byte save_xor_byte;
 extern uint32_t v_stamp;
 extern uint32_t x_stamp;
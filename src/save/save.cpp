@@ -31,6 +31,7 @@
 #include "save/monster-writer.h"
 #include "save/player-writer.h"
 #include "save/save-util.h"
+#include "save/savefile-writer.h"
 #include "store/store-owners.h"
 #include "store/store-util.h"
 #include "system/angband-version.h"
@@ -39,12 +40,15 @@
 #include "system/item-entity.h"
 #include "system/monster-race-info.h"
 #include "system/player-type-definition.h"
+#include "term/z-form.h"
 #include "util/angband-files.h"
 #include "view/display-messages.h"
 #include "world/world.h"
 #include <algorithm>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 /*!
  * @brief セーブデータの書き込み /
@@ -244,95 +248,83 @@ static bool wr_savefile_new(PlayerType *player_ptr, SaveType type)
 
     wr_u32b(v_stamp);
     wr_u32b(x_stamp);
-    return !ferror(saving_savefile) && (fflush(saving_savefile) != EOF);
+    return true;
 }
 
 /*!
- * @brief セーブデータ書き込みのサブルーチン
+ * @brief セーブデータをメモリ上にシリアライズする
  * @param player_ptr プレイヤーへの参照ポインタ
- * @param path セーブデータのフルパス
  * @param type セーブ後の処理種別
- * @return セーブの成功可否
+ * @return シリアライズ済のセーブデータ. 失敗した場合はnullopt
+ * @details 保存フロアの読み直しを伴うため、ゲームスレッドで実行する.
  */
-static bool save_player_aux(PlayerType *player_ptr, const std::filesystem::path &path, SaveType type)
+static std::optional<std::vector<byte>> serialize_savefile(PlayerType *player_ptr, SaveType type)
 {
-    safe_setuid_grab();
-    auto fd = fd_make(path);
-    safe_setuid_drop();
-
-    bool is_save_successful = false;
-    saving_savefile = nullptr;
-    if (fd >= 0) {
-        (void)fd_close(fd);
-        safe_setuid_grab();
-        saving_savefile = angband_fopen(path, FileOpenMode::WRITE, true,
-            FileOpenType::SAVE);
-        safe_setuid_drop();
-        if (saving_savefile) {
-            if (wr_savefile_new(player_ptr, type)) {
-                is_save_successful = true;
-            }
-
-            if (angband_fclose(saving_savefile)) {
-                is_save_successful = false;
-            }
-        }
-
-        safe_setuid_grab();
-        if (!is_save_successful) {
-            (void)fd_kill(path);
-        }
-
-        safe_setuid_drop();
+    std::vector<byte> buffer;
+    saving_buffer = &buffer;
+    const auto is_successful = wr_savefile_new(player_ptr, type);
+    saving_buffer = nullptr;
+    if (!is_successful) {
+        return std::nullopt;
     }
 
-    if (!is_save_successful) {
-        return false;
-    }
+    return buffer;
+}
 
-    counts_write(player_ptr, 0, w_ptr->play_time);
-    w_ptr->character_saved = true;
-    return true;
+/*!
+ * @brief セーブデータのディスクへの反映が確定した後の処理
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param play_time 反映したセーブデータのプレイ時間
+ */
+static void complete_saving(PlayerType *player_ptr, uint32_t play_time)
+{
+    counts_write(player_ptr, 0, play_time);
+    w_ptr->character_loaded = true;
 }
 
 /*!
  * @brief セーブデータ書き込みのメインルーチン
  * @param player_ptr プレイヤーへの参照ポインタ
- * @return 成功すればtrue
- * @details 以下の順番で書き込みを実行する.
- * 1. hoge.new にセーブデータを書き込む
- * 2. hoge をhoge.old にリネームする
- * 3. hoge.new をhoge にリネームする
- * 4. hoge.old を削除する
+ * @return 成功すればtrue. バックグラウンドで書き出す場合は書き出し待ちに登録できればtrue
+ * @details ゲームスレッドでセーブデータをメモリ上にシリアライズした後、ディスクへ書き出す.
+ * ゲームを継続する場合の書き出しはバックグラウンドで行い、結果は finish_background_saves() で反映する.
+ * それ以外の場合は書き出し待ちのセーブデータを全て反映させた後、同期的に書き出す.
  */
 bool save_player(PlayerType *player_ptr, SaveType type)
 {
     std::stringstream ss_new;
     ss_new << savefile.string() << ".new";
     auto savefile_new = ss_new.str();
-    safe_setuid_grab();
-    fd_kill(savefile_new);
+    std::stringstream ss_old;
+    ss_old << savefile.string() << ".old";
+    auto savefile_old = ss_old.str();
     if (type == SaveType::DEBUG) {
         const auto debug_save_dir = std::filesystem::path(debug_savefile).remove_filename();
         std::error_code ec;
+        safe_setuid_grab();
         std::filesystem::create_directory(debug_save_dir, ec);
+        safe_setuid_drop();
     }
-    safe_setuid_drop();
+
     w_ptr->update_playtime();
     auto result = false;
-    if (save_player_aux(player_ptr, savefile_new.data(), type)) {
-        std::stringstream ss_old;
-        ss_old << savefile.string() << ".old";
-        auto savefile_old = ss_old.str();
-        safe_setuid_grab();
-        fd_kill(savefile_old);
+    auto buffer = serialize_savefile(player_ptr, type);
+    if (buffer) {
         const auto &path = type == SaveType::DEBUG ? debug_savefile : savefile;
-        fd_move(path, savefile_old);
-        fd_move(savefile_new, path);
-        fd_kill(savefile_old);
-        safe_setuid_drop();
-        w_ptr->character_loaded = true;
-        result = true;
+        SavefileImage image(path, savefile_new, savefile_old, std::move(*buffer), w_ptr->play_time);
+        if ((type == SaveType::CONTINUE_GAME) && SavefileWriter::can_write_in_background()) {
+            SavefileWriter::get_instance().post(std::move(image));
+            result = true;
+        } else {
+            (void)finish_background_saves(player_ptr, true);
+            safe_setuid_grab();
+            result = image.publish();
+            safe_setuid_drop();
+            if (result) {
+                complete_saving(player_ptr, image.play_time);
+                w_ptr->character_saved = true;
+            }
+        }
     }
 
     if (type != SaveType::CLOSE_GAME) {
@@ -344,3 +336,39 @@ bool save_player(PlayerType *player_ptr, SaveType type)
 
     return result;
 }
+
+/*!
+ * @brief バックグラウンドで書き出したセーブデータの結果を反映する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param should_wait 書き出し待ち及び書き出し中のセーブデータがディスクへ反映されるまで待つならばtrue
+ * @return 反映した書き出しが全て成功していればtrue
+ * @details ゲームスレッドから呼ぶこと. 失敗した書き出しがあれば画面に表示し、成功した書き出しは所要時間をメッセージ履歴に残す.
+ * 完了を待たない場合、書き出しの間にゲームが進んでいる可能性があるのでセーブ済とはみなさない.
+ */
+bool finish_background_saves(PlayerType *player_ptr, bool should_wait)
+{
+    auto &writer = SavefileWriter::get_instance();
+    if (should_wait) {
+        writer.wait();
+    }
+
+    auto is_successful = true;
+    auto has_saved = false;
+    for (const auto &result : writer.take_results()) {
+        if (!result.is_successful) {
+            msg_print(_("セーブデータの書き込みに失敗しました！", "Failed to write the savefile!"));
+            is_successful = false;
+            continue;
+        }
+
+        message_add(format(_("セーブデータを書き込みました (%dms)", "Savefile written (%dms)"), static_cast<int>(result.latency.count())));
+        complete_saving(player_ptr, result.play_time);
+        has_saved = true;
+    }
+
+    if (should_wait && has_saved && is_successful) {
+        w_ptr->character_saved = true;
+    }
+
+    return is_successful;
+}
@@ -8,3 +8,4 @@ enum class SaveType {
 
 class PlayerType;
 bool save_player(PlayerType *player_ptr, SaveType type);
+bool finish_background_saves(PlayerType *player_ptr, bool should_wait);
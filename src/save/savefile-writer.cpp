@@ -0,0 +1,177 @@
+/*!
+ * @brief セーブデータのディスク書き出し処理
+ * @details シリアライズ (save.cpp) とは分離し、メモリ上のバッファを書き出すことに専念する.
+ * 書き出しは一時ファイルへ行い、fsyncの後にリネームで本来のパスへ置き換える.
+ */
+
+#include "save/savefile-writer.h"
+#include "io/uid-checker.h"
+#include "util/angband-files.h"
+
+SavefileImage::SavefileImage(const std::filesystem::path &path, const std::filesystem::path &path_new, const std::filesystem::path &path_old, std::vector<byte> &&bytes, uint32_t play_time)
+    : path(path)
+    , path_new(path_new)
+    , path_old(path_old)
+    , bytes(std::move(bytes))
+    , play_time(play_time)
+{
+}
+
+/*!
+ * @brief セーブデータを一時ファイルへ書き出し、本来のパスへ置き換える
+ * @return 成功すればtrue
+ * @details 以下の順番で処理を実行する.
+ * 1. hoge.new にセーブデータを書き込んでfsyncする
+ * 2. hoge をhoge.old にリネームする
+ * 3. hoge.new をhoge にリネームする
+ * 4. hoge.old を削除する
+ */
+bool SavefileImage::publish() const
+{
+    fd_kill(this->path_new);
+    if (!write_savefile_bytes(this->path_new, this->bytes, FileOpenType::SAVE, true)) {
+        return false;
+    }
+
+    fd_kill(this->path_old);
+    fd_move(this->path, this->path_old);
+    fd_move(this->path_new, this->path);
+    fd_kill(this->path_old);
+    return true;
+}
+
+SavefileWriter SavefileWriter::instance{};
+
+SavefileWriter::~SavefileWriter()
+{
+    {
+        std::unique_lock lock(this->mutex);
+        this->is_stopping = true;
+    }
+
+    this->cv.notify_all();
+    if (this->worker.joinable()) {
+        this->worker.join();
+    }
+}
+
+SavefileWriter &SavefileWriter::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief バックグラウンドでの書き出しが可能かを返す
+ * @details setuid/setgidされている場合、ファイル操作に必要な権限の取得がゲームスレッドと競合するため同期書き出しとする.
+ */
+bool SavefileWriter::can_write_in_background()
+{
+    return !is_setuid_privileged();
+}
+
+/*!
+ * @brief セーブデータを書き出し待ちに登録する
+ * @param image シリアライズ済のセーブデータ
+ * @details 書き出し開始前のセーブデータが残っていれば、それを破棄して新しいセーブデータで置き換える.
+ */
+void SavefileWriter::post(SavefileImage &&image)
+{
+    {
+        std::unique_lock lock(this->mutex);
+        this->pending.emplace(std::move(image));
+        if (!this->worker.joinable()) {
+            this->worker = std::thread(&SavefileWriter::run, this);
+        }
+    }
+
+    this->cv.notify_all();
+}
+
+/*!
+ * @brief 書き出し待ち及び書き出し中のセーブデータが全てディスクへ反映されるまで待つ
+ */
+void SavefileWriter::wait()
+{
+    std::unique_lock lock(this->mutex);
+    this->cv.wait(lock, [this] { return !this->pending && !this->is_writing; });
+}
+
+/*!
+ * @brief 書き出しの終わったセーブデータの結果を受け取る
+ * @return 前回の呼び出し以降に書き出しの終わった結果 (古い順)
+ */
+std::vector<SavefileWriter::WriteResult> SavefileWriter::take_results()
+{
+    std::vector<WriteResult> finished;
+    std::unique_lock lock(this->mutex);
+    finished.swap(this->results);
+    return finished;
+}
+
+void SavefileWriter::run()
+{
+    std::unique_lock lock(this->mutex);
+    while (true) {
+        this->cv.wait(lock, [this] { return this->pending || this->is_stopping; });
+        if (!this->pending) {
+            return;
+        }
+
+        auto image = std::move(*this->pending);
+        this->pending.reset();
+        this->is_writing = true;
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto is_successful = image.publish();
+        const auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        lock.lock();
+        this->results.push_back({ is_successful, image.play_time, latency });
+        this->is_writing = false;
+        this->cv.notify_all();
+    }
+}
+
+/*!
+ * @brief バイト列をファイルへ書き出す
+ * @param path 書き出し先
+ * @param bytes 書き出すバイト列
+ * @param type ファイルの種別
+ * @param sync_to_disk ディスクへの反映 (fsync) を待つならばtrue
+ * @return 成功すればtrue. 失敗した場合は書きかけのファイルを削除する
+ */
+bool write_savefile_bytes(const std::filesystem::path &path, const std::vector<byte> &bytes, FileOpenType type, bool sync_to_disk)
+{
+    auto fd = fd_make(path);
+    if (fd < 0) {
+        return false;
+    }
+
+    (void)fd_close(fd);
+    auto *fff = angband_fopen(path, FileOpenMode::WRITE, true, type);
+    if (fff == nullptr) {
+        fd_kill(path);
+        return false;
+    }
+
+    auto is_successful = fwrite(bytes.data(), 1, bytes.size(), fff) == bytes.size();
+    is_successful &= fflush(fff) != EOF;
+    if (sync_to_disk) {
+#ifdef WINDOWS
+        is_successful &= _commit(_fileno(fff)) == 0;
+#else
+        is_successful &= fsync(fileno(fff)) == 0;
+#endif
+    }
+
+    if (angband_fclose(fff)) {
+        is_successful = false;
+    }
+
+    if (!is_successful) {
+        fd_kill(path);
+    }
+
+    return is_successful;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "system/angband.h"
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+enum class FileOpenType;
+
+/*!
+ * @brief メモリ上でシリアライズを終えたセーブデータ1件分
+ */
+class SavefileImage {
+public:
+    SavefileImage(const std::filesystem::path &path, const std::filesystem::path &path_new, const std::filesystem::path &path_old, std::vector<byte> &&bytes, uint32_t play_time);
+
+    std::filesystem::path path; //!< 最終的な配置先
+    std::filesystem::path path_new; //!< 書き出し中の一時ファイル
+    std::filesystem::path path_old; //!< 置き換え時に旧データを退避するファイル
+    std::vector<byte> bytes; //!< 暗号化済のセーブデータ本体
+    uint32_t play_time; //!< セーブ時点のプレイ時間
+
+    bool publish() const;
+};
+
+/*!
+ * @brief セーブデータをバックグラウンドでディスクへ書き出すクラス
+ * @details 待ち行列の長さは1で、書き出し開始前に次のセーブが届いた場合は新しい方だけを書き出す.
+ * 結果はゲームスレッドから take_results() で受け取り、セーブの完了処理を行う.
+ */
+class SavefileWriter {
+public:
+    /*!
+     * @brief 書き出し1件分の結果
+     */
+    struct WriteResult {
+        bool is_successful;
+        uint32_t play_time; //!< 書き出したセーブデータのプレイ時間
+        std::chrono::milliseconds latency; //!< 書き出し開始からディスクへの反映までの所要時間
+    };
+
+    SavefileWriter(const SavefileWriter &) = delete;
+    SavefileWriter(SavefileWriter &&) = delete;
+    SavefileWriter &operator=(const SavefileWriter &) = delete;
+    SavefileWriter &operator=(SavefileWriter &&) = delete;
+    ~SavefileWriter();
+
+    static SavefileWriter &get_instance();
+    static bool can_write_in_background();
+    void post(SavefileImage &&image);
+    void wait();
+    std::vector<WriteResult> take_results();
+
+private:
+    SavefileWriter() = default;
+
+    static SavefileWriter instance;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread worker;
+    std::optional<SavefileImage> pending;
+    std::vector<WriteResult> results;
+    bool is_writing = false;
+    bool is_stopping = false;
+
+    void run();
+};
+
+bool write_savefile_bytes(const std::filesystem::path &path, const std::vector<byte> &bytes, FileOpenType type, bool sync_to_disk);
@@ -0,0 +1,296 @@
+/*!
+ * @brief 複数種類の感知をまとめて処理するエンジン
+ * @details 全感知のように複数の感知を同時に行う場合でも、範囲内のグリッド・アイテム・モンスターの走査は1回で済ませる.
+ */
+
+#include "spell-kind/detection-engine.h"
+#include "core/window-redrawer.h"
+#include "dungeon/dungeon-flag-types.h"
+#include "floor/cave.h"
+#include "floor/geometry.h"
+#include "grid/feature-flag-types.h"
+#include "grid/grid.h"
+#include "grid/trap.h"
+#include "monster/monster-flag-types.h"
+#include "monster/monster-update.h"
+#include "object/object-mark-types.h"
+#include "realm/realm-song-numbers.h"
+#include "spell-realm/spells-song.h"
+#include "system/dungeon-info.h"
+#include "system/floor-type-definition.h"
+#include "system/grid-type-definition.h"
+#include "system/item-entity.h"
+#include "system/monster-entity.h"
+#include "system/player-type-definition.h"
+#include "system/redrawing-flags-updater.h"
+#include "view/display-messages.h"
+#include <algorithm>
+
+/*!
+ * @brief コンストラクタ
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param range 効果範囲 (暗いダンジョンでは1/3になる)
+ */
+DetectionEngine::DetectionEngine(PlayerType *player_ptr, POSITION range)
+    : player_ptr(player_ptr)
+    , range(range)
+{
+    if (player_ptr->current_floor_ptr->get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
+        this->range /= 3;
+    }
+}
+
+/*!
+ * @brief トラップの感知を登録する
+ * @param known 感知範囲を記録し、範囲内のグリッドから危険フラグを外すならtrue. falseならばトラップを感知した場合のみ記録する
+ * @param message 感知した時のメッセージ
+ * @return 感知結果のID
+ * @details 吟遊詩人による感知の歌が歌われている間は効力なしとする
+ */
+int DetectionEngine::add_traps(bool known, concptr message)
+{
+    this->is_trap_known = known;
+    this->trap_report_id = this->add_terrain(TerrainCharacteristics::TRAP, message, 0);
+    return *this->trap_report_id;
+}
+
+/*!
+ * @brief 地形の感知を登録する
+ * @param flag 感知する地形特性
+ * @param message 感知した時のメッセージ
+ * @param singing_limit 感知の歌がこの回数を超えて歌われていれば効力なしとする. nulloptならば歌の影響を受けない
+ * @return 感知結果のID
+ */
+int DetectionEngine::add_terrain(TerrainCharacteristics flag, concptr message, std::optional<int> singing_limit)
+{
+    const auto report_id = this->add_report(message, singing_limit);
+    this->terrain_detectors.push_back({ flag, report_id });
+    return report_id;
+}
+
+/*!
+ * @brief アイテムの感知を登録する
+ * @param predicate 感知するアイテムの条件
+ * @param message 感知した時のメッセージ
+ * @param singing_limit 感知の歌がこの回数を超えて歌われていれば効力なしとする. nulloptならば歌の影響を受けない
+ * @param is_shown_in_found_items 感知した時に発見済アイテムのサブウィンドウを更新するならtrue
+ * @return 感知結果のID
+ */
+int DetectionEngine::add_items(const ItemPredicate &predicate, concptr message, std::optional<int> singing_limit, bool is_shown_in_found_items)
+{
+    const auto report_id = this->add_report(message, singing_limit);
+    this->item_detectors.push_back({ predicate, report_id, is_shown_in_found_items });
+    return report_id;
+}
+
+/*!
+ * @brief モンスターの感知を登録する
+ * @param predicate 感知するモンスターの条件
+ * @param message 感知した時のメッセージ
+ * @param singing_limit 感知の歌がこの回数を超えて歌われていれば効力なしとする. nulloptならば歌の影響を受けない
+ * @param on_detected 感知したモンスターごとに行う追加の処理 (思い出の更新など)
+ * @return 感知結果のID
+ */
+int DetectionEngine::add_monsters(const MonsterPredicate &predicate, concptr message, std::optional<int> singing_limit, const MonsterAction &on_detected)
+{
+    const auto report_id = this->add_report(message, singing_limit);
+    this->monster_detectors.push_back({ predicate, on_detected, report_id });
+    return report_id;
+}
+
+/*!
+ * @brief 登録した感知をまとめて実行する
+ * @return 1つ以上の感知に効力があればtrue
+ */
+bool DetectionEngine::execute()
+{
+    if (!this->terrain_detectors.empty()) {
+        this->scan_grids(this->trap_report_id && this->is_trap_known);
+        if (this->trap_report_id && !this->is_trap_known && this->reports[*this->trap_report_id].has_found) {
+            this->scan_grids(true);
+        }
+    }
+
+    if (!this->item_detectors.empty()) {
+        this->scan_items();
+    }
+
+    if (!this->monster_detectors.empty()) {
+        this->scan_monsters();
+    }
+
+    if (this->trap_report_id && (this->is_trap_known || this->reports[*this->trap_report_id].has_found)) {
+        this->player_ptr->dtrap = true;
+    }
+
+    this->redraw();
+    const auto is_singing_detection = music_singing(this->player_ptr, MUSIC_DETECT);
+    const auto singing_count = is_singing_detection ? get_singing_count(this->player_ptr) : 0;
+    auto detect = false;
+    for (auto &report : this->reports) {
+        if (is_singing_detection && report.singing_limit && (singing_count > *report.singing_limit)) {
+            report.has_found = false;
+        }
+
+        if (report.has_found) {
+            msg_print(report.message);
+            detect = true;
+        }
+    }
+
+    return detect;
+}
+
+/*!
+ * @brief 感知に効力があったかを返す
+ * @param report_id add_*() が返したID
+ * @details execute() の後は感知の歌による打ち消しを反映した値を返す
+ */
+bool DetectionEngine::has_found(int report_id) const
+{
+    return this->reports[report_id].has_found;
+}
+
+int DetectionEngine::add_report(concptr message, std::optional<int> singing_limit)
+{
+    this->reports.push_back({ message, singing_limit });
+    return static_cast<int>(this->reports.size()) - 1;
+}
+
+/*!
+ * @brief 範囲内のグリッドを1回走査して地形を感知する
+ * @param marks_trap_area トラップ感知済の範囲を記録するならtrue
+ * @details 範囲外のグリッドは走査しない
+ */
+void DetectionEngine::scan_grids(bool marks_trap_area)
+{
+    auto &floor = *this->player_ptr->current_floor_ptr;
+    const auto p_y = this->player_ptr->y;
+    const auto p_x = this->player_ptr->x;
+    const auto y_min = std::max<POSITION>(1, p_y - this->range);
+    const auto y_max = std::min<POSITION>(floor.height - 2, p_y + this->range);
+    const auto x_min = std::max<POSITION>(1, p_x - this->range);
+    const auto x_max = std::min<POSITION>(floor.width - 1, p_x + this->range);
+    for (auto y = y_min; y <= y_max; y++) {
+        for (auto x = x_min; x <= x_max; x++) {
+            const auto dist = distance(p_y, p_x, y, x);
+            if (dist > this->range) {
+                continue;
+            }
+
+            auto &grid = floor.grid_array[y][x];
+            if (marks_trap_area) {
+                if (dist <= this->range - 1) {
+                    grid.info |= (CAVE_IN_DETECT);
+                }
+
+                grid.info &= ~(CAVE_UNSAFE);
+                this->redraw_spots.emplace_back(y, x);
+            }
+
+            for (const auto &detector : this->terrain_detectors) {
+                if (!grid.cave_has_flag(detector.flag)) {
+                    continue;
+                }
+
+                disclose_grid(this->player_ptr, y, x);
+                grid.info |= (CAVE_MARK);
+                this->redraw_spots.emplace_back(y, x);
+                this->reports[detector.report_id].has_found = true;
+            }
+        }
+    }
+}
+
+/*!
+ * @brief o_list を1回走査してアイテムを感知する
+ */
+void DetectionEngine::scan_items()
+{
+    auto &floor = *this->player_ptr->current_floor_ptr;
+    for (OBJECT_IDX i = 1; i < floor.o_max; i++) {
+        auto &item = floor.o_list[i];
+        if (!item.is_valid() || item.is_held_by_monster()) {
+            continue;
+        }
+
+        if (distance(this->player_ptr->y, this->player_ptr->x, item.iy, item.ix) > this->range) {
+            continue;
+        }
+
+        auto is_detected = false;
+        for (const auto &detector : this->item_detectors) {
+            if (!detector.predicate(item)) {
+                continue;
+            }
+
+            is_detected = true;
+            this->reports[detector.report_id].has_found = true;
+            this->should_redraw_found_items |= detector.is_shown_in_found_items;
+        }
+
+        if (is_detected) {
+            item.marked.set(OmType::FOUND);
+            this->redraw_spots.emplace_back(item.iy, item.ix);
+        }
+    }
+}
+
+/*!
+ * @brief 範囲内のモンスターを1回走査して感知する
+ * @details 複数の条件に該当するモンスターでも、表示の更新は1回だけ行う
+ */
+void DetectionEngine::scan_monsters()
+{
+    auto &floor = *this->player_ptr->current_floor_ptr;
+    for (const auto i : floor.monster_index.collect_in_range(floor, this->player_ptr->get_position(), this->range)) {
+        auto &monster = floor.m_list[i];
+        auto is_detected = false;
+        for (const auto &detector : this->monster_detectors) {
+            if (!detector.predicate(monster)) {
+                continue;
+            }
+
+            if (detector.on_detected) {
+                detector.on_detected(monster);
+            }
+
+            is_detected = true;
+            this->reports[detector.report_id].has_found = true;
+        }
+
+        if (!is_detected) {
+            continue;
+        }
+
+        if (this->player_ptr->monster_race_idx == monster.r_idx) {
+            this->should_redraw_monster_lore = true;
+        }
+
+        monster.mflag2.set({ MonsterConstantFlagType::MARK, MonsterConstantFlagType::SHOW });
+        update_monster(this->player_ptr, i, false);
+    }
+}
+
+/*!
+ * @brief 感知で変化したグリッドとサブウィンドウをまとめて再描画する
+ */
+void DetectionEngine::redraw()
+{
+    auto &spots = this->redraw_spots;
+    std::sort(spots.begin(), spots.end(), [](const auto &a, const auto &b) { return (a.y != b.y) ? (a.y < b.y) : (a.x < b.x); });
+    spots.erase(std::unique(spots.begin(), spots.end()), spots.end());
+    for (const auto &[y, x] : spots) {
+        lite_spot(this->player_ptr, y, x);
+    }
+
+    spots.clear();
+    auto &rfu = RedrawingFlagsUpdater::get_instance();
+    if (this->should_redraw_found_items) {
+        rfu.set_flag(SubWindowRedrawingFlag::FOUND_ITEMS);
+    }
+
+    if (this->should_redraw_monster_lore) {
+        rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "system/angband.h"
+#include "util/point-2d.h"
+#include <functional>
+#include <optional>
+#include <vector>
+
+enum class TerrainCharacteristics;
+class ItemEntity;
+class MonsterEntity;
+class PlayerType;
+
+/*!
+ * @brief 複数種類の感知を1度の走査でまとめて行うクラス
+ * @details 地形・アイテム・モンスターの述語を登録しておき、execute() で
+ * 範囲内のグリッド、o_list、m_list をそれぞれ1回だけ走査する.
+ * 画面の再描画は走査後に1グリッドにつき1回だけ行い、メッセージは登録順に感知の種類ごとに表示する.
+ */
+class DetectionEngine {
+public:
+    using ItemPredicate = std::function<bool(const ItemEntity &)>;
+    using MonsterPredicate = std::function<bool(const MonsterEntity &)>;
+    using MonsterAction = std::function<void(MonsterEntity &)>;
+
+    DetectionEngine(PlayerType *player_ptr, POSITION range);
+
+    int add_traps(bool known, concptr message);
+    int add_terrain(TerrainCharacteristics flag, concptr message, std::optional<int> singing_limit);
+    int add_items(const ItemPredicate &predicate, concptr message, std::optional<int> singing_limit, bool is_shown_in_found_items);
+    int add_monsters(const MonsterPredicate &predicate, concptr message, std::optional<int> singing_limit, const MonsterAction &on_detected = nullptr);
+    bool execute();
+    bool has_found(int report_id) const;
+
+private:
+    struct Report {
+        concptr message;
+        std::optional<int> singing_limit; //!< 感知の歌がこの回数を超えて歌われていれば効力なしとする
+        bool has_found = false;
+    };
+
+    struct TerrainDetector {
+        TerrainCharacteristics flag;
+        int report_id;
+    };
+
+    struct ItemDetector {
+        ItemPredicate predicate;
+        int report_id;
+        bool is_shown_in_found_items;
+    };
+
+    struct MonsterDetector {
+        MonsterPredicate predicate;
+        MonsterAction on_detected;
+        int report_id;
+    };
+
+    PlayerType *player_ptr;
+    POSITION range;
+    std::vector<Report> reports;
+    std::vector<TerrainDetector> terrain_detectors;
+    std::vector<ItemDetector> item_detectors;
+    std::vector<MonsterDetector> monster_detectors;
+    std::optional<int> trap_report_id;
+    bool is_trap_known = false;
+    bool should_redraw_found_items = false;
+    bool should_redraw_monster_lore = false;
+    std::vector<Pos2D> redraw_spots;
+
+    int add_report(concptr message, std::optional<int> singing_limit);
+    void scan_grids(bool marks_trap_area);
+    void scan_items();
+    void scan_monsters();
+    void redraw();
+};
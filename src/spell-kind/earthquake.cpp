@@ -272,6 +272,7 @@ bool earthquake(PlayerType *player_ptr, POSITION cy, POSITION cx, POSITION r, MO
             floor_ptr->get_grid(p_pos_new).m_idx = m_idx_aux;
             m_ptr->fy = p_pos_new.y;
             m_ptr->fx = p_pos_new.x;
+            floor_ptr->monster_index.move(m_idx_aux, pos, p_pos_new);
             update_monster(player_ptr, m_idx_aux, true);
             lite_spot(player_ptr, pos.y, pos.x);
             lite_spot(player_ptr, p_pos_new.y, p_pos_new.x);
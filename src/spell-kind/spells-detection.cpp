@@ -1,82 +1,73 @@
 #include "spell-kind/spells-detection.h"
-#include "core/window-redrawer.h"
-#include "dungeon/dungeon-flag-types.h"
-#include "floor/cave.h"
-#include "floor/floor-save-util.h"
-#include "floor/geometry.h"
-#include "grid/grid.h"
-#include "grid/trap.h"
-#include "monster-race/monster-race-hook.h"
-#include "monster-race/monster-race.h"
+#include "grid/feature-flag-types.h"
 #include "monster-race/race-flags2.h"
-#include "monster-race/race-flags3.h"
-#include "monster/monster-flag-types.h"
-#include "monster/monster-info.h"
-#include "monster/monster-status.h"
-#include "monster/monster-update.h"
-#include "object/object-mark-types.h"
+#include "monster-race/race-kind-flags.h"
 #include "object/tval-types.h"
-#include "realm/realm-song-numbers.h"
-#include "realm/realm-song.h"
-#include "spell-realm/spells-song.h"
-#include "system/dungeon-info.h"
-#include "system/floor-type-definition.h"
-#include "system/grid-type-definition.h"
+#include "spell-kind/detection-engine.h"
 #include "system/item-entity.h"
+#include "system/monster-entity.h"
 #include "system/monster-race-info.h"
 #include "system/player-type-definition.h"
-#include "system/redrawing-flags-updater.h"
-#include "system/terrain-type-definition.h"
+#include "util/bit-flags-calculator.h"
 #include "util/string-processor.h"
-#include "view/display-messages.h"
 
-/*!
- * @brief プレイヤー周辺の地形を感知する
- * @param player_ptr プレイヤーへの参照ポインタ
- * @param range 効果範囲
- * @param flag 特定地形ID
- * @param known 地形から危険フラグを外すならTRUE
- * @return 効力があった場合TRUEを返す
- */
-static bool detect_feat_flag(PlayerType *player_ptr, POSITION range, TerrainCharacteristics flag, bool known)
+namespace {
+constexpr auto MIMIC_GOLD_SYMBOLS = "$";
+constexpr auto MIMIC_ITEM_SYMBOLS = "!=?|/`";
+
+void add_trap_detection(DetectionEngine &engine, bool known)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range /= 3;
-    }
+    engine.add_traps(known, _("トラップの存在を感じとった！", "You sense the presence of traps!"));
+}
 
-    bool detect = false;
-    for (POSITION y = 1; y < floor.height - 1; y++) {
-        for (POSITION x = 1; x <= floor.width - 1; x++) {
-            int dist = distance(player_ptr->y, player_ptr->x, y, x);
-            if (dist > range) {
-                continue;
-            }
+void add_door_detection(DetectionEngine &engine)
+{
+    engine.add_terrain(TerrainCharacteristics::DOOR, _("ドアの存在を感じとった！", "You sense the presence of doors!"), 0);
+}
 
-            auto *g_ptr = &floor.grid_array[y][x];
-            if (flag == TerrainCharacteristics::TRAP) {
-                /* Mark as detected */
-                if (dist <= range && known) {
-                    if (dist <= range - 1) {
-                        g_ptr->info |= (CAVE_IN_DETECT);
-                    }
+void add_stair_detection(DetectionEngine &engine)
+{
+    engine.add_terrain(TerrainCharacteristics::STAIRS, _("階段の存在を感じとった！", "You sense the presence of stairs!"), 0);
+}
 
-                    g_ptr->info &= ~(CAVE_UNSAFE);
+void add_monster_string_detection(DetectionEngine &engine, concptr match)
+{
+    const auto predicate = [match](const MonsterEntity &monster) { return angband_strchr(match, monster.get_monrace().d_char) != nullptr; };
+    engine.add_monsters(predicate, _("モンスターの存在を感じとった！", "You sense the presence of monsters!"), 3);
+}
 
-                    lite_spot(player_ptr, y, x);
-                }
-            }
+/*!
+ * @details 財宝に擬態したモンスターも感知する
+ */
+void add_gold_detection(DetectionEngine &engine)
+{
+    const auto predicate = [](const ItemEntity &item) { return item.bi_key.tval() == ItemKindType::GOLD; };
+    engine.add_items(predicate, _("財宝の存在を感じとった！", "You sense the presence of treasure!"), 6, false);
+    add_monster_string_detection(engine, MIMIC_GOLD_SYMBOLS);
+}
 
-            if (g_ptr->cave_has_flag(flag)) {
-                disclose_grid(player_ptr, y, x);
-                g_ptr->info |= (CAVE_MARK);
-                lite_spot(player_ptr, y, x);
-                detect = true;
-            }
-        }
-    }
+/*!
+ * @details アイテムに擬態したモンスターも感知する
+ */
+void add_item_detection(DetectionEngine &engine)
+{
+    const auto predicate = [](const ItemEntity &item) { return item.bi_key.tval() != ItemKindType::GOLD; };
+    engine.add_items(predicate, _("アイテムの存在を感じとった！", "You sense the presence of objects!"), 6, true);
+    add_monster_string_detection(engine, MIMIC_ITEM_SYMBOLS);
+}
+
+void add_invisible_monster_detection(DetectionEngine &engine)
+{
+    const auto predicate = [](const MonsterEntity &monster) { return any_bits(monster.get_monrace().flags2, RF2_INVISIBLE); };
+    engine.add_monsters(predicate, _("透明な生物の存在を感じとった！", "You sense the presence of invisible creatures!"), 3);
+}
 
-    return detect;
+void add_normal_monster_detection(PlayerType *player_ptr, DetectionEngine &engine)
+{
+    const auto see_invisible = player_ptr->see_inv;
+    const auto predicate = [see_invisible](const MonsterEntity &monster) { return none_bits(monster.get_monrace().flags2, RF2_INVISIBLE) || see_invisible; };
+    engine.add_monsters(predicate, _("モンスターの存在を感じとった！", "You sense the presence of monsters!"), 3);
+}
 }
 
 /*!
@@ -90,24 +81,9 @@ static bool detect_feat_flag(PlayerType *player_ptr, POSITION range, TerrainChar
  */
 bool detect_traps(PlayerType *player_ptr, POSITION range, bool known)
 {
-    bool detect = detect_feat_flag(player_ptr, range, TerrainCharacteristics::TRAP, known);
-    if (!known && detect) {
-        detect_feat_flag(player_ptr, range, TerrainCharacteristics::TRAP, true);
-    }
-
-    if (known || detect) {
-        player_ptr->dtrap = true;
-    }
-
-    if (music_singing(player_ptr, MUSIC_DETECT) && get_singing_count(player_ptr) > 0) {
-        detect = false;
-    }
-
-    if (detect) {
-        msg_print(_("トラップの存在を感じとった！", "You sense the presence of traps!"));
-    }
-
-    return detect;
+    DetectionEngine engine(player_ptr, range);
+    add_trap_detection(engine, known);
+    return engine.execute();
 }
 
 /*!
@@ -118,16 +94,9 @@ bool detect_traps(PlayerType *player_ptr, POSITION range, bool known)
  */
 bool detect_doors(PlayerType *player_ptr, POSITION range)
 {
-    bool detect = detect_feat_flag(player_ptr, range, TerrainCharacteristics::DOOR, true);
-
-    if (music_singing(player_ptr, MUSIC_DETECT) && get_singing_count(player_ptr) > 0) {
-        detect = false;
-    }
-    if (detect) {
-        msg_print(_("ドアの存在を感じとった！", "You sense the presence of doors!"));
-    }
-
-    return detect;
+    DetectionEngine engine(player_ptr, range);
+    add_door_detection(engine);
+    return engine.execute();
 }
 
 /*!
@@ -138,16 +107,9 @@ bool detect_doors(PlayerType *player_ptr, POSITION range)
  */
 bool detect_stairs(PlayerType *player_ptr, POSITION range)
 {
-    bool detect = detect_feat_flag(player_ptr, range, TerrainCharacteristics::STAIRS, true);
-
-    if (music_singing(player_ptr, MUSIC_DETECT) && get_singing_count(player_ptr) > 0) {
-        detect = false;
-    }
-    if (detect) {
-        msg_print(_("階段の存在を感じとった！", "You sense the presence of stairs!"));
-    }
-
-    return detect;
+    DetectionEngine engine(player_ptr, range);
+    add_stair_detection(engine);
+    return engine.execute();
 }
 
 /*!
@@ -158,17 +120,11 @@ bool detect_stairs(PlayerType *player_ptr, POSITION range)
  */
 bool detect_treasure(PlayerType *player_ptr, POSITION range)
 {
-    bool detect = detect_feat_flag(player_ptr, range, TerrainCharacteristics::HAS_GOLD, true);
-
-    if (music_singing(player_ptr, MUSIC_DETECT) && get_singing_count(player_ptr) > 6) {
-        detect = false;
-    }
-    if (detect) {
-        msg_print(_("埋蔵された財宝の存在を感じとった！", "You sense the presence of buried treasure!"));
-    }
-
-    return detect;
+    DetectionEngine engine(player_ptr, range);
+    engine.add_terrain(TerrainCharacteristics::HAS_GOLD, _("埋蔵された財宝の存在を感じとった！", "You sense the presence of buried treasure!"), 6);
+    return engine.execute();
 }
+
 /*!
  * @brief プレイヤー周辺のアイテム財宝を感知する / Detect all "gold" objects on the current panel
  * @param player_ptr プレイヤーへの参照ポインタ
@@ -177,50 +133,9 @@ bool detect_treasure(PlayerType *player_ptr, POSITION range)
  */
 bool detect_objects_gold(PlayerType *player_ptr, POSITION range)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    POSITION range2 = range;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range2 /= 3;
-    }
-
-    /* Scan objects */
-    bool detect = false;
-    POSITION y, x;
-    for (OBJECT_IDX i = 1; i < floor.o_max; i++) {
-        auto *o_ptr = &floor.o_list[i];
-
-        if (!o_ptr->is_valid()) {
-            continue;
-        }
-        if (o_ptr->is_held_by_monster()) {
-            continue;
-        }
-
-        y = o_ptr->iy;
-        x = o_ptr->ix;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range2) {
-            continue;
-        }
-
-        if (o_ptr->bi_key.tval() == ItemKindType::GOLD) {
-            o_ptr->marked.set(OmType::FOUND);
-            lite_spot(player_ptr, y, x);
-            detect = true;
-        }
-    }
-
-    if (music_singing(player_ptr, MUSIC_DETECT) && get_singing_count(player_ptr) > 6) {
-        detect = false;
-    }
-    if (detect) {
-        msg_print(_("財宝の存在を感じとった！", "You sense the presence of treasure!"));
-    }
-
-    if (detect_monsters_string(player_ptr, range, "$")) {
-        detect = true;
-    }
-
-    return detect;
+    DetectionEngine engine(player_ptr, range);
+    add_gold_detection(engine);
+    return engine.execute();
 }
 
 /*!
@@ -231,50 +146,9 @@ bool detect_objects_gold(PlayerType *player_ptr, POSITION range)
  */
 bool detect_objects_normal(PlayerType *player_ptr, POSITION range)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    POSITION range2 = range;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range2 /= 3;
-    }
-
-    bool detect = false;
-    for (OBJECT_IDX i = 1; i < floor.o_max; i++) {
-        auto *o_ptr = &floor.o_list[i];
-
-        if (!o_ptr->is_valid()) {
-            continue;
-        }
-        if (o_ptr->is_held_by_monster()) {
-            continue;
-        }
-
-        POSITION y = o_ptr->iy;
-        POSITION x = o_ptr->ix;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range2) {
-            continue;
-        }
-
-        if (o_ptr->bi_key.tval() != ItemKindType::GOLD) {
-            o_ptr->marked.set(OmType::FOUND);
-            lite_spot(player_ptr, y, x);
-            detect = true;
-        }
-    }
-
-    if (music_singing(player_ptr, MUSIC_DETECT) && get_singing_count(player_ptr) > 6) {
-        detect = false;
-    }
-    if (detect) {
-        RedrawingFlagsUpdater::get_instance().set_flag(SubWindowRedrawingFlag::FOUND_ITEMS);
-        msg_print(_("アイテムの存在を感じとった！", "You sense the presence of objects!"));
-    }
-
-    if (detect_monsters_string(player_ptr, range, "!=?|/`")) {
-        detect = true;
-    }
-
-    return detect;
+    DetectionEngine engine(player_ptr, range);
+    add_item_detection(engine);
+    return engine.execute();
 }
 
 static bool is_object_magically(const ItemKindType tval)
@@ -302,39 +176,15 @@ static bool is_object_magically(const ItemKindType tval)
  */
 bool detect_objects_magic(PlayerType *player_ptr, POSITION range)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range /= 3;
-    }
-
-    auto detect = false;
-    for (OBJECT_IDX i = 1; i < floor.o_max; i++) {
-        auto *o_ptr = &floor.o_list[i];
-        if (!o_ptr->is_valid() || o_ptr->is_held_by_monster()) {
-            continue;
-        }
-
-        auto y = o_ptr->iy;
-        auto x = o_ptr->ix;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
-        auto has_bonus = o_ptr->to_a > 0;
-        has_bonus |= o_ptr->to_h + o_ptr->to_d > 0;
-        if (o_ptr->is_fixed_or_random_artifact() || o_ptr->is_ego() || is_object_magically(o_ptr->bi_key.tval()) || o_ptr->is_spell_book() || has_bonus) {
-            o_ptr->marked.set(OmType::FOUND);
-            lite_spot(player_ptr, y, x);
-            detect = true;
-        }
-    }
-
-    if (detect) {
-        RedrawingFlagsUpdater::get_instance().set_flag(SubWindowRedrawingFlag::FOUND_ITEMS);
-        msg_print(_("魔法のアイテムの存在を感じとった！", "You sense the presence of magic objects!"));
-    }
-
-    return detect;
+    const auto predicate = [](const ItemEntity &item) {
+        auto has_bonus = item.to_a > 0;
+        has_bonus |= item.to_h + item.to_d > 0;
+        return item.is_fixed_or_random_artifact() || item.is_ego() || is_object_magically(item.bi_key.tval()) || item.is_spell_book() || has_bonus;
+    };
+
+    DetectionEngine engine(player_ptr, range);
+    engine.add_items(predicate, _("魔法のアイテムの存在を感じとった！", "You sense the presence of magic objects!"), std::nullopt, true);
+    return engine.execute();
 }
 
 /*!
@@ -345,40 +195,9 @@ bool detect_objects_magic(PlayerType *player_ptr, POSITION range)
  */
 bool detect_monsters_normal(PlayerType *player_ptr, POSITION range)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range /= 3;
-    }
-
-    bool flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
-        auto *m_ptr = &floor.m_list[i];
-        auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
-        if (!(r_ptr->flags2 & RF2_INVISIBLE) || player_ptr->see_inv) {
-            m_ptr->mflag2.set({ MonsterConstantFlagType::MARK, MonsterConstantFlagType::SHOW });
-            update_monster(player_ptr, i, false);
-            flag = true;
-        }
-    }
-
-    if (music_singing(player_ptr, MUSIC_DETECT) && get_singing_count(player_ptr) > 3) {
-        flag = false;
-    }
-    if (flag) {
-        msg_print(_("モンスターの存在を感じとった！", "You sense the presence of monsters!"));
-    }
-
-    return flag;
+    DetectionEngine engine(player_ptr, range);
+    add_normal_monster_detection(player_ptr, engine);
+    return engine.execute();
 }
 
 /*!
@@ -389,47 +208,9 @@ bool detect_monsters_normal(PlayerType *player_ptr, POSITION range)
  */
 bool detect_monsters_invis(PlayerType *player_ptr, POSITION range)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range /= 3;
-    }
-
-    auto &rfu = RedrawingFlagsUpdater::get_instance();
-    auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
-        auto *m_ptr = &floor.m_list[i];
-        auto *r_ptr = &m_ptr->get_monrace();
-
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
-        if (r_ptr->flags2 & RF2_INVISIBLE) {
-            if (player_ptr->monster_race_idx == m_ptr->r_idx) {
-                rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
-            }
-
-            m_ptr->mflag2.set({ MonsterConstantFlagType::MARK, MonsterConstantFlagType::SHOW });
-            update_monster(player_ptr, i, false);
-            flag = true;
-        }
-    }
-
-    if (music_singing(player_ptr, MUSIC_DETECT) && get_singing_count(player_ptr) > 3) {
-        flag = false;
-    }
-    if (flag) {
-        msg_print(_("透明な生物の存在を感じとった！", "You sense the presence of invisible creatures!"));
-    }
-
-    return flag;
+    DetectionEngine engine(player_ptr, range);
+    add_invisible_monster_detection(engine);
+    return engine.execute();
 }
 
 /*!
@@ -440,46 +221,16 @@ bool detect_monsters_invis(PlayerType *player_ptr, POSITION range)
  */
 bool detect_monsters_evil(PlayerType *player_ptr, POSITION range)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range /= 3;
-    }
-
-    auto &rfu = RedrawingFlagsUpdater::get_instance();
-    auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
-        auto *m_ptr = &floor.m_list[i];
-        auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
+    const auto predicate = [](const MonsterEntity &monster) { return monster.get_monrace().kind_flags.has(MonsterKindType::EVIL); };
+    const auto learn_evil = [](MonsterEntity &monster) {
+        if (monster.is_original_ap()) {
+            monster.get_monrace().r_kind_flags.set(MonsterKindType::EVIL);
         }
+    };
 
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
-        if (r_ptr->kind_flags.has(MonsterKindType::EVIL)) {
-            if (m_ptr->is_original_ap()) {
-                r_ptr->r_kind_flags.set(MonsterKindType::EVIL);
-                if (player_ptr->monster_race_idx == m_ptr->r_idx) {
-                    rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
-                }
-            }
-
-            m_ptr->mflag2.set({ MonsterConstantFlagType::MARK, MonsterConstantFlagType::SHOW });
-            update_monster(player_ptr, i, false);
-            flag = true;
-        }
-    }
-
-    if (flag) {
-        msg_print(_("邪悪なる生物の存在を感じとった！", "You sense the presence of evil creatures!"));
-    }
-
-    return flag;
+    DetectionEngine engine(player_ptr, range);
+    engine.add_monsters(predicate, _("邪悪なる生物の存在を感じとった！", "You sense the presence of evil creatures!"), std::nullopt, learn_evil);
+    return engine.execute();
 }
 
 /*!
@@ -490,41 +241,10 @@ bool detect_monsters_evil(PlayerType *player_ptr, POSITION range)
  */
 bool detect_monsters_nonliving(PlayerType *player_ptr, POSITION range)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range /= 3;
-    }
-
-    auto &rfu = RedrawingFlagsUpdater::get_instance();
-    auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
-        auto *m_ptr = &floor.m_list[i];
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
-        if (!m_ptr->has_living_flag()) {
-            if (player_ptr->monster_race_idx == m_ptr->r_idx) {
-                rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
-            }
-
-            m_ptr->mflag2.set({ MonsterConstantFlagType::MARK, MonsterConstantFlagType::SHOW });
-            update_monster(player_ptr, i, false);
-            flag = true;
-        }
-    }
-
-    if (flag) {
-        msg_print(_("自然でないモンスターの存在を感じた！", "You sense the presence of unnatural beings!"));
-    }
-
-    return flag;
+    const auto predicate = [](const MonsterEntity &monster) { return !monster.has_living_flag(); };
+    DetectionEngine engine(player_ptr, range);
+    engine.add_monsters(predicate, _("自然でないモンスターの存在を感じた！", "You sense the presence of unnatural beings!"), std::nullopt);
+    return engine.execute();
 }
 
 /*!
@@ -535,43 +255,10 @@ bool detect_monsters_nonliving(PlayerType *player_ptr, POSITION range)
  */
 bool detect_monsters_mind(PlayerType *player_ptr, POSITION range)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range /= 3;
-    }
-
-    auto &rfu = RedrawingFlagsUpdater::get_instance();
-    auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
-        auto *m_ptr = &floor.m_list[i];
-        auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
-        if (!(r_ptr->flags2 & RF2_EMPTY_MIND)) {
-            if (player_ptr->monster_race_idx == m_ptr->r_idx) {
-                rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
-            }
-
-            m_ptr->mflag2.set({ MonsterConstantFlagType::MARK, MonsterConstantFlagType::SHOW });
-            update_monster(player_ptr, i, false);
-            flag = true;
-        }
-    }
-
-    if (flag) {
-        msg_print(_("殺気を感じとった！", "You sense the presence of someone's mind!"));
-    }
-
-    return flag;
+    const auto predicate = [](const MonsterEntity &monster) { return none_bits(monster.get_monrace().flags2, RF2_EMPTY_MIND); };
+    DetectionEngine engine(player_ptr, range);
+    engine.add_monsters(predicate, _("殺気を感じとった！", "You sense the presence of someone's mind!"), std::nullopt);
+    return engine.execute();
 }
 
 /*!
@@ -583,46 +270,9 @@ bool detect_monsters_mind(PlayerType *player_ptr, POSITION range)
  */
 bool detect_monsters_string(PlayerType *player_ptr, POSITION range, concptr Match)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    if (floor.get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS)) {
-        range /= 3;
-    }
-
-    auto &rfu = RedrawingFlagsUpdater::get_instance();
-    auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
-        auto *m_ptr = &floor.m_list[i];
-        auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
-        if (angband_strchr(Match, r_ptr->d_char)) {
-            if (player_ptr->monster_race_idx == m_ptr->r_idx) {
-                rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
-            }
-
-            m_ptr->mflag2.set({ MonsterConstantFlagType::MARK, MonsterConstantFlagType::SHOW });
-            update_monster(player_ptr, i, false);
-            flag = true;
-        }
-    }
-
-    if (music_singing(player_ptr, MUSIC_DETECT) && get_singing_count(player_ptr) > 3) {
-        flag = false;
-    }
-    if (flag) {
-        msg_print(_("モンスターの存在を感じとった！", "You sense the presence of monsters!"));
-    }
-
-    return flag;
+    DetectionEngine engine(player_ptr, range);
+    add_monster_string_detection(engine, Match);
+    return engine.execute();
 }
 
 /*!
@@ -630,30 +280,18 @@ bool detect_monsters_string(PlayerType *player_ptr, POSITION range, concptr Matc
  * @param player_ptr プレイヤーへの参照ポインタ
  * @param range 効果範囲
  * @return 効力があった場合TRUEを返す
+ * @details 地形・アイテム・モンスターをそれぞれ1回ずつ走査し、再描画もまとめて行う.
+ * メッセージは個別の感知を順に行った場合と同じ順で表示する.
  */
 bool detect_all(PlayerType *player_ptr, POSITION range)
 {
-    bool detect = false;
-    if (detect_traps(player_ptr, range, true)) {
-        detect = true;
-    }
-    if (detect_doors(player_ptr, range)) {
-        detect = true;
-    }
-    if (detect_stairs(player_ptr, range)) {
-        detect = true;
-    }
-    if (detect_objects_gold(player_ptr, range)) {
-        detect = true;
-    }
-    if (detect_objects_normal(player_ptr, range)) {
-        detect = true;
-    }
-    if (detect_monsters_invis(player_ptr, range)) {
-        detect = true;
-    }
-    if (detect_monsters_normal(player_ptr, range)) {
-        detect = true;
-    }
-    return detect;
+    DetectionEngine engine(player_ptr, range);
+    add_trap_detection(engine, true);
+    add_door_detection(engine);
+    add_stair_detection(engine);
+    add_gold_detection(engine);
+    add_item_detection(engine);
+    add_invisible_monster_detection(engine);
+    add_normal_monster_detection(player_ptr, engine);
+    return engine.execute();
 }
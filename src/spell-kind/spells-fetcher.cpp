@@ -157,6 +157,7 @@ bool fetch_monster(PlayerType *player_ptr)
     floor.get_grid({ ty, tx }).m_idx = m_idx;
     monster.fy = ty;
     monster.fx = tx;
+    floor.monster_index.move(m_idx, pos, { ty, tx });
     (void)set_monster_csleep(player_ptr, m_idx, 0);
     update_monster(player_ptr, m_idx, true);
     lite_spot(player_ptr, target_row, target_col);
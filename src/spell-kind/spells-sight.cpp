@@ -31,6 +31,21 @@
 #include "term/screen-processor.h"
 #include "view/display-messages.h"
 
+/*!
+ * @brief 視界に入り得る範囲にいるモンスターを集める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return モンスターIDの昇順に並んだリスト
+ * @details 視界はプレイヤーから MAX_PLAYER_SIGHT の範囲内にしか及ばないので、その矩形内だけを調べる
+ */
+static std::vector<MONSTER_IDX> collect_monsters_in_view(PlayerType *player_ptr)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    const auto p_pos = player_ptr->get_position();
+    const Pos2D top_left(p_pos.y - MAX_PLAYER_SIGHT, p_pos.x - MAX_PLAYER_SIGHT);
+    const Pos2D bottom_right(p_pos.y + MAX_PLAYER_SIGHT, p_pos.x + MAX_PLAYER_SIGHT);
+    return floor.monster_index.collect_in_rect(floor, top_left, bottom_right);
+}
+
 /*!
  * @brief 視界内モンスターに魔法効果を与える / Apply a "project()" directly to all viewable monsters
  * @param typ 属性効果
@@ -47,12 +62,9 @@
 bool project_all_los(PlayerType *player_ptr, AttributeType typ, int dam)
 {
     auto &floor = *player_ptr->current_floor_ptr;
-    for (short i = 1; i < floor.m_max; i++) {
+    const auto m_idxs = collect_monsters_in_view(player_ptr);
+    for (const auto i : m_idxs) {
         auto &monster = floor.m_list[i];
-        if (!monster.is_valid()) {
-            continue;
-        }
-
         auto y = monster.fy;
         auto x = monster.fx;
         if (!floor.has_los({ y, x }) || !projectable(player_ptr, player_ptr->y, player_ptr->x, y, x)) {
@@ -64,7 +76,7 @@ bool project_all_los(PlayerType *player_ptr, AttributeType typ, int dam)
 
     BIT_FLAGS flg = PROJECT_JUMP | PROJECT_KILL | PROJECT_HIDE;
     auto obvious = false;
-    for (short i = 1; i < floor.m_max; i++) {
+    for (const auto i : m_idxs) {
         auto &monster = floor.m_list[i];
         if (monster.mflag.has_not(MonsterTemporaryFlagType::LOS)) {
             continue;
@@ -444,12 +456,9 @@ bool probing(PlayerType *player_ptr)
     auto &floor = *player_ptr->current_floor_ptr;
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto probe = false;
-    for (short i = 1; i < floor.m_max; i++) {
+    for (const auto i : collect_monsters_in_view(player_ptr)) {
         auto &monster = floor.m_list[i];
         auto &monrace = monster.get_monrace();
-        if (!monster.is_valid()) {
-            continue;
-        }
         if (!floor.has_los({ monster.fy, monster.fx })) {
             continue;
         }
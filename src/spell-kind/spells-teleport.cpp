@@ -46,7 +46,10 @@
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
 #include "world/world.h"
+#include <algorithm>
 #include <array>
+#include <functional>
+#include <optional>
 
 /*!
  * @brief モンスターとの位置交換処理 / Switch position with a monster.
@@ -115,6 +118,41 @@ bool teleport_monster(PlayerType *player_ptr, DIRECTION dir, int distance)
     return project_hook(player_ptr, AttributeType::AWAY_ALL, dir, distance, flg);
 }
 
+/*!
+ * @brief モンスターのテレポート先を決める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param center 中心の座標
+ * @param dis 最大距離
+ * @param min 最小距離
+ * @param max_tries 候補が見つからない時に範囲を広げる回数の上限
+ * @param is_candidate テレポート先として妥当かを判定する関数
+ * @return テレポート先. 見つからなければnullopt
+ * @details 中心から min 以上 dis 以下の候補から等確率で選ぶ. 候補が無ければ最大距離を2倍、最小距離を1/2にして探し直す.
+ */
+static std::optional<Pos2D> pick_monster_teleport_destination(PlayerType *player_ptr, const Pos2D &center, POSITION dis, POSITION min, int max_tries, const std::function<bool(const Pos2D &)> &is_candidate)
+{
+    constexpr auto max_distance = 200;
+    auto &floor = *player_ptr->current_floor_ptr;
+    for (auto tries = 0; tries < max_tries; tries++) {
+        dis = std::min(dis, max_distance);
+        auto candidates = floor.teleport_destinations.collect(floor, center, dis, is_candidate);
+        std::erase_if(candidates, [&center, min](const auto &pos) { return distance(center.y, center.x, pos.y, pos.x) < min; });
+        if (!candidates.empty()) {
+            return rand_choice(candidates);
+        }
+
+        /* これ以上範囲を広げても候補は増えない */
+        if ((dis == max_distance) && (min == 0)) {
+            break;
+        }
+
+        dis = dis * 2;
+        min = min / 2;
+    }
+
+    return std::nullopt;
+}
+
 /*!
  * @brief モンスターのテレポートアウェイ処理 /
  * Teleport a monster, normally up to "dis" grids away.
@@ -140,56 +178,29 @@ bool teleport_away(PlayerType *player_ptr, MONSTER_IDX m_idx, POSITION dis, tele
 
     POSITION oy = m_ptr->fy;
     POSITION ox = m_ptr->fx;
-    POSITION min = dis / 2;
-    int tries = 0;
-    POSITION ny = 0, nx = 0;
-    bool look = true;
-    while (look) {
-        tries++;
-        if (dis > 200) {
-            dis = 200;
+    const auto &floor = *player_ptr->current_floor_ptr;
+    const auto is_candidate = [player_ptr, m_idx, mode, &floor](const Pos2D &pos) {
+        if (!cave_monster_teleportable_bold(player_ptr, m_idx, pos.y, pos.x, mode)) {
+            return false;
         }
 
-        for (int i = 0; i < 500; i++) {
-            while (true) {
-                ny = rand_spread(oy, dis);
-                nx = rand_spread(ox, dis);
-                POSITION d = distance(oy, ox, ny, nx);
-                if ((d >= min) && (d <= dis)) {
-                    break;
-                }
-            }
-
-            if (!in_bounds(player_ptr->current_floor_ptr, ny, nx)) {
-                continue;
-            }
-            if (!cave_monster_teleportable_bold(player_ptr, m_idx, ny, nx, mode)) {
-                continue;
-            }
-            if (!(player_ptr->current_floor_ptr->is_in_quest() || player_ptr->current_floor_ptr->inside_arena)) {
-                if (player_ptr->current_floor_ptr->grid_array[ny][nx].is_icky()) {
-                    continue;
-                }
-            }
-
-            look = false;
-            break;
-        }
+        return floor.is_in_quest() || floor.inside_arena || !floor.get_grid(pos).is_icky();
+    };
 
-        dis = dis * 2;
-        min = min / 2;
-        const int MAX_TELEPORT_TRIES = 100;
-        if (tries > MAX_TELEPORT_TRIES) {
-            return false;
-        }
+    constexpr auto MAX_TELEPORT_TRIES = 100;
+    const auto destination = pick_monster_teleport_destination(player_ptr, { oy, ox }, dis, dis / 2, MAX_TELEPORT_TRIES, is_candidate);
+    if (!destination) {
+        return false;
     }
 
+    const auto [ny, nx] = *destination;
     sound(SOUND_TPOTHER);
     player_ptr->current_floor_ptr->grid_array[oy][ox].m_idx = 0;
     player_ptr->current_floor_ptr->grid_array[ny][nx].m_idx = m_idx;
 
     m_ptr->fy = ny;
     m_ptr->fx = nx;
+    player_ptr->current_floor_ptr->monster_index.move(m_idx, { oy, ox }, { ny, nx });
 
     reset_target(m_ptr);
     update_monster(player_ptr, m_idx, true);
@@ -223,55 +234,23 @@ void teleport_monster_to(PlayerType *player_ptr, MONSTER_IDX m_idx, POSITION ty,
         return;
     }
 
-    POSITION ny = m_ptr->fy;
-    POSITION nx = m_ptr->fx;
     POSITION oy = m_ptr->fy;
     POSITION ox = m_ptr->fx;
-
-    POSITION dis = 2;
-    int min = dis / 2;
-    int attempts = 500;
-    bool look = true;
-    while (look && --attempts) {
-        if (dis > 200) {
-            dis = 200;
-        }
-
-        for (int i = 0; i < 500; i++) {
-            while (true) {
-                ny = rand_spread(ty, dis);
-                nx = rand_spread(tx, dis);
-                int d = distance(ty, tx, ny, nx);
-                if ((d >= min) && (d <= dis)) {
-                    break;
-                }
-            }
-
-            if (!in_bounds(player_ptr->current_floor_ptr, ny, nx)) {
-                continue;
-            }
-            if (!cave_monster_teleportable_bold(player_ptr, m_idx, ny, nx, mode)) {
-                continue;
-            }
-
-            look = false;
-            break;
-        }
-
-        dis = dis * 2;
-        min = min / 2;
-    }
-
-    if (attempts < 1) {
+    const auto is_candidate = [player_ptr, m_idx, mode](const Pos2D &pos) { return cave_monster_teleportable_bold(player_ptr, m_idx, pos.y, pos.x, mode); };
+    constexpr auto max_tries = 500;
+    const auto destination = pick_monster_teleport_destination(player_ptr, { ty, tx }, 2, 1, max_tries, is_candidate);
+    if (!destination) {
         return;
     }
 
+    const auto [ny, nx] = *destination;
     sound(SOUND_TPOTHER);
     player_ptr->current_floor_ptr->grid_array[oy][ox].m_idx = 0;
     player_ptr->current_floor_ptr->grid_array[ny][nx].m_idx = m_idx;
 
     m_ptr->fy = ny;
     m_ptr->fx = nx;
+    player_ptr->current_floor_ptr->monster_index.move(m_idx, { oy, ox }, { ny, nx });
 
     update_monster(player_ptr, m_idx, true);
     lite_spot(player_ptr, oy, ox);
@@ -323,32 +302,19 @@ bool teleport_player_aux(PlayerType *player_ptr, POSITION dis, bool is_quantum_e
         dis = max_distance;
     }
 
-    const auto &floor_ref = *player_ptr->current_floor_ptr;
-    const auto left = std::max(1, player_ptr->x - dis);
-    const auto right = std::min(floor_ref.width - 2, player_ptr->x + dis);
-    const auto top = std::max(1, player_ptr->y - dis);
-    const auto bottom = std::min(floor_ref.height - 2, player_ptr->y + dis);
-    auto total_candidates = 0;
-    for (auto y = top; y <= bottom; y++) {
-        for (auto x = left; x <= right; x++) {
-            if (!cave_player_teleportable_bold(player_ptr, y, x, mode)) {
-                continue;
-            }
-
-            int d = distance(player_ptr->y, player_ptr->x, y, x);
-            if (d > dis) {
-                continue;
-            }
-
-            total_candidates++;
-            candidates_at[d]++;
-        }
+    auto &floor = *player_ptr->current_floor_ptr;
+    const Pos2D p_pos(player_ptr->y, player_ptr->x);
+    const auto is_candidate = [player_ptr, mode](const Pos2D &pos) { return cave_player_teleportable_bold(player_ptr, pos.y, pos.x, mode); };
+    const auto candidates = floor.teleport_destinations.collect(floor, p_pos, dis, is_candidate);
+    if (candidates.empty()) {
+        return false;
     }
 
-    if (0 == total_candidates) {
-        return false;
+    for (const auto &candidate : candidates) {
+        candidates_at[distance(p_pos.y, p_pos.x, candidate.y, candidate.x)]++;
     }
 
+    const auto total_candidates = static_cast<int>(candidates.size());
     int cur_candidates;
     auto min = dis;
     for (cur_candidates = 0; min >= 0; min--) {
@@ -358,32 +324,19 @@ bool teleport_player_aux(PlayerType *player_ptr, POSITION dis, bool is_quantum_e
         }
     }
 
+    /* 候補は矩形を上から走査した順に並んでいる */
     auto pick = randint1(cur_candidates);
-
-    /* Search again the choosen location */
-    auto y = top;
+    auto y = 0;
     auto x = 0;
-    for (; y <= bottom; y++) {
-        for (x = left; x <= right; x++) {
-            if (!cave_player_teleportable_bold(player_ptr, y, x, mode)) {
-                continue;
-            }
-
-            int d = distance(player_ptr->y, player_ptr->x, y, x);
-            if (d > dis) {
-                continue;
-            }
-            if (d < min) {
-                continue;
-            }
-
-            pick--;
-            if (!pick) {
-                break;
-            }
+    for (const auto &candidate : candidates) {
+        if (distance(p_pos.y, p_pos.x, candidate.y, candidate.x) < min) {
+            continue;
         }
 
+        pick--;
         if (!pick) {
+            y = candidate.y;
+            x = candidate.x;
             break;
         }
     }
@@ -15,6 +15,7 @@
 #include "system/player-type-definition.h"
 #include "target/projection-path-calculator.h"
 #include "util/bit-flags-calculator.h"
+#include <algorithm>
 
 /*
  * Find the distance from (x, y) to a line.
@@ -195,20 +196,89 @@ bool in_disintegration_range(FloorType *floor_ptr, POSITION y1, POSITION x1, POS
     return true;
 }
 
+/*!
+ * @brief 効果範囲の一覧を空にする
+ * @details 確保済の領域は再利用する
+ */
+void ProjectionArea::clear()
+{
+    this->gy.clear();
+    this->gx.clear();
+    this->gm.assign(32, 0);
+}
+
+/*!
+ * @brief 効果範囲の index 番目のグリッドを設定する
+ */
+void ProjectionArea::set_grid(int index, POSITION y, POSITION x)
+{
+    if (index >= static_cast<int>(this->gy.size())) {
+        this->gy.resize(index + 1);
+        this->gx.resize(index + 1);
+    }
+
+    this->gy[index] = y;
+    this->gx[index] = x;
+}
+
+/*!
+ * @brief 距離 ring - 1 のグリッドの終端を設定する
+ * @details 読み出し側が gm[ring + 1] を参照しても範囲外にならないよう、1つ余分に確保する
+ */
+void ProjectionArea::set_ring_end(int ring, int index)
+{
+    if (ring + 1 >= static_cast<int>(this->gm.size())) {
+        this->gm.resize(ring + 2, 0);
+    }
+
+    this->gm[ring] = index;
+}
+
+/*!
+ * @brief 中心からの距離がちょうど dist となる相対座標の一覧を返す
+ * @param dist 中心からの距離
+ * @return 一辺 dist * 2 + 1 の正方形を上の行から走査した順に並んだ相対座標
+ * @details 距離ごとに初回だけ計算し、以降は使い回す
+ */
+const std::vector<Pos2D> &get_ring_offsets(POSITION dist)
+{
+    static std::vector<std::vector<Pos2D>> ring_offsets;
+    while (static_cast<int>(ring_offsets.size()) <= dist) {
+        const auto ring = static_cast<POSITION>(ring_offsets.size());
+        auto &offsets = ring_offsets.emplace_back();
+        for (auto y = -ring; y <= ring; y++) {
+            for (auto x = -ring; x <= ring; x++) {
+                if (distance(0, 0, y, x) == ring) {
+                    offsets.emplace_back(y, x);
+                }
+            }
+        }
+    }
+
+    return ring_offsets[dist];
+}
+
 /*
  * breath shape
+ * 始点からの距離 bdis の輪のうち、ブレスの中心から brad 以内のグリッドを中心に近い順に加える.
  */
-void breath_shape(PlayerType *player_ptr, const projection_path &path, int dist, int *pgrids, POSITION *gx, POSITION *gy, POSITION *gm, POSITION *pgm_rad, POSITION rad, POSITION y1, POSITION x1, POSITION y2, POSITION x2, AttributeType typ)
+void breath_shape(PlayerType *player_ptr, const projection_path &path, int dist, int *pgrids, ProjectionArea &area, POSITION *pgm_rad, POSITION rad, POSITION y1, POSITION x1, POSITION y2, POSITION x2, AttributeType typ)
 {
     POSITION by = y1;
     POSITION bx = x1;
     int brad = 0;
     int brev = rad * rad / dist;
     int bdis = 0;
-    int cdis;
     int path_n = 0;
     int mdis = distance(y1, x1, y2, x2) + rad;
 
+    struct Candidate {
+        POSITION cdis;
+        POSITION y;
+        POSITION x;
+    };
+
+    std::vector<Candidate> candidates;
     auto *floor_ptr = player_ptr->current_floor_ptr;
     while (bdis <= mdis) {
         if ((0 < dist) && (path_n < dist)) {
@@ -223,49 +293,48 @@ void breath_shape(PlayerType *player_ptr, const projection_path &path, int dist,
         }
 
         /* Travel from center outward */
-        for (cdis = 0; cdis <= brad; cdis++) {
-            for (POSITION y = by - cdis; y <= by + cdis; y++) {
-                for (POSITION x = bx - cdis; x <= bx + cdis; x++) {
-                    if (!in_bounds(floor_ptr, y, x)) {
-                        continue;
-                    }
-                    if (distance(y1, x1, y, x) != bdis) {
-                        continue;
-                    }
-                    if (distance(by, bx, y, x) != cdis) {
-                        continue;
-                    }
-
-                    switch (typ) {
-                    case AttributeType::LITE:
-                    case AttributeType::LITE_WEAK:
-                        /* Lights are stopped by opaque terrains */
-                        if (!los(player_ptr, by, bx, y, x)) {
-                            continue;
-                        }
-                        break;
-                    case AttributeType::DISINTEGRATE:
-                        /* Disintegration are stopped only by perma-walls */
-                        if (!in_disintegration_range(floor_ptr, by, bx, y, x)) {
-                            continue;
-                        }
-                        break;
-                    default:
-                        /* Ball explosions are stopped by walls */
-                        if (!projectable(player_ptr, by, bx, y, x)) {
-                            continue;
-                        }
-                        break;
-                    }
-
-                    gy[*pgrids] = y;
-                    gx[*pgrids] = x;
-                    (*pgrids)++;
+        candidates.clear();
+        for (const auto &offset : get_ring_offsets(bdis)) {
+            const auto y = y1 + offset.y;
+            const auto x = x1 + offset.x;
+            if (!in_bounds(floor_ptr, y, x)) {
+                continue;
+            }
+
+            const auto cdis = distance(by, bx, y, x);
+            if (cdis <= brad) {
+                candidates.push_back({ cdis, y, x });
+            }
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) { return a.cdis < b.cdis; });
+        for (const auto &[cdis, y, x] : candidates) {
+            switch (typ) {
+            case AttributeType::LITE:
+            case AttributeType::LITE_WEAK:
+                /* Lights are stopped by opaque terrains */
+                if (!los(player_ptr, by, bx, y, x)) {
+                    continue;
+                }
+                break;
+            case AttributeType::DISINTEGRATE:
+                /* Disintegration are stopped only by perma-walls */
+                if (!in_disintegration_range(floor_ptr, by, bx, y, x)) {
+                    continue;
                 }
+                break;
+            default:
+                /* Ball explosions are stopped by walls */
+                if (!projectable(player_ptr, by, bx, y, x)) {
+                    continue;
+                }
+                break;
             }
+
+            area.set_grid((*pgrids)++, y, x);
         }
 
-        gm[bdis + 1] = *pgrids;
+        area.set_ring_end(bdis + 1, *pgrids);
         brad = rad * (path_n + brev) / (dist + brev);
         bdis++;
     }
@@ -2,10 +2,30 @@
 
 #include "effect/attribute-types.h"
 #include "system/angband.h"
+#include "util/point-2d.h"
+#include <vector>
 
 class FloorType;
 class PlayerType;
 class projection_path;
+
+/*!
+ * @brief 効果範囲に含まれるグリッドの一覧
+ * @details gy/gx は効果を及ぼす順に並んだ座標、gm[d] は中心からの距離が d の最初のグリッドの添字 (gm[d + 1] がその終端).
+ * 設定していない gm の要素は0となる.
+ */
+class ProjectionArea {
+public:
+    std::vector<POSITION> gy;
+    std::vector<POSITION> gx;
+    std::vector<POSITION> gm;
+
+    void clear();
+    void set_grid(int index, POSITION y, POSITION x);
+    void set_ring_end(int ring, int index);
+};
+
 bool in_disintegration_range(FloorType *floor_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION x2);
-void breath_shape(PlayerType *player_ptr, const projection_path &path, int dist, int *pgrids, POSITION *gx, POSITION *gy, POSITION *gm, POSITION *pgm_rad, POSITION rad, POSITION y1, POSITION x1, POSITION y2, POSITION x2, AttributeType typ);
+const std::vector<Pos2D> &get_ring_offsets(POSITION dist);
+void breath_shape(PlayerType *player_ptr, const projection_path &path, int dist, int *pgrids, ProjectionArea &area, POSITION *pgm_rad, POSITION rad, POSITION y1, POSITION x1, POSITION y2, POSITION x2, AttributeType typ);
 POSITION dist_to_line(POSITION y, POSITION x, POSITION y1, POSITION x1, POSITION y2, POSITION x2);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "floor/floor-base-definitions.h"
+#include "floor/monster-spatial-index.h"
+#include "floor/teleport-destination-index.h"
 #include "monster/monster-timed-effect-types.h"
 #include "system/angband.h"
 #include "util/point-2d.h"
@@ -57,13 +59,16 @@ public:
     std::vector<ItemEntity> o_list; /*!< The array of dungeon items [max_o_idx] */
     OBJECT_IDX o_max = 0; /* Number of allocated objects */
     OBJECT_IDX o_cnt = 0; /* Number of live objects */
+    std::vector<OBJECT_IDX> o_free_list; /*!< 削除されて再利用できる o_list の添字 (使う時に空きかを確かめる) */
 
     std::vector<MonsterEntity> m_list; /*!< The array of dungeon monsters [max_m_idx] */
     MONSTER_IDX m_max = 0; /* Number of allocated monsters */
     MONSTER_IDX m_cnt = 0; /* Number of live monsters */
+    std::vector<MONSTER_IDX> m_free_list; /*!< 削除されて再利用できる m_list の添字 (使う時に空きかを確かめる) */
 
     std::vector<int16_t> mproc_list[MAX_MTIMED]{}; /*!< The array to process dungeon monsters[max_m_idx] */
     int16_t mproc_max[MAX_MTIMED]{}; /*!< Number of monsters to be processed */
+    std::vector<int16_t> mproc_positions[MAX_MTIMED]{}; /*!< mproc_list 内での各モンスターの位置 [max_m_idx] (含まれなければ-1) */
 
     POSITION_IDX lite_n = 0; //!< Array of grids lit by player lite
     std::array<POSITION, LITE_MAX> lite_y{};
@@ -81,6 +86,9 @@ public:
     std::array<POSITION, REDRAW_MAX> redraw_y{};
     std::array<POSITION, REDRAW_MAX> redraw_x{};
 
+    TeleportDestinationIndex teleport_destinations; //!< テレポート先候補の索引
+    MonsterSpatialIndex monster_index; //!< モンスターの位置の索引
+
     bool monster_noise = false;
     QuestId quest_number;
     bool inside_arena = false; /* Is character inside on_defeat_arena_monster? */
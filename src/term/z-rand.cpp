@@ -70,24 +70,41 @@ void Rand_state_init(void)
 }
 
 int rand_range(int a, int b)
+{
+    return rand_range(w_ptr->rng, a, b);
+}
+
+/*!
+ * @brief 指定した乱数生成器で a 以上 b 以下の一様乱数を返す
+ * @details 本来の乱数から分岐させた乱数系列で、本来の乱数と同じ手順の抽選を行うために使う
+ */
+int rand_range(Xoshiro128StarStar &rng, int a, int b)
 {
     if (a > b) {
         return a;
     }
     std::uniform_int_distribution<> d(a, b);
-    return d(w_ptr->rng);
+    return d(rng);
 }
 
 /*
  * Generate a random integer number of NORMAL distribution
  */
 int16_t randnor(int mean, int stand)
+{
+    return randnor(w_ptr->rng, mean, stand);
+}
+
+/*!
+ * @brief 指定した乱数生成器で正規分布に従う乱数を返す
+ */
+int16_t randnor(Xoshiro128StarStar &rng, int mean, int stand)
 {
     if (stand <= 0) {
         return static_cast<int16_t>(mean);
     }
     std::normal_distribution<> d(mean, stand);
-    auto result = std::round(d(w_ptr->rng));
+    auto result = std::round(d(rng));
     return static_cast<int16_t>(result);
 }
 
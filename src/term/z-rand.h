@@ -16,6 +16,8 @@
 #include <type_traits>
 #include <utility>
 
+class Xoshiro128StarStar;
+
 /**** Available constants ****/
 
 /*
@@ -30,6 +32,7 @@
  * Note: rand_range(0,N-1) == randint0(N)
  */
 int rand_range(int a, int b);
+int rand_range(Xoshiro128StarStar &rng, int a, int b);
 
 /*
  * Generates a random long integer X where O<=X<M.
@@ -68,6 +71,7 @@ int rand_range(int a, int b);
 
 void Rand_state_init(void);
 int16_t randnor(int mean, int stand);
+int16_t randnor(Xoshiro128StarStar &rng, int mean, int stand);
 int16_t damroll(DICE_NUMBER num, DICE_SID sides);
 int16_t maxroll(DICE_NUMBER num, DICE_SID sides);
 int32_t div_round(int32_t n, int32_t d);
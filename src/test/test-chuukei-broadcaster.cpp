@@ -0,0 +1,151 @@
+/*!
+ * @brief 中継(観戦)用のライブ配信クラスのテストプログラム
+ *
+ * srcディレクトリで以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -DHAVE_SYS_EPOLL_H -I. term/z-util.cpp term/z-form.cpp util/angband-files.cpp util/string-processor.cpp io/movie-container.cpp io/chuukei-broadcaster.cpp test/test-chuukei-broadcaster.cpp
+ *
+ * ループバックアドレスで配信を開始し、途中から接続した観戦者を含めて受信したものをムービーとして読み込み、
+ * 各観戦者が最初のキーフレームから、それを0とした描画時刻で受信していることを確かめる
+ */
+
+#include "io/chuukei-broadcaster.h"
+#include "io/movie-container.h"
+
+#include <arpa/inet.h>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std::literals::string_view_literals;
+
+/*
+ * 配信を受信する観戦者
+ */
+class Spectator {
+public:
+    explicit Spectator(uint16_t port)
+        : fd(socket(AF_INET, SOCK_STREAM, 0))
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        assert(connect(this->fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+    }
+
+    ~Spectator()
+    {
+        close(this->fd);
+    }
+
+    /*
+     * 受信が途切れるまで読み込む
+     */
+    void receive()
+    {
+        pollfd fds{ this->fd, POLLIN, 0 };
+        while (poll(&fds, 1, 500) > 0) {
+            char buf[4096];
+            const auto len = read(this->fd, buf, sizeof(buf));
+            if (len <= 0) {
+                break;
+            }
+
+            this->received.append(buf, len);
+        }
+    }
+
+    /*
+     * 受信したものをムービーとして読み込む
+     */
+    std::vector<MovieBlock> read_blocks() const
+    {
+        char path[] = "/tmp/test-chuukei-XXXXXX";
+        const auto movie_fd = mkstemp(path);
+        assert(movie_fd >= 0);
+        assert(write(movie_fd, this->received.data(), this->received.size()) == static_cast<ssize_t>(this->received.size()));
+        assert(MovieContainerReader::is_container(movie_fd));
+
+        MovieContainerReader reader(movie_fd);
+        std::vector<MovieBlock> blocks;
+        while (auto block = reader.read_block()) {
+            blocks.push_back(std::move(*block));
+        }
+
+        close(movie_fd);
+        unlink(path);
+        return blocks;
+    }
+
+private:
+    int fd;
+    std::string received;
+};
+
+/*
+ * 観戦者の接続による、キーフレームの送信要求を待つ
+ */
+static void wait_keyframe_request(ChuukeiBroadcaster &broadcaster)
+{
+    for (auto i = 0; i < 100; i++) {
+        if (broadcaster.consume_keyframe_request()) {
+            return;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    assert(false);
+}
+
+static void assert_block(const MovieBlock &block, MovieBlockType type, int timestamp, std::string_view payload)
+{
+    assert(block.type == type);
+    assert(block.timestamp == timestamp);
+    assert(block.payload == payload);
+}
+
+int main()
+{
+    auto &broadcaster = ChuukeiBroadcaster::get_instance();
+    assert(!broadcaster.start(0, "not an address"));
+    assert(broadcaster.start(0));
+
+    Spectator first(broadcaster.get_port());
+    wait_keyframe_request(broadcaster);
+    broadcaster.post_frame(5, "before keyframe");
+    broadcaster.post_keyframe(30, "K1\0K2"sv);
+    broadcaster.post_frame(32, "K1\0x"sv);
+    broadcaster.post_frame(35, "y");
+
+    Spectator late(broadcaster.get_port());
+    wait_keyframe_request(broadcaster);
+    broadcaster.post_keyframe(40, "K3");
+    broadcaster.post_frame(41, "K3\0z"sv);
+
+    first.receive();
+    late.receive();
+    broadcaster.stop();
+
+    const auto first_blocks = first.read_blocks();
+    assert(first_blocks.size() == 5);
+    assert_block(first_blocks[0], MovieBlockType::KEYFRAME, 0, "K1\0K2"sv);
+    assert_block(first_blocks[1], MovieBlockType::FRAME, 2, "K1\0x"sv);
+    assert_block(first_blocks[2], MovieBlockType::FRAME, 5, "y");
+    assert_block(first_blocks[3], MovieBlockType::KEYFRAME, 10, "K3");
+    assert_block(first_blocks[4], MovieBlockType::FRAME, 11, "K3\0z"sv);
+
+    const auto late_blocks = late.read_blocks();
+    assert(late_blocks.size() == 2);
+    assert_block(late_blocks[0], MovieBlockType::KEYFRAME, 0, "K3");
+    assert_block(late_blocks[1], MovieBlockType::FRAME, 1, "K3\0z"sv);
+}
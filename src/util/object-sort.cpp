@@ -13,6 +13,7 @@
 #include "system/item-entity.h"
 #include "system/monster-race-info.h"
 #include "system/player-type-definition.h"
+#include <optional>
 
 static int get_item_sort_rank(const ItemEntity &item)
 {
@@ -32,14 +33,12 @@ static int get_item_sort_rank(const ItemEntity &item)
 }
 
 /*!
- * @brief オブジェクトを定義された基準に従いソートするための関数 /
- * Check if we have space for an item in the pack without overflow
+ * @brief アイテムの価値以外の基準でソート順を比較する
  * @param o_ptr 比較対象オブジェクトの構造体参照ポインタ1
- * @param o_value o_ptrのアイテム価値（手動であらかじめ代入する必要がある？）
  * @param j_ptr 比較対象オブジェクトの構造体参照ポインタ2
- * @return o_ptrの方が上位ならばTRUEを返す。
+ * @return o_ptrの方が上位ならばtrue、下位ならばfalse、価値で決める場合はnullopt
  */
-bool object_sort_comp(PlayerType *player_ptr, ItemEntity *o_ptr, int32_t o_value, ItemEntity *j_ptr)
+static std::optional<bool> compare_without_value(PlayerType *player_ptr, ItemEntity *o_ptr, ItemEntity *j_ptr)
 {
     if (!j_ptr->is_valid()) {
         return true;
@@ -150,5 +149,33 @@ bool object_sort_comp(PlayerType *player_ptr, ItemEntity *o_ptr, int32_t o_value
         break;
     }
 
-    return o_value > j_ptr->get_price();
+    return std::nullopt;
+}
+
+/*!
+ * @brief オブジェクトを定義された基準に従いソートするための関数 /
+ * Check if we have space for an item in the pack without overflow
+ * @param o_ptr 比較対象オブジェクトの構造体参照ポインタ1
+ * @param o_value o_ptrのアイテム価値（手動であらかじめ代入する必要がある？）
+ * @param j_ptr 比較対象オブジェクトの構造体参照ポインタ2
+ * @return o_ptrの方が上位ならばTRUEを返す。
+ */
+bool object_sort_comp(PlayerType *player_ptr, ItemEntity *o_ptr, int32_t o_value, ItemEntity *j_ptr)
+{
+    const auto result = compare_without_value(player_ptr, o_ptr, j_ptr);
+    return result ? *result : (o_value > j_ptr->get_price());
+}
+
+/*!
+ * @brief オブジェクトを定義された基準に従いソートするための関数 (両方の価値を計算済の場合)
+ * @param o_ptr 比較対象オブジェクトの構造体参照ポインタ1
+ * @param o_value o_ptrのアイテム価値
+ * @param j_ptr 比較対象オブジェクトの構造体参照ポインタ2
+ * @param j_value j_ptrのアイテム価値
+ * @return o_ptrの方が上位ならばTRUEを返す。
+ */
+bool object_sort_comp(PlayerType *player_ptr, ItemEntity *o_ptr, int32_t o_value, ItemEntity *j_ptr, int32_t j_value)
+{
+    const auto result = compare_without_value(player_ptr, o_ptr, j_ptr);
+    return result ? *result : (o_value > j_value);
 }
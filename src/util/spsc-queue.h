@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+/*!
+ * @brief 生産者と消費者が1つずつのロックフリーなリングバッファ
+ * @tparam T 要素の型
+ * @tparam N 容量 (2のべき乗)
+ * @details 入力スレッドからゲームスレッドへキー入力を渡すために用いる.
+ * push() は生産者スレッドのみ、pop() と wait() は消費者スレッドのみが呼ぶこと.
+ */
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert((N > 0) && ((N & (N - 1)) == 0), "capacity must be a power of 2");
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /*!
+     * @brief 要素を末尾に追加する
+     * @return 満杯で追加できなければfalse
+     */
+    bool push(const T &value)
+    {
+        const auto head = this->head_count.load(std::memory_order_relaxed);
+        if (head - this->tail_count.load(std::memory_order_acquire) == N) {
+            return false;
+        }
+
+        this->buffer[head & (N - 1)] = value;
+        this->head_count.store(head + 1, std::memory_order_release);
+        this->head_count.notify_one();
+        return true;
+    }
+
+    /*!
+     * @brief 先頭の要素を取り出す
+     * @return 空ならばnullopt
+     */
+    std::optional<T> pop()
+    {
+        const auto tail = this->tail_count.load(std::memory_order_relaxed);
+        if (tail == this->head_count.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+
+        auto value = this->buffer[tail & (N - 1)];
+        this->tail_count.store(tail + 1, std::memory_order_release);
+        return value;
+    }
+
+    bool empty() const
+    {
+        return this->tail_count.load(std::memory_order_relaxed) == this->head_count.load(std::memory_order_acquire);
+    }
+
+    /*!
+     * @brief 要素が追加されるまで待つ
+     * @details 空でなければ即座に戻る. システムコールによるポーリングは行わない.
+     */
+    void wait() const
+    {
+        const auto tail = this->tail_count.load(std::memory_order_relaxed);
+        this->head_count.wait(tail, std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, N> buffer{};
+    alignas(64) std::atomic<size_t> head_count = 0; //!< 生産者が書き込んだ要素の累計
+    alignas(64) std::atomic<size_t> tail_count = 0; //!< 消費者が取り出した要素の累計
+};
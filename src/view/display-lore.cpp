@@ -11,6 +11,7 @@
 #include "locale/japanese.h"
 #include "lore/lore-calculator.h"
 #include "lore/lore-util.h"
+#include "lore/monster-lore-cache.h"
 #include "lore/monster-lore.h"
 #include "monster-attack/monster-attack-table.h"
 #include "monster-race/monster-race.h"
@@ -87,7 +88,7 @@ void screen_roff(PlayerType *player_ptr, MonsterRaceId r_idx, monster_lore_mode
     msg_erase();
     term_erase(0, 1);
     hook_c_roff = c_roff;
-    process_monster_lore(player_ptr, r_idx, mode);
+    MonsterLoreCache::get_instance().output(player_ptr, r_idx, mode);
     roff_top(r_idx);
 }
 
@@ -105,7 +106,7 @@ void display_roff(PlayerType *player_ptr)
     term_gotoxy(0, 1);
     hook_c_roff = c_roff;
     MonsterRaceId r_idx = player_ptr->monster_race_idx;
-    process_monster_lore(player_ptr, r_idx, MONSTER_LORE_NORMAL);
+    MonsterLoreCache::get_instance().output(player_ptr, r_idx, MONSTER_LORE_NORMAL);
     roff_top(r_idx);
 }
 
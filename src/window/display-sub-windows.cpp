@@ -43,6 +43,7 @@
 #include "view/display-messages.h"
 #include "view/display-player.h"
 #include "view/object-describer.h"
+#include "window/found-item-list.h"
 #include "window/main-window-equipments.h"
 #include "window/main-window-util.h"
 #include "world/world.h"
@@ -51,7 +52,6 @@
 #include <mutex>
 #include <sstream>
 #include <string>
-#include <util/object-sort.h>
 
 /*! サブウィンドウ表示用の ItemTester オブジェクト */
 static std::unique_ptr<ItemTester> fix_item_tester = std::make_unique<AllMatchItemTester>();
@@ -637,30 +637,8 @@ static void display_found_item_list(PlayerType *player_ptr)
         return;
     }
 
-    auto *floor_ptr = player_ptr->current_floor_ptr;
-
-    // 所持品一覧と同じ順にソートする
-    // あらかじめfloor_ptr->o_list から↓項目を取り除く
-    // bi_idが0
-    // OM_FOUNDフラグが立っていない
-    // ItemKindTypeがGOLD
-    std::vector<ItemEntity *> found_item_list;
-    for (auto &item : floor_ptr->o_list) {
-        const auto is_item_to_display =
-            item.is_valid() && (item.number > 0) &&
-            item.marked.has(OmType::FOUND) && (item.bi_key.tval() != ItemKindType::GOLD);
-
-        if (is_item_to_display) {
-            found_item_list.push_back(&item);
-        }
-    }
-
-    std::sort(
-        found_item_list.begin(), found_item_list.end(),
-        [player_ptr](ItemEntity *left, ItemEntity *right) -> bool {
-            return object_sort_comp(player_ptr, left, left->get_price(), right);
-        });
-
+    const auto &floor = *player_ptr->current_floor_ptr;
+    const auto &found_item_list = FoundItemList::get_instance().update(player_ptr);
     term_clear();
     term_gotoxy(0, 0);
 
@@ -669,7 +647,7 @@ static void display_found_item_list(PlayerType *player_ptr)
 
     // 発見済みのアイテムを表示
     TERM_LEN term_y = 1;
-    for (auto item : found_item_list) {
+    for (const auto *entry : found_item_list) {
         // 途中で行数が足りなくなったら終了。
         if (term_y >= hgt) {
             break;
@@ -678,17 +656,13 @@ static void display_found_item_list(PlayerType *player_ptr)
         term_gotoxy(0, term_y);
 
         // アイテムシンボル表示
-        const auto symbol_code = item->get_symbol();
-        const auto symbol = format(" %c ", symbol_code);
-        const auto color_code_for_symbol = item->get_color();
-        term_addstr(-1, color_code_for_symbol, symbol);
-
-        const auto item_name = describe_flavor(player_ptr, item, 0);
-        const auto color_code_for_item = tval_to_attr[enum2i(item->bi_key.tval()) % 128];
-        term_addstr(-1, color_code_for_item, item_name);
+        const auto symbol = format(" %c ", entry->symbol);
+        term_addstr(-1, entry->symbol_color, symbol);
+        term_addstr(-1, entry->name_color, entry->name);
 
         // アイテム座標表示
-        const auto item_location = format("(X:%3d Y:%3d)", item->ix, item->iy);
+        const auto &item = floor.o_list[entry->o_idx];
+        const auto item_location = format("(X:%3d Y:%3d)", item.ix, item.iy);
         prt(item_location, term_y, wid - item_location.length() - 1);
 
         ++term_y;
@@ -0,0 +1,131 @@
+/*!
+ * @brief 発見済みのアイテム一覧の差分更新
+ */
+
+#include "window/found-item-list.h"
+#include "flavor/flavor-describer.h"
+#include "object/tval-types.h"
+#include "system/floor-type-definition.h"
+#include "system/item-entity.h"
+#include "system/player-type-definition.h"
+#include "term/gameterm.h"
+#include "util/enum-converter.h"
+#include "util/object-sort.h"
+#include <algorithm>
+
+FoundItemList FoundItemList::instance{};
+
+FoundItemList &FoundItemList::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief 発見済みのアイテム一覧を最新の状態にする
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return 所持品一覧と同じ順に並べた発見済みのアイテム
+ * @details 状態の変わったアイテムだけ名前と価値を計算し直し、変化が無ければ前回の並び順をそのまま返す.
+ * 返した参照は次に update() を呼ぶまで有効.
+ */
+const std::vector<const FoundItemList::Entry *> &FoundItemList::update(PlayerType *player_ptr)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    if (this->cached_entries.size() != floor.o_list.size()) {
+        this->cached_entries.assign(floor.o_list.size(), std::nullopt);
+        this->found_entries.clear();
+    }
+
+    auto is_changed = false;
+    auto found_count = 0U;
+    for (OBJECT_IDX o_idx = 0; o_idx < static_cast<OBJECT_IDX>(floor.o_list.size()); o_idx++) {
+        auto &item = floor.o_list[o_idx];
+        auto &cached_entry = this->cached_entries[o_idx];
+
+        // bi_idが0、OM_FOUNDフラグが立っていない、ItemKindTypeがGOLD のいずれかであれば表示しない
+        const auto is_item_to_display =
+            item.is_valid() && (item.number > 0) &&
+            item.marked.has(OmType::FOUND) && (item.bi_key.tval() != ItemKindType::GOLD);
+        if (!is_item_to_display) {
+            if (cached_entry) {
+                cached_entry.reset();
+                is_changed = true;
+            }
+
+            continue;
+        }
+
+        found_count++;
+        auto signature = make_signature(item);
+        if (cached_entry && (cached_entry->signature == signature)) {
+            continue;
+        }
+
+        const auto name = describe_flavor(player_ptr, &item, 0);
+        cached_entry = CachedEntry{
+            std::move(signature),
+            { o_idx, name, item.get_price(), item.get_symbol(), item.get_color(), tval_to_attr[enum2i(item.bi_key.tval()) % 128] },
+        };
+        is_changed = true;
+    }
+
+    if (!is_changed && (found_count == this->found_entries.size())) {
+        return this->found_entries;
+    }
+
+    this->found_entries.clear();
+    for (const auto &cached_entry : this->cached_entries) {
+        if (cached_entry) {
+            this->found_entries.push_back(&cached_entry->entry);
+        }
+    }
+
+    std::sort(this->found_entries.begin(), this->found_entries.end(),
+        [player_ptr, &floor](const Entry *left, const Entry *right) {
+            return object_sort_comp(player_ptr, &floor.o_list[left->o_idx], left->price, &floor.o_list[right->o_idx], right->price);
+        });
+    return this->found_entries;
+}
+
+/*!
+ * @brief 名前・価値・並び順を左右するアイテムの状態を控える
+ * @param item アイテムへの参照
+ * @return アイテムの状態
+ * @details ベースアイテムの鑑定状態はアイテムの外で変わるので、併せて控える
+ */
+FoundItemList::Signature FoundItemList::make_signature(const ItemEntity &item)
+{
+    return {
+        item.bi_id,
+        item.pval,
+        item.discount,
+        item.number,
+        item.fixed_artifact_idx,
+        item.ego_idx,
+        item.activation_id,
+        item.chest_level,
+        item.captured_monster_speed,
+        item.captured_monster_current_hp,
+        item.captured_monster_max_hp,
+        item.fuel,
+        item.smith_hit,
+        item.smith_damage,
+        item.smith_effect,
+        item.smith_act_idx,
+        item.to_h,
+        item.to_d,
+        item.to_a,
+        item.ac,
+        item.dd,
+        item.ds,
+        item.timeout,
+        item.ident,
+        item.marked,
+        item.inscription,
+        item.randart_name,
+        item.feeling,
+        item.art_flags,
+        item.curse_flags,
+        item.is_aware(),
+        item.is_tried(),
+    };
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "object-enchant/object-ego.h"
+#include "object-enchant/tr-flags.h"
+#include "object-enchant/trc-types.h"
+#include "object/object-mark-types.h"
+#include "system/angband.h"
+#include "util/flag-group.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class FixedArtifactId : short;
+enum class RandomArtActType : short;
+enum class SmithEffectType : int16_t;
+class ItemEntity;
+class PlayerType;
+
+/*!
+ * @brief 発見済みのアイテム一覧の表示内容を保持するクラス
+ * @details o_list の添字ごとに、アイテムの名前・価値・シンボルを保持する.
+ * 名前や価値を左右するアイテムの状態を一緒に控えておき、状態が変わったアイテムだけを計算し直す.
+ * 一覧の並び順も、発見済のアイテムが増減したか状態が変わった時だけソートし直す.
+ */
+class FoundItemList {
+public:
+    /*!
+     * @brief 一覧に表示するアイテム1つ分の内容
+     */
+    struct Entry {
+        OBJECT_IDX o_idx;
+        std::string name;
+        int price;
+        char symbol;
+        TERM_COLOR symbol_color;
+        TERM_COLOR name_color;
+    };
+
+    FoundItemList(const FoundItemList &) = delete;
+    FoundItemList(FoundItemList &&) = delete;
+    FoundItemList &operator=(const FoundItemList &) = delete;
+    FoundItemList &operator=(FoundItemList &&) = delete;
+    ~FoundItemList() = default;
+
+    static FoundItemList &get_instance();
+    const std::vector<const Entry *> &update(PlayerType *player_ptr);
+
+private:
+    FoundItemList() = default;
+
+    /*!
+     * @brief 名前・価値・並び順を左右するアイテムの状態
+     */
+    struct Signature {
+        short bi_id;
+        PARAMETER_VALUE pval;
+        byte discount;
+        ITEM_NUMBER number;
+        FixedArtifactId fixed_artifact_idx;
+        EgoType ego_idx;
+        RandomArtActType activation_id;
+        byte chest_level;
+        uint8_t captured_monster_speed;
+        short captured_monster_current_hp;
+        short captured_monster_max_hp;
+        short fuel;
+        byte smith_hit;
+        byte smith_damage;
+        std::optional<SmithEffectType> smith_effect;
+        std::optional<RandomArtActType> smith_act_idx;
+        HIT_PROB to_h;
+        int to_d;
+        ARMOUR_CLASS to_a;
+        ARMOUR_CLASS ac;
+        DICE_NUMBER dd;
+        DICE_SID ds;
+        TIME_EFFECT timeout;
+        byte ident;
+        EnumClassFlagGroup<OmType> marked;
+        std::optional<std::string> inscription;
+        std::optional<std::string> randart_name;
+        byte feeling;
+        TrFlags art_flags;
+        EnumClassFlagGroup<CurseTraitType> curse_flags;
+        bool is_aware;
+        bool is_tried;
+
+        bool operator==(const Signature &other) const = default;
+    };
+
+    struct CachedEntry {
+        Signature signature;
+        Entry entry;
+    };
+
+    static FoundItemList instance;
+    std::vector<std::optional<CachedEntry>> cached_entries;
+    std::vector<const Entry *> found_entries;
+
+    static Signature make_signature(const ItemEntity &item);
+};
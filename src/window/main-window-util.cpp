@@ -13,12 +13,14 @@
 #include "system/item-entity.h"
 #include "system/monster-race-info.h"
 #include "system/player-type-definition.h"
+#include "system/redrawing-flags-updater.h"
 #include "term/gameterm.h"
 #include "term/screen-processor.h"
 #include "term/term-color-types.h"
 #include "timed-effect/player-hallucination.h"
 #include "timed-effect/timed-effects.h"
 #include "view/display-map.h"
+#include "window/overview-map.h"
 #include "world/world.h"
 #include <string>
 #include <string_view>
@@ -75,6 +77,8 @@ void print_map(PlayerType *player_ptr)
     wid -= COL_MAP + 2;
     hgt -= ROW_MAP + 2;
 
+    OverviewMap::get_instance().invalidate();
+    RedrawingFlagsUpdater::get_instance().set_flag(SubWindowRedrawingFlag::OVERHEAD);
     int v;
     (void)term_get_cursor(&v);
 
@@ -165,19 +169,10 @@ static void display_shortened_item_name(PlayerType *player_ptr, ItemEntity *o_pt
  * @details
  * メインウィンドウ('M'コマンド)、サブウィンドウ兼(縮小図)用。
  * use_bigtile時に横の描画列数は1/2になる。
+ * 縮小後の表示内容は OverviewMap が保持しており、前回から変化したグリッドの分だけ計算し直す。
  */
 void display_map(PlayerType *player_ptr, int *cy, int *cx)
 {
-    int i, j, x, y;
-
-    TERM_COLOR ta;
-    char tc;
-
-    byte tp;
-
-    bool old_view_special_lite = view_special_lite;
-    bool old_view_granite_lite = view_granite_lite;
-
     auto border_width = use_bigtile ? 2 : 1; //!< @note 枠線幅
     auto [wid, hgt] = term_get_size();
     hgt -= 2;
@@ -186,92 +181,29 @@ void display_map(PlayerType *player_ptr, int *cy, int *cx)
         wid = wid / 2 - 1;
     }
 
-    auto *floor_ptr = player_ptr->current_floor_ptr;
-    const auto yrat = (floor_ptr->height + hgt - 1) / hgt;
-    const auto xrat = (floor_ptr->width + wid - 1) / wid;
-    view_special_lite = false;
-    view_granite_lite = false;
-
-    using std::vector;
-    vector<vector<TERM_COLOR>> ma(hgt + 2, vector<TERM_COLOR>(wid + 2, TERM_WHITE));
-    vector<vector<char>> mc(hgt + 2, vector<char>(wid + 2, ' '));
-    vector<vector<byte>> mp(hgt + 2, vector<byte>(wid + 2, 0));
-    vector<vector<int>> match_autopick_yx(hgt + 2, vector<int>(wid + 2, -1));
-    vector<vector<ItemEntity *>> object_autopick_yx(hgt + 2, vector<ItemEntity *>(wid + 2, nullptr));
-
-    vector<vector<TERM_COLOR>> bigma(floor_ptr->height + 2, vector<TERM_COLOR>(floor_ptr->width + 2, TERM_WHITE));
-    vector<vector<char>> bigmc(floor_ptr->height + 2, vector<char>(floor_ptr->width + 2, ' '));
-    vector<vector<byte>> bigmp(floor_ptr->height + 2, vector<byte>(floor_ptr->width + 2, 0));
-
-    for (i = 0; i < floor_ptr->width; ++i) {
-        for (j = 0; j < floor_ptr->height; ++j) {
-            x = i / xrat + 1;
-            y = j / yrat + 1;
-
-            match_autopick = -1;
-            autopick_obj = nullptr;
-            feat_priority = -1;
-            map_info(player_ptr, j, i, &ta, &tc, &ta, &tc);
-            tp = (byte)feat_priority;
-            if (match_autopick != -1 && (match_autopick_yx[y][x] == -1 || match_autopick_yx[y][x] > match_autopick)) {
-                match_autopick_yx[y][x] = match_autopick;
-                object_autopick_yx[y][x] = autopick_obj;
-                tp = 0x7f;
-            }
-
-            bigmc[j + 1][i + 1] = tc;
-            bigma[j + 1][i + 1] = ta;
-            bigmp[j + 1][i + 1] = tp;
-        }
-    }
-
-    for (j = 0; j < floor_ptr->height; ++j) {
-        for (i = 0; i < floor_ptr->width; ++i) {
-            x = i / xrat + 1;
-            y = j / yrat + 1;
-
-            tc = bigmc[j + 1][i + 1];
-            ta = bigma[j + 1][i + 1];
-            tp = bigmp[j + 1][i + 1];
-            if (mp[y][x] == tp) {
-                int t;
-                int cnt = 0;
-
-                for (t = 0; t < 8; t++) {
-                    if (tc == bigmc[j + 1 + ddy_cdd[t]][i + 1 + ddx_cdd[t]] && ta == bigma[j + 1 + ddy_cdd[t]][i + 1 + ddx_cdd[t]]) {
-                        cnt++;
-                    }
-                }
-                if (cnt <= 4) {
-                    tp++;
-                }
-            }
-
-            if (mp[y][x] < tp) {
-                mc[y][x] = tc;
-                ma[y][x] = ta;
-                mp[y][x] = tp;
+    auto &overview_map = OverviewMap::get_instance();
+    overview_map.update(player_ptr, wid, hgt);
+    const auto yrat = overview_map.get_yrat();
+    const auto xrat = overview_map.get_xrat();
+    for (auto y = 0; y < hgt + 2; ++y) {
+        term_gotoxy(COL_MAP, y);
+        for (auto x = 0; x < wid + 2; ++x) {
+            TERM_COLOR ta = TERM_WHITE;
+            char tc;
+            const auto is_vertical_border = (y == 0) || (y == hgt + 1);
+            const auto is_horizontal_border = (x == 0) || (x == wid + 1);
+            if (is_vertical_border && is_horizontal_border) {
+                tc = '+';
+            } else if (is_vertical_border) {
+                tc = '-';
+            } else if (is_horizontal_border) {
+                tc = '|';
+            } else {
+                const auto &cell = overview_map.get_cell(y, x);
+                ta = cell.attr;
+                tc = cell.ch;
             }
-        }
-    }
 
-    x = wid + 1;
-    y = hgt + 1;
-
-    mc[0][0] = mc[0][x] = mc[y][0] = mc[y][x] = '+';
-    for (x = 1; x <= wid; x++) {
-        mc[0][x] = mc[y][x] = '-';
-    }
-
-    for (y = 1; y <= hgt; y++) {
-        mc[y][0] = mc[y][x] = '|';
-    }
-
-    for (y = 0; y < hgt + 2; ++y) {
-        term_gotoxy(COL_MAP, y);
-        for (x = 0; x < wid + 2; ++x) {
-            ta = ma[y][x];
-            tc = mc[y][x];
             if (!use_graphics) {
                 if (w_ptr->timewalk_m_idx) {
                     ta = TERM_DARK;
@@ -286,12 +218,13 @@ void display_map(PlayerType *player_ptr, int *cy, int *cx)
         }
     }
 
-    for (y = 1; y < hgt + 1; ++y) {
+    for (auto y = 1; y < hgt + 1; ++y) {
         match_autopick = -1;
-        for (x = 1; x <= wid; x++) {
-            if (match_autopick_yx[y][x] != -1 && (match_autopick > match_autopick_yx[y][x] || match_autopick == -1)) {
-                match_autopick = match_autopick_yx[y][x];
-                autopick_obj = object_autopick_yx[y][x];
+        for (auto x = 1; x <= wid; x++) {
+            const auto &cell = overview_map.get_cell(y, x);
+            if (cell.match_autopick != -1 && (match_autopick > cell.match_autopick || match_autopick == -1)) {
+                match_autopick = cell.match_autopick;
+                autopick_obj = &player_ptr->current_floor_ptr->o_list[cell.item_idx];
             }
         }
 
@@ -307,9 +240,6 @@ void display_map(PlayerType *player_ptr, int *cy, int *cx)
     } else {
         (*cx) = (player_ptr->x / xrat + 1) * 2 + COL_MAP;
     }
-
-    view_special_lite = old_view_special_lite;
-    view_granite_lite = old_view_granite_lite;
 }
 
 void set_term_color(PlayerType *player_ptr, POSITION y, POSITION x, TERM_COLOR *ap, char *cp)
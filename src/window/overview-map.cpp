@@ -0,0 +1,271 @@
+/*!
+ * @brief 縮小マップの差分更新
+ */
+
+#include "window/overview-map.h"
+#include "floor/geometry.h"
+#include "game-option/map-screen-options.h"
+#include "system/floor-type-definition.h"
+#include "system/grid-type-definition.h"
+#include "system/item-entity.h"
+#include "system/player-type-definition.h"
+#include "view/display-map.h"
+#include "window/main-window-util.h"
+#include <algorithm>
+
+OverviewMap OverviewMap::instance{};
+
+OverviewMap &OverviewMap::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief 保持している表示内容を破棄し、次の更新で全体を計算し直させる
+ */
+void OverviewMap::invalidate()
+{
+    this->is_valid = false;
+}
+
+/*!
+ * @brief 表示内容が変化したグリッドを記録する
+ * @param y 変化したグリッドのy座標
+ * @param x 変化したグリッドのx座標
+ * @details 表示内容を保持していない間は記録しない
+ */
+void OverviewMap::mark_changed(POSITION y, POSITION x)
+{
+    if (!this->is_valid || (y < 0) || (y >= this->floor_height) || (x < 0) || (x >= this->floor_width)) {
+        return;
+    }
+
+    const auto index = y * this->floor_width + x;
+    if (this->is_grid_changed[index]) {
+        return;
+    }
+
+    this->is_grid_changed[index] = true;
+    this->changed_grids.emplace_back(y, x);
+}
+
+/*!
+ * @brief 縮小マップの表示内容を更新する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param wid 描画桁数 (枠線抜)
+ * @param hgt 描画行数 (枠線抜)
+ */
+void OverviewMap::update(PlayerType *player_ptr, int wid, int hgt)
+{
+    const auto &floor = *player_ptr->current_floor_ptr;
+    const auto is_floor_changed = !this->is_valid || (floor.height != this->floor_height) || (floor.width != this->floor_width);
+    if (is_floor_changed) {
+        this->floor_height = floor.height;
+        this->floor_width = floor.width;
+        this->grids.assign((floor.height + 2) * (floor.width + 2), Symbol{});
+        this->is_grid_changed.assign(floor.height * floor.width, false);
+        this->changed_grids.clear();
+    }
+
+    const auto yrat = (floor.height + hgt - 1) / hgt;
+    const auto xrat = (floor.width + wid - 1) / wid;
+    const auto is_layout_changed = is_floor_changed || (wid != this->wid) || (hgt != this->hgt) || (yrat != this->yrat) || (xrat != this->xrat);
+    if (is_layout_changed) {
+        this->wid = wid;
+        this->hgt = hgt;
+        this->yrat = yrat;
+        this->xrat = xrat;
+        this->is_cell_changed.assign((hgt + 2) * (wid + 2), false);
+        this->changed_cells.clear();
+    }
+
+    const auto old_view_special_lite = view_special_lite;
+    const auto old_view_granite_lite = view_granite_lite;
+    view_special_lite = false;
+    view_granite_lite = false;
+    if (is_floor_changed) {
+        for (POSITION y = 0; y < floor.height; y++) {
+            for (POSITION x = 0; x < floor.width; x++) {
+                this->update_grid(player_ptr, y, x);
+            }
+        }
+    } else {
+        for (const auto &[y, x] : this->changed_grids) {
+            this->update_grid(player_ptr, y, x);
+        }
+    }
+
+    view_special_lite = old_view_special_lite;
+    view_granite_lite = old_view_granite_lite;
+    if (is_layout_changed) {
+        this->cells.assign((hgt + 2) * (wid + 2), Symbol{});
+        for (auto y = 1; y <= hgt; y++) {
+            for (auto x = 1; x <= wid; x++) {
+                this->update_cell(y, x);
+            }
+        }
+    } else {
+        for (const auto &[grid_y, grid_x] : this->changed_grids) {
+            for (auto d = 0; d < 9; d++) {
+                const auto y = grid_y + ddy_ddd[d];
+                const auto x = grid_x + ddx_ddd[d];
+                if ((y < 0) || (y >= floor.height) || (x < 0) || (x >= floor.width)) {
+                    continue;
+                }
+
+                const auto cell_y = y / yrat + 1;
+                const auto cell_x = x / xrat + 1;
+                const auto index = cell_y * (wid + 2) + cell_x;
+                if (this->is_cell_changed[index]) {
+                    continue;
+                }
+
+                this->is_cell_changed[index] = true;
+                this->changed_cells.emplace_back(cell_y, cell_x);
+            }
+        }
+
+        for (const auto &[y, x] : this->changed_cells) {
+            this->update_cell(y, x);
+            this->is_cell_changed[y * (wid + 2) + x] = false;
+        }
+
+        this->changed_cells.clear();
+    }
+
+    for (const auto &[y, x] : this->changed_grids) {
+        this->is_grid_changed[y * this->floor_width + x] = false;
+    }
+
+    this->changed_grids.clear();
+    this->is_valid = true;
+}
+
+int OverviewMap::get_xrat() const
+{
+    return this->xrat;
+}
+
+int OverviewMap::get_yrat() const
+{
+    return this->yrat;
+}
+
+/*!
+ * @brief 縮小後の升目の表示内容を返す
+ * @param y 升目の行 (1～描画行数)
+ * @param x 升目の桁 (1～描画桁数)
+ */
+const OverviewMap::Symbol &OverviewMap::get_cell(int y, int x) const
+{
+    return this->cells[y * (this->wid + 2) + x];
+}
+
+OverviewMap::Symbol &OverviewMap::grid_at(POSITION y, POSITION x)
+{
+    return this->grids[(y + 1) * (this->floor_width + 2) + (x + 1)];
+}
+
+const OverviewMap::Symbol &OverviewMap::grid_at(POSITION y, POSITION x) const
+{
+    return this->grids[(y + 1) * (this->floor_width + 2) + (x + 1)];
+}
+
+OverviewMap::Symbol &OverviewMap::cell_at(int y, int x)
+{
+    return this->cells[y * (this->wid + 2) + x];
+}
+
+/*!
+ * @brief 1グリッドの表示内容を計算し直す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param y グリッドのy座標
+ * @param x グリッドのx座標
+ */
+void OverviewMap::update_grid(PlayerType *player_ptr, POSITION y, POSITION x)
+{
+    TERM_COLOR ta;
+    char tc;
+    match_autopick = -1;
+    autopick_obj = nullptr;
+    feat_priority = -1;
+    map_info(player_ptr, y, x, &ta, &tc, &ta, &tc);
+    auto &grid = this->grid_at(y, x);
+    grid.attr = ta;
+    grid.ch = tc;
+    grid.priority = static_cast<byte>(feat_priority);
+    grid.match_autopick = match_autopick;
+    grid.item_idx = 0;
+    if (autopick_obj == nullptr) {
+        return;
+    }
+
+    const auto &floor = *player_ptr->current_floor_ptr;
+    const auto &o_idx_list = floor.grid_array[y][x].o_idx_list;
+    const auto it = std::find_if(o_idx_list.begin(), o_idx_list.end(), [&floor](const auto o_idx) { return &floor.o_list[o_idx] == autopick_obj; });
+    if (it != o_idx_list.end()) {
+        grid.item_idx = *it;
+    }
+}
+
+/*!
+ * @brief 縮小後の1升目の表示内容を計算し直す
+ * @param y 升目の行
+ * @param x 升目の桁
+ * @details 升目に含まれるグリッドの中で優先度の最も高いものを表示する.
+ * 同じ優先度のグリッドは、周囲8グリッドに同じ表示のものが少ない方を優先する.
+ * 自動拾いに一致したアイテムは登録番号の最も小さいものを優先度最大で表示する.
+ */
+void OverviewMap::update_cell(int y, int x)
+{
+    const auto y_min = (y - 1) * this->yrat;
+    const auto y_max = std::min<POSITION>(y * this->yrat, this->floor_height);
+    const auto x_min = (x - 1) * this->xrat;
+    const auto x_max = std::min<POSITION>(x * this->xrat, this->floor_width);
+    auto &cell = this->cell_at(y, x);
+    cell = Symbol{};
+    if ((y_min >= y_max) || (x_min >= x_max)) {
+        return;
+    }
+
+    const auto height = y_max - y_min;
+    this->priorities.resize(height * (x_max - x_min));
+    for (auto i = x_min; i < x_max; i++) {
+        for (auto j = y_min; j < y_max; j++) {
+            const auto &grid = this->grid_at(j, i);
+            auto &priority = this->priorities[(i - x_min) * height + (j - y_min)];
+            priority = grid.priority;
+            if ((grid.match_autopick != -1) && ((cell.match_autopick == -1) || (cell.match_autopick > grid.match_autopick))) {
+                cell.match_autopick = grid.match_autopick;
+                cell.item_idx = grid.item_idx;
+                priority = 0x7f;
+            }
+        }
+    }
+
+    for (auto j = y_min; j < y_max; j++) {
+        for (auto i = x_min; i < x_max; i++) {
+            const auto &grid = this->grid_at(j, i);
+            auto tp = this->priorities[(i - x_min) * height + (j - y_min)];
+            if (cell.priority == tp) {
+                auto cnt = 0;
+                for (auto t = 0; t < 8; t++) {
+                    const auto &neighbor = this->grid_at(j + ddy_cdd[t], i + ddx_cdd[t]);
+                    if ((grid.ch == neighbor.ch) && (grid.attr == neighbor.attr)) {
+                        cnt++;
+                    }
+                }
+
+                if (cnt <= 4) {
+                    tp++;
+                }
+            }
+
+            if (cell.priority < tp) {
+                cell.ch = grid.ch;
+                cell.attr = grid.attr;
+                cell.priority = tp;
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "system/angband.h"
+#include "term/term-color-types.h"
+#include "util/point-2d.h"
+#include <vector>
+
+class PlayerType;
+
+/*!
+ * @brief 縮小マップの表示内容を保持し、変化したグリッドの分だけ更新するクラス
+ * @details グリッドごとの表示内容と、縮小後の升目ごとの表示内容を保持する.
+ * lite_spot() で再描画されたグリッドを記録しておき、次の更新ではそのグリッドと周囲8グリッドを含む升目だけを計算し直す.
+ * マップ全体の再描画 (print_map()) やフロア・縮小率の変更、自動拾い設定の読み直し、アイテムリストの圧縮があった時は全体を計算し直す.
+ */
+class OverviewMap {
+public:
+    /*!
+     * @brief 1グリッドまたは縮小後の1升目の表示内容
+     */
+    struct Symbol {
+        TERM_COLOR attr = TERM_WHITE;
+        char ch = ' ';
+        byte priority = 0;
+        int match_autopick = -1; //!< 自動拾いの登録番号 (一致しなければ-1)
+        OBJECT_IDX item_idx = 0; //!< 自動拾いに一致したアイテムのID
+    };
+
+    OverviewMap(const OverviewMap &) = delete;
+    OverviewMap(OverviewMap &&) = delete;
+    OverviewMap &operator=(const OverviewMap &) = delete;
+    OverviewMap &operator=(OverviewMap &&) = delete;
+    ~OverviewMap() = default;
+
+    static OverviewMap &get_instance();
+    void invalidate();
+    void mark_changed(POSITION y, POSITION x);
+    void update(PlayerType *player_ptr, int wid, int hgt);
+    int get_xrat() const;
+    int get_yrat() const;
+    const Symbol &get_cell(int y, int x) const;
+
+private:
+    OverviewMap() = default;
+
+    static OverviewMap instance;
+    bool is_valid = false;
+    POSITION floor_height = 0;
+    POSITION floor_width = 0;
+    int wid = 0;
+    int hgt = 0;
+    int yrat = 1;
+    int xrat = 1;
+    std::vector<Symbol> grids; //!< 外周1グリッド分の余白を含むグリッドごとの表示内容
+    std::vector<Symbol> cells; //!< 外枠を含む升目ごとの表示内容
+    std::vector<bool> is_grid_changed;
+    std::vector<Pos2D> changed_grids;
+    std::vector<bool> is_cell_changed;
+    std::vector<Pos2D> changed_cells;
+    std::vector<byte> priorities; //!< 升目の計算に使う作業領域
+
+    Symbol &grid_at(POSITION y, POSITION x);
+    const Symbol &grid_at(POSITION y, POSITION x) const;
+    Symbol &cell_at(int y, int x);
+    void update_grid(PlayerType *player_ptr, POSITION y, POSITION x);
+    void update_cell(int y, int x);
+};
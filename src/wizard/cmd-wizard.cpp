@@ -44,7 +44,7 @@
 /*!
  * @brief デバグコマンド一覧表
  * @details
- * 空き: A,B,E,I,J,k,K,L,M,q,Q,R,T,U,V,W,y,Y
+ * 空き: A,B,E,I,J,k,K,M,q,Q,R,T,U,V,W,y,Y
  */
 constexpr std::array debug_menu_table = {
     std::make_tuple('a', _("全状態回復", "Restore all status")),
@@ -63,6 +63,7 @@ constexpr std::array debug_menu_table = {
     std::make_tuple('I', _("アイテム設定コマンドメニュー", "Modify item configurations")),
     std::make_tuple('j', _("指定ダンジョン階にワープ", "Jump to floor depth of target dungeon")),
     std::make_tuple('k', _("指定ダメージ・半径0の指定属性のボールを自分に放つ", "Fire a zero ball to self")),
+    std::make_tuple('L', _("フロア生成の計測結果を書き出す", "Dump floor generation profile")),
     std::make_tuple('m', _("魔法の地図", "Magic mapping")),
     std::make_tuple('n', _("指定モンスター生成", "Summon target monster")),
     std::make_tuple('N', _("指定モンスターをペットとして生成", "Summon target monster as pet")),
@@ -194,6 +195,9 @@ bool exe_cmd_debug(PlayerType *player_ptr, char cmd)
     case 'k':
         wiz_kill_target(player_ptr, 0, (AttributeType)command_arg, true);
         return true;
+    case 'L':
+        wiz_dump_floor_generation_profile(player_ptr);
+        return true;
     case 'm':
         map_area(player_ptr, DETECT_RAD_ALL * 3);
         return true;
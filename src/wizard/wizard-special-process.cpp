@@ -24,6 +24,7 @@
 #include "flavor/flavor-describer.h"
 #include "flavor/object-flavor-types.h"
 #include "flavor/object-flavor.h"
+#include "floor/floor-generation-profiler.h"
 #include "floor/floor-leaver.h"
 #include "floor/floor-mode-changer.h"
 #include "floor/floor-object.h"
@@ -610,6 +611,41 @@ void wiz_jump_to_dungeon(PlayerType *player_ptr)
     wiz_jump_floor(player_ptr, *dungeon_id, *level);
 }
 
+/*!
+ * @brief フロア生成の計測結果をJSONファイルに書き出す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @details 生成数を指定した場合は全ダンジョンのフロアを一括生成してから書き出し、元の階層へ移動し直す
+ */
+void wiz_dump_floor_generation_profile(PlayerType *player_ptr)
+{
+    const auto floors_per_dungeon = input_integer(_("ダンジョン毎の生成数 (0で書き出しのみ)", "Floors per dungeon (0: dump only)"), 0, 1000);
+    if (!floors_per_dungeon) {
+        return;
+    }
+
+    auto &profiler = FloorGenerationProfiler::get_instance();
+    if (*floors_per_dungeon > 0) {
+        if (!input_check(_("現在のフロアは失われます。よろしいですか？", "The current floor will be lost. Are you sure?"))) {
+            return;
+        }
+
+        const auto &floor = *player_ptr->current_floor_ptr;
+        const auto dungeon_id = floor.dungeon_idx;
+        const auto level = floor.dun_level;
+        profiler.clear();
+        generate_floors_for_profiling(player_ptr, *floors_per_dungeon);
+        wiz_jump_floor(player_ptr, dungeon_id, level);
+    }
+
+    constexpr auto filename = "floor-generation.json";
+    if (!profiler.save(filename)) {
+        msg_format(_("%s に書き出せませんでした。", "Failed to write %s."), filename);
+        return;
+    }
+
+    msg_format(_("フロア生成の計測結果を %s に書き出しました。", "Dumped floor generation profile to %s."), filename);
+}
+
 /*!
  * @brief 全ベースアイテムを鑑定済みにする
  * @param player_ptr プレイヤーへの参照ポインタ
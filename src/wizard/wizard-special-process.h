@@ -9,6 +9,7 @@ void wiz_create_named_art(PlayerType *player_ptr);
 void wiz_change_status(PlayerType *player_ptr);
 void wiz_create_feature(PlayerType *player_ptr);
 void wiz_jump_to_dungeon(PlayerType *player_ptr);
+void wiz_dump_floor_generation_profile(PlayerType *player_ptr);
 void wiz_learn_items_all(PlayerType *player_ptr);
 void wiz_reset_race(PlayerType *player_ptr);
 void wiz_reset_class(PlayerType *player_ptr);
@@ -21,9 +21,21 @@
  * @details
  * This routine should almost never fail, but in case it does,
  * we must be sure to handle "failure" of this routine.
+ * 削除されたアイテムの添字を優先して再利用する. 末尾が空いた分の o_max はアイテムの削除時に縮める.
  */
 OBJECT_IDX o_pop(FloorType *floor_ptr)
 {
+    while (!floor_ptr->o_free_list.empty()) {
+        const auto i = floor_ptr->o_free_list.back();
+        floor_ptr->o_free_list.pop_back();
+        if ((i < 1) || (i >= floor_ptr->o_max) || floor_ptr->o_list[i].is_valid()) {
+            continue;
+        }
+
+        floor_ptr->o_cnt++;
+        return i;
+    }
+
     if (floor_ptr->o_max < w_ptr->max_o_idx) {
         OBJECT_IDX i = floor_ptr->o_max;
         floor_ptr->o_max++;
@@ -27,6 +27,7 @@
 #include "perception/simple-perception.h"
 #include "player-status/player-energy.h"
 #include "player/digestion-processor.h"
+#include "save/save.h"
 #include "store/store-owners.h"
 #include "store/store-util.h"
 #include "store/store.h"
@@ -68,6 +69,7 @@ void WorldTurnProcessor::process_world()
         return;
     }
 
+    (void)finish_background_saves(this->player_ptr, false);
     decide_auto_save();
     auto *floor_ptr = this->player_ptr->current_floor_ptr;
     if (floor_ptr->monster_noise && !ignore_unview) {